@@ -0,0 +1,390 @@
+#ifndef HIRZEL_ALLOCATOR_H
+#define HIRZEL_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*
+ * Allocation hook for the containers. A HirzelAllocator is a context pointer
+ * and callbacks that are given it, along with the size of every block they
+ * resize or free, so allocators that don't track sizes themselves can still
+ * reuse memory. Containers keep a pointer to an allocator, so it must outlive
+ * them, and a NULL allocator uses malloc, realloc and free.
+ *
+ * Two allocators are bundled. HirzelArena hands out memory from large blocks
+ * by bumping an offset and releases it all at once, for containers that live
+ * and die together, such as everything belonging to one request. HirzelPool
+ * recycles blocks of one size through a free list.
+ *
+ *	HirzelArena arena;
+ *	hirzel_arena_init(&arena, 0);
+ *	HirzelAllocator allocator = hirzel_arena_allocator(&arena);
+ *	IntArray array = IntArray_init_allocator(&allocator);
+ *	...
+ *	hirzel_arena_free(&arena);
+ */
+
+#ifndef HIRZEL_ALLOCATOR_ALIGNMENT
+#define HIRZEL_ALLOCATOR_ALIGNMENT 16
+#endif
+
+#define HIRZEL_ARENA_BLOCK_SIZE (1 << 16)
+#define HIRZEL_POOL_CHUNK_LENGTH 256
+
+typedef struct HirzelAllocator
+{
+	void *context;
+	void *(*alloc)(void *context, size_t size);
+	void *(*realloc)(void *context, void *data, size_t old_size, size_t new_size);
+	void (*free)(void *context, void *data, size_t size);
+} HirzelAllocator;
+
+static inline size_t hirzel_align_size(size_t size)
+{
+	return (size + HIRZEL_ALLOCATOR_ALIGNMENT - 1) & ~(size_t)(HIRZEL_ALLOCATOR_ALIGNMENT - 1);
+}
+
+static inline void *hirzel_allocate(const HirzelAllocator *allocator, size_t size)
+{
+	return allocator
+		? allocator->alloc(allocator->context, size)
+		: malloc(size);
+}
+
+static inline void *hirzel_allocate_zeroed(const HirzelAllocator *allocator, size_t count, size_t size)
+{
+	if (!allocator)
+		return calloc(count, size);
+
+	if (size > 0 && count > (size_t)-1 / size)
+		return NULL;
+
+	void *data = allocator->alloc(allocator->context, count * size);
+
+	if (data)
+		memset(data, 0, count * size);
+
+	return data;
+}
+
+static inline void *hirzel_reallocate(const HirzelAllocator *allocator, void *data, size_t old_size, size_t new_size)
+{
+	return allocator
+		? allocator->realloc(allocator->context, data, old_size, new_size)
+		: realloc(data, new_size);
+}
+
+static inline void hirzel_deallocate(const HirzelAllocator *allocator, void *data, size_t size)
+{
+	if (!allocator)
+		free(data);
+	else if (data)
+		allocator->free(allocator->context, data, size);
+}
+
+typedef struct HirzelArenaBlock
+{
+	struct HirzelArenaBlock *next;
+	size_t used;
+	size_t capacity;
+} HirzelArenaBlock;
+
+typedef struct HirzelArena
+{
+	HirzelArenaBlock *blocks;
+	char *last;
+	size_t block_size;
+} HirzelArena;
+
+static inline char *hirzel_arena_block_data(HirzelArenaBlock *block)
+{
+	return (char *)block + hirzel_align_size(sizeof(HirzelArenaBlock));
+}
+
+/* block_size of 0 uses HIRZEL_ARENA_BLOCK_SIZE */
+static inline void hirzel_arena_init(HirzelArena *arena, size_t block_size)
+{
+	assert(arena != NULL);
+
+	*arena = (HirzelArena) { NULL, NULL, block_size ? block_size : HIRZEL_ARENA_BLOCK_SIZE };
+}
+
+static inline void *hirzel_arena_alloc(HirzelArena *arena, size_t size)
+{
+	assert(arena != NULL);
+
+	size = hirzel_align_size(size);
+
+	HirzelArenaBlock *block = arena->blocks;
+
+	if (!block || block->capacity - block->used < size)
+	{
+		size_t capacity = size > arena->block_size
+			? size
+			: arena->block_size;
+
+		block = malloc(hirzel_align_size(sizeof(HirzelArenaBlock)) + capacity);
+
+		if (!block)
+			return NULL;
+
+		block->used = 0;
+		block->capacity = capacity;
+
+		// oversized blocks go behind the current one so its space isn't abandoned
+		if (arena->blocks && capacity > arena->block_size)
+		{
+			block->next = arena->blocks->next;
+			arena->blocks->next = block;
+			block->used = size;
+
+			return hirzel_arena_block_data(block);
+		}
+
+		block->next = arena->blocks;
+		arena->blocks = block;
+	}
+
+	char *data = hirzel_arena_block_data(block) + block->used;
+
+	block->used += size;
+	arena->last = data;
+
+	return data;
+}
+
+/* frees all but the newest block, whose space is reused */
+static inline void hirzel_arena_reset(HirzelArena *arena)
+{
+	assert(arena != NULL);
+
+	if (!arena->blocks)
+		return;
+
+	HirzelArenaBlock *block = arena->blocks->next;
+
+	while (block)
+	{
+		HirzelArenaBlock *next = block->next;
+		free(block);
+		block = next;
+	}
+
+	arena->blocks->next = NULL;
+	arena->blocks->used = 0;
+	arena->last = NULL;
+}
+
+static inline void hirzel_arena_free(HirzelArena *arena)
+{
+	assert(arena != NULL);
+
+	hirzel_arena_reset(arena);
+	free(arena->blocks);
+	arena->blocks = NULL;
+}
+
+static inline void *hirzel_arena_allocator_alloc(void *context, size_t size)
+{
+	return hirzel_arena_alloc(context, size);
+}
+
+/* the newest allocation resizes in place while its block has room, which suits a growing array */
+static inline void *hirzel_arena_allocator_realloc(void *context, void *data, size_t old_size, size_t new_size)
+{
+	HirzelArena *arena = context;
+
+	assert(arena != NULL);
+
+	if (data && data == arena->last)
+	{
+		HirzelArenaBlock *block = arena->blocks;
+		size_t offset = (size_t)(arena->last - hirzel_arena_block_data(block));
+
+		if (hirzel_align_size(new_size) <= block->capacity - offset)
+		{
+			block->used = offset + hirzel_align_size(new_size);
+			return data;
+		}
+	}
+
+	void *new_data = hirzel_arena_alloc(arena, new_size);
+
+	if (new_data && data)
+		memcpy(new_data, data, old_size < new_size ? old_size : new_size);
+
+	return new_data;
+}
+
+/* memory is only given back by reset, except for the newest allocation */
+static inline void hirzel_arena_allocator_free(void *context, void *data, size_t size)
+{
+	HirzelArena *arena = context;
+
+	assert(arena != NULL);
+
+	(void)size;
+
+	if (data && data == arena->last)
+	{
+		arena->blocks->used = (size_t)(arena->last - hirzel_arena_block_data(arena->blocks));
+		arena->last = NULL;
+	}
+}
+
+static inline HirzelAllocator hirzel_arena_allocator(HirzelArena *arena)
+{
+	assert(arena != NULL);
+
+	return (HirzelAllocator) {
+		arena,
+		hirzel_arena_allocator_alloc,
+		hirzel_arena_allocator_realloc,
+		hirzel_arena_allocator_free
+	};
+}
+
+typedef struct HirzelPoolChunk
+{
+	struct HirzelPoolChunk *next;
+} HirzelPoolChunk;
+
+typedef struct HirzelPool
+{
+	HirzelPoolChunk *chunks;
+	void *free_items;
+	char *next_item;
+	char *end_item;
+	size_t item_size;
+	size_t chunk_length;
+} HirzelPool;
+
+/* chunk_length of 0 uses HIRZEL_POOL_CHUNK_LENGTH */
+static inline void hirzel_pool_init(HirzelPool *pool, size_t item_size, size_t chunk_length)
+{
+	assert(pool != NULL);
+
+	// free items hold the link to the next one
+	if (item_size < sizeof(void *))
+		item_size = sizeof(void *);
+
+	*pool = (HirzelPool) {
+		NULL, NULL, NULL, NULL,
+		hirzel_align_size(item_size),
+		chunk_length ? chunk_length : HIRZEL_POOL_CHUNK_LENGTH
+	};
+}
+
+static inline void *hirzel_pool_alloc(HirzelPool *pool)
+{
+	assert(pool != NULL);
+
+	if (pool->free_items)
+	{
+		void *item = pool->free_items;
+
+		pool->free_items = *(void **)item;
+
+		return item;
+	}
+
+	// items are carved from the newest chunk as needed, so a fresh chunk isn't walked
+	if (pool->next_item == pool->end_item)
+	{
+		size_t header_size = hirzel_align_size(sizeof(HirzelPoolChunk));
+		HirzelPoolChunk *chunk = malloc(header_size + pool->item_size * pool->chunk_length);
+
+		if (!chunk)
+			return NULL;
+
+		chunk->next = pool->chunks;
+		pool->chunks = chunk;
+		pool->next_item = (char *)chunk + header_size;
+		pool->end_item = pool->next_item + pool->item_size * pool->chunk_length;
+	}
+
+	void *item = pool->next_item;
+
+	pool->next_item += pool->item_size;
+
+	return item;
+}
+
+static inline void hirzel_pool_dealloc(HirzelPool *pool, void *item)
+{
+	assert(pool != NULL);
+
+	if (!item)
+		return;
+
+	*(void **)item = pool->free_items;
+	pool->free_items = item;
+}
+
+static inline void hirzel_pool_free(HirzelPool *pool)
+{
+	assert(pool != NULL);
+
+	HirzelPoolChunk *chunk = pool->chunks;
+
+	while (chunk)
+	{
+		HirzelPoolChunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+
+	hirzel_pool_init(pool, pool->item_size, pool->chunk_length);
+}
+
+/* requests larger than the item size fail */
+static inline void *hirzel_pool_allocator_alloc(void *context, size_t size)
+{
+	HirzelPool *pool = context;
+
+	assert(pool != NULL);
+
+	return size <= pool->item_size
+		? hirzel_pool_alloc(pool)
+		: NULL;
+}
+
+static inline void *hirzel_pool_allocator_realloc(void *context, void *data, size_t old_size, size_t new_size)
+{
+	HirzelPool *pool = context;
+
+	assert(pool != NULL);
+
+	(void)old_size;
+
+	if (new_size > pool->item_size)
+		return NULL;
+
+	return data
+		? data
+		: hirzel_pool_alloc(pool);
+}
+
+static inline void hirzel_pool_allocator_free(void *context, void *data, size_t size)
+{
+	(void)size;
+
+	hirzel_pool_dealloc(context, data);
+}
+
+static inline HirzelAllocator hirzel_pool_allocator(HirzelPool *pool)
+{
+	assert(pool != NULL);
+
+	return (HirzelAllocator) {
+		pool,
+		hirzel_pool_allocator_alloc,
+		hirzel_pool_allocator_realloc,
+		hirzel_pool_allocator_free
+	};
+}
+
+#endif
@@ -4,8 +4,38 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <assert.h>
 
+#include <hirzel/allocator.h>
+
+/*
+ * Capacity growth policy used whenever an append outgrows the buffer. The new
+ * capacity is HIRZEL_ARRAY_GROWTH(old capacity), raised to the required length
+ * if that is still too small. It is expanded inside HIRZEL_ARRAY_DEFINE, so it
+ * can be overridden for a single instantiation by redefining it beforehand:
+ *
+ *	#undef HIRZEL_ARRAY_GROWTH
+ *	#define HIRZEL_ARRAY_GROWTH(capacity) ((capacity) + (capacity) / 2)
+ *	HIRZEL_ARRAY_DEFINE(int, IntArray)
+ */
+#ifndef HIRZEL_ARRAY_GROWTH
+#define HIRZEL_ARRAY_GROWTH(capacity) ((capacity) * 2)
+#endif
+
+/*
+ * Allocator that NAME##_init gives new arrays, overridable for a single
+ * instantiation the same way. NULL uses malloc. NAME##_init_allocator picks
+ * one per array instead.
+ *
+ *	#undef HIRZEL_ARRAY_ALLOCATOR
+ *	#define HIRZEL_ARRAY_ALLOCATOR (&request_allocator)
+ *	HIRZEL_ARRAY_DEFINE(int, IntArray)
+ */
+#ifndef HIRZEL_ARRAY_ALLOCATOR
+#define HIRZEL_ARRAY_ALLOCATOR NULL
+#endif
+
 #define HIRZEL_ARRAY_STRUCT(TYPE, NAME)\
 
 
@@ -16,9 +46,11 @@ typedef struct __##NAME\
 	TYPE *buffer;\
 	size_t length;\
 	size_t capacity;\
+	const HirzelAllocator *allocator;\
 } NAME;\
 \
 NAME NAME##_init();\
+NAME NAME##_init_allocator(const HirzelAllocator *allocator);\
 void NAME##_free(NAME *array);\
 bool NAME##_reserve(NAME *array, size_t capacity);\
 bool NAME##_resize(NAME *array, size_t length);\
@@ -31,9 +63,15 @@ TYPE *NAME##_pushf_ptr(NAME *array, const TYPE *item);\
 TYPE *NAME##_insert_raw(NAME *array, size_t pos);\
 TYPE *NAME##_insert(NAME *array, size_t pos, TYPE item);\
 TYPE *NAME##_insert_ptr(NAME *array, size_t pos, const TYPE *item);\
+bool NAME##_insert_range(NAME *array, size_t pos, const TYPE *items, size_t count);\
+bool NAME##_append_array(NAME *array, const NAME *other);\
 void NAME##_pop(NAME *array);\
 void NAME##_popf(NAME *array);\
 void NAME##_erase(NAME *array, size_t pos);\
+void NAME##_erase_range(NAME *array, size_t pos, size_t count);\
+void NAME##_swap_remove(NAME *array, size_t pos);\
+size_t NAME##_retain(NAME *array, bool (*predicate)(const TYPE *item, void *context), void *context);\
+size_t NAME##_remove_if(NAME *array, bool (*predicate)(const TYPE *item, void *context), void *context);\
 void NAME##_set(NAME *array, size_t pos, TYPE item);\
 void NAME##_set_ptr(NAME *array, size_t pos, const TYPE *item);\
 void NAME##_swap(NAME *array, size_t a, size_t b);\
@@ -53,13 +91,38 @@ inline static size_t NAME##_capacity(NAME *array) { assert(array != NULL); retur
 \
 NAME NAME##_init()\
 {\
-	return (NAME) { NULL, 0, 0 };\
+	return (NAME) { NULL, 0, 0, HIRZEL_ARRAY_ALLOCATOR };\
+}\
+\
+NAME NAME##_init_allocator(const HirzelAllocator *allocator)\
+{\
+	return (NAME) { NULL, 0, 0, allocator };\
+}\
+\
+static bool NAME##_grow(NAME *array, size_t min_capacity)\
+{\
+	assert(array != NULL);\
+\
+	size_t capacity = HIRZEL_ARRAY_GROWTH(array->capacity);\
+\
+	if (capacity < min_capacity)\
+		capacity = min_capacity;\
+\
+	TYPE *tmp = hirzel_reallocate(array->allocator, array->buffer, array->capacity * sizeof(TYPE), capacity * sizeof(TYPE));\
+\
+	if (!tmp)\
+		return false;\
+\
+	array->buffer = tmp;\
+	array->capacity = capacity;\
+\
+	return true;\
 }\
 \
 void NAME##_free(NAME *array)\
 {\
 	assert(array != NULL);\
-	free(array->buffer);\
+	hirzel_deallocate(array->allocator, array->buffer, array->capacity * sizeof(TYPE));\
 }\
 \
 bool NAME##_reserve(NAME *array, size_t capacity)\
@@ -67,17 +130,19 @@ bool NAME##_reserve(NAME *array, size_t capacity)\
 	assert(array != NULL);\
 	if (capacity == 0)\
 	{\
-		free(array->buffer);\
+		hirzel_deallocate(array->allocator, array->buffer, array->capacity * sizeof(TYPE));\
 		array->buffer = NULL;\
+		array->length = 0;\
 	}\
 	else\
 	{\
-		if (capacity < array->length) array->length = capacity;\
-		TYPE *tmp = realloc(array->buffer, capacity * sizeof(TYPE));\
+		TYPE *tmp = hirzel_reallocate(array->allocator, array->buffer, array->capacity * sizeof(TYPE), capacity * sizeof(TYPE));\
 		if (!tmp)\
 			return false;\
+		if (capacity < array->length) array->length = capacity;\
 		array->buffer = tmp;\
 	}\
+	array->capacity = capacity;\
 	return true;\
 }\
 \
@@ -88,21 +153,10 @@ bool NAME##_resize(NAME *array, size_t length)\
 	if (array->length == length)\
 		return true;\
 \
-	if (length < array->length)\
-	{\
-		array->length = length;\
-	}\
-	else\
-	{\
-		TYPE *tmp = realloc(array->buffer, length * sizeof(TYPE));\
-\
-		if (!tmp)\
-			return false;\
+	if (length > array->capacity && !NAME##_grow(array, length))\
+		return false;\
 \
-		array->buffer = tmp;\
-		array->length = length;\
-		array->capacity = length;\
-	}\
+	array->length = length;\
 \
 	return true;\
 }\
@@ -111,16 +165,8 @@ TYPE *NAME##_push_raw(NAME *array)\
 {\
 	assert(array != NULL);\
 \
-	if (array->length == array->capacity)\
-	{\
-		TYPE *tmp = realloc(array->buffer, (array->length + 1) * sizeof(TYPE));\
-\
-		if (!tmp)\
-			return NULL;\
-\
-		array->buffer = tmp;\
-		array->capacity += 1;\
-	}\
+	if (array->length == array->capacity && !NAME##_grow(array, array->length + 1))\
+		return NULL;\
 \
 	TYPE *back = array->buffer + array->length;\
 	array->length += 1;\
@@ -157,13 +203,7 @@ TYPE *NAME##_pushf_raw(NAME *array)\
 {\
 	assert(array != NULL);\
 \
-	if(!NAME##_push_raw(array))\
-		return NULL;\
-\
-	for (size_t i = array->length - 1; i >= 1; --i)\
-		array->buffer[i] = array->buffer[i - 1];\
-\
-	return array->buffer;\
+	return NAME##_insert_raw(array, 0);\
 }\
 \
 TYPE *NAME##_pushf_ptr(NAME *array, const TYPE *item)\
@@ -199,8 +239,7 @@ TYPE *NAME##_insert_raw(NAME *array, size_t pos)\
 	if (NAME##_push_raw(array) == NULL)\
 		return NULL;\
 \
-	for (size_t i = array->length; i > pos; --i)\
-		array->buffer[i - 1] = array->buffer[i - 2];\
+	memmove(array->buffer + pos + 1, array->buffer + pos, (array->length - 1 - pos) * sizeof(TYPE));\
 \
 	return array->buffer + pos;\
 }\
@@ -227,6 +266,35 @@ TYPE *NAME##_insert_ptr(NAME *array, size_t pos, const TYPE *item)\
 	return ptr;\
 }\
 \
+/* inserts count items at pos with one shift of the items after it. The items\
+ * must not be in the array, as growing it may move them. */\
+bool NAME##_insert_range(NAME *array, size_t pos, const TYPE *items, size_t count)\
+{\
+	assert(array != NULL);\
+	assert(items != NULL || count == 0);\
+	assert(pos <= array->length);\
+\
+	if (count == 0)\
+		return true;\
+\
+	if (count > array->capacity - array->length && !NAME##_grow(array, array->length + count))\
+		return false;\
+\
+	memmove(array->buffer + pos + count, array->buffer + pos, (array->length - pos) * sizeof(TYPE));\
+	memcpy(array->buffer + pos, items, count * sizeof(TYPE));\
+	array->length += count;\
+\
+	return true;\
+}\
+\
+bool NAME##_append_array(NAME *array, const NAME *other)\
+{\
+	assert(other != NULL);\
+	assert(array != other);\
+\
+	return NAME##_insert_range(array, array->length, other->buffer, other->length);\
+}\
+\
 void NAME##_pop(NAME *array)\
 {\
 	assert(array != NULL);\
@@ -241,17 +309,75 @@ void NAME##_popf(NAME *array)\
 		return;\
 \
 	array->length -= 1;\
-\
-	for (size_t i = 0; i < array->length; ++i)\
-		array->buffer[i] = array->buffer[i + 1];\
+	memmove(array->buffer, array->buffer + 1, array->length * sizeof(TYPE));\
 }\
 \
 void NAME##_erase(NAME *array, size_t pos)\
 {\
 	assert(array != NULL);\
 	assert(pos < array->length);\
-	for (size_t i = pos + 1; i < array->length; ++i) array->buffer[i - 1] = array->buffer[i];\
+	memmove(array->buffer + pos, array->buffer + pos + 1, (array->length - pos - 1) * sizeof(TYPE));\
+	array->length -= 1;\
+}\
+\
+void NAME##_erase_range(NAME *array, size_t pos, size_t count)\
+{\
+	assert(array != NULL);\
+	assert(pos <= array->length && count <= array->length - pos);\
+\
+	if (count == 0)\
+		return;\
+\
+	memmove(array->buffer + pos, array->buffer + pos + count, (array->length - pos - count) * sizeof(TYPE));\
+	array->length -= count;\
+}\
+\
+/* erases in constant time by moving the back item into pos, so the order isn't kept */\
+void NAME##_swap_remove(NAME *array, size_t pos)\
+{\
+	assert(array != NULL);\
+	assert(pos < array->length);\
+\
 	array->length -= 1;\
+	array->buffer[pos] = array->buffer[array->length];\
+}\
+\
+/* one pass stable compaction, keeping the items whose predicate result equals keep */\
+static size_t NAME##_compact_where(NAME *array, bool (*predicate)(const TYPE *item, void *context), void *context, bool keep)\
+{\
+	assert(array != NULL);\
+	assert(predicate != NULL);\
+\
+	size_t kept = 0;\
+\
+	for (size_t i = 0; i < array->length; ++i)\
+	{\
+		if (predicate(array->buffer + i, context) != keep)\
+			continue;\
+\
+		if (kept != i)\
+			array->buffer[kept] = array->buffer[i];\
+\
+		kept += 1;\
+	}\
+\
+	size_t removed = array->length - kept;\
+\
+	array->length = kept;\
+\
+	return removed;\
+}\
+\
+/* keeps only the items the predicate accepts, in order and in one pass, and returns how many were removed */\
+size_t NAME##_retain(NAME *array, bool (*predicate)(const TYPE *item, void *context), void *context)\
+{\
+	return NAME##_compact_where(array, predicate, context, true);\
+}\
+\
+/* removes the items the predicate accepts, keeping the order of the rest, and returns how many were removed */\
+size_t NAME##_remove_if(NAME *array, bool (*predicate)(const TYPE *item, void *context), void *context)\
+{\
+	return NAME##_compact_where(array, predicate, context, false);\
 }\
 \
 void NAME##_set_ptr(NAME *array, size_t pos, const TYPE *item)\
@@ -0,0 +1,234 @@
+#ifndef HIRZEL_ARRAY_IO_H
+#define HIRZEL_ARRAY_IO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <hirzel/array.h>
+#include <hirzel/file.h>
+#include <hirzel/hash.h>
+
+/*
+ * Binary files of a HIRZEL_ARRAY whose TYPE can be copied byte for byte. A file
+ * is a small header, recording the item size, length and a checksum of the
+ * items, followed by the items exactly as they sit in the buffer.
+ *
+ * NAME##_write and NAME##_read stream the buffer through an open FILE in large
+ * chunks, so they work on pipes as well as files. NAME##_map maps a file and
+ * points straight at its items instead of copying them, for consumers that
+ * only read them. NAME##_load reads a file straight into the array's buffer
+ * with several reads in flight, through io_uring where HIRZEL_FILE_IO_URING is
+ * defined. Files are in the byte order and struct layout of the machine
+ * that wrote them.
+ *
+ *	HIRZEL_ARRAY_DECLARE(Sample, SampleArray)
+ *	HIRZEL_ARRAY_DEFINE(Sample, SampleArray)
+ *	HIRZEL_ARRAY_IO_DECLARE(Sample, SampleArray)
+ *	HIRZEL_ARRAY_IO_DEFINE(Sample, SampleArray)
+ */
+
+#define HIRZEL_ARRAY_IO_MAGIC "HZARRAY"
+#define HIRZEL_ARRAY_IO_VERSION 1
+#define HIRZEL_ARRAY_IO_CHUNK_SIZE (1 << 20)
+#define HIRZEL_ARRAY_IO_CHECKSUM_SEED 0x9e3779b97f4a7c15ull
+
+// items per chunk, at least one for items larger than the chunk size
+#define HIRZEL_ARRAY_IO_CHUNK_LENGTH(item_size)\
+	(HIRZEL_ARRAY_IO_CHUNK_SIZE / (item_size) ? HIRZEL_ARRAY_IO_CHUNK_SIZE / (item_size) : 1)
+
+typedef struct HirzelArrayHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t item_size;
+	uint64_t length;
+	uint64_t checksum;
+} HirzelArrayHeader;
+
+static inline bool hirzel_array_header_is_valid(const HirzelArrayHeader *header, size_t item_size)
+{
+	assert(header != NULL);
+
+	return !memcmp(header->magic, HIRZEL_ARRAY_IO_MAGIC, sizeof(header->magic))
+		&& header->version == HIRZEL_ARRAY_IO_VERSION
+		&& header->item_size == item_size;
+}
+
+#define HIRZEL_ARRAY_IO_DECLARE(TYPE, NAME)\
+\
+typedef struct __##NAME##Mapping\
+{\
+	HirzelFileMap file;\
+	const TYPE *buffer;\
+	size_t length;\
+} NAME##Mapping;\
+\
+bool NAME##_write(const NAME *array, FILE *file);\
+bool NAME##_read(NAME *array, FILE *file);\
+bool NAME##_load(NAME *array, const char *path);\
+bool NAME##_map(NAME##Mapping *mapping, const char *path, bool is_checksum_verified);\
+void NAME##_unmap(NAME##Mapping *mapping);
+
+
+#define HIRZEL_ARRAY_IO_DEFINE(TYPE, NAME)\
+\
+static uint64_t NAME##_checksum(const TYPE *buffer, size_t length)\
+{\
+	return hirzel_hash_bytes(buffer, length * sizeof(TYPE), HIRZEL_ARRAY_IO_CHECKSUM_SEED);\
+}\
+\
+bool NAME##_write(const NAME *array, FILE *file)\
+{\
+	assert(array != NULL);\
+	assert(file != NULL);\
+\
+	HirzelArrayHeader header = {\
+		HIRZEL_ARRAY_IO_MAGIC, HIRZEL_ARRAY_IO_VERSION, sizeof(TYPE),\
+		array->length, NAME##_checksum(array->buffer, array->length)\
+	};\
+\
+	if (fwrite(&header, sizeof(header), 1, file) != 1)\
+		return false;\
+\
+	const size_t chunk_length = HIRZEL_ARRAY_IO_CHUNK_LENGTH(sizeof(TYPE));\
+\
+	for (size_t i = 0; i < array->length; i += chunk_length)\
+	{\
+		size_t length = array->length - i < chunk_length\
+			? array->length - i\
+			: chunk_length;\
+\
+		if (fwrite(array->buffer + i, sizeof(TYPE), length, file) != length)\
+			return false;\
+	}\
+\
+	return true;\
+}\
+\
+/* replaces the items of array with those read from file, leaving it empty on failure */\
+bool NAME##_read(NAME *array, FILE *file)\
+{\
+	assert(array != NULL);\
+	assert(file != NULL);\
+\
+	HirzelArrayHeader header;\
+\
+	array->length = 0;\
+\
+	if (fread(&header, sizeof(header), 1, file) != 1 || !hirzel_array_header_is_valid(&header, sizeof(TYPE)))\
+		return false;\
+\
+	if (header.length > (size_t)-1 / sizeof(TYPE))\
+		return false;\
+\
+	/* the buffer grows as items arrive, so a corrupt length fails at the end of\
+	 * the file instead of reserving memory up front */\
+	const size_t chunk_length = HIRZEL_ARRAY_IO_CHUNK_LENGTH(sizeof(TYPE));\
+	size_t length = (size_t)header.length;\
+\
+	while (array->length < length)\
+	{\
+		size_t offset = array->length;\
+		size_t read_length = length - offset < chunk_length\
+			? length - offset\
+			: chunk_length;\
+\
+		if (!NAME##_resize(array, offset + read_length)\
+			|| fread(array->buffer + offset, sizeof(TYPE), read_length, file) != read_length)\
+		{\
+			array->length = 0;\
+			return false;\
+		}\
+	}\
+\
+	if (NAME##_checksum(array->buffer, array->length) != header.checksum)\
+	{\
+		array->length = 0;\
+		return false;\
+	}\
+\
+	return true;\
+}\
+\
+/* like read, but from a path, knowing the file's size up front */\
+bool NAME##_load(NAME *array, const char *path)\
+{\
+	assert(array != NULL);\
+	assert(path != NULL);\
+\
+	HirzelFileQueue queue;\
+	HirzelArrayHeader header;\
+\
+	array->length = 0;\
+\
+	if (!hirzel_file_queue_open(&queue, path, 0))\
+		return false;\
+\
+	bool is_loaded = hirzel_file_queue_read(&queue, &header, sizeof(header), 0, 0)\
+		&& hirzel_array_header_is_valid(&header, sizeof(TYPE))\
+		&& header.length == (queue.size - sizeof(header)) / sizeof(TYPE)\
+		&& (queue.size - sizeof(header)) % sizeof(TYPE) == 0\
+		&& NAME##_resize(array, (size_t)header.length)\
+		&& hirzel_file_queue_read(&queue, array->buffer, array->length * sizeof(TYPE), sizeof(header), 0)\
+		&& NAME##_checksum(array->buffer, array->length) == header.checksum;\
+\
+	hirzel_file_queue_close(&queue);\
+\
+	if (!is_loaded)\
+		array->length = 0;\
+\
+	return is_loaded;\
+}\
+\
+/* the items stay valid until unmapped and must not be written to */\
+bool NAME##_map(NAME##Mapping *mapping, const char *path, bool is_checksum_verified)\
+{\
+	assert(mapping != NULL);\
+	assert(path != NULL);\
+\
+	HirzelFileMap file;\
+\
+	if (!hirzel_file_map(&file, path))\
+		return false;\
+\
+	HirzelArrayHeader header;\
+	bool is_valid = file.size >= sizeof(header);\
+\
+	if (is_valid)\
+	{\
+		memcpy(&header, file.data, sizeof(header));\
+\
+		is_valid = hirzel_array_header_is_valid(&header, sizeof(TYPE))\
+			&& header.length == (file.size - sizeof(header)) / sizeof(TYPE)\
+			&& (file.size - sizeof(header)) % sizeof(TYPE) == 0;\
+	}\
+\
+	const TYPE *buffer = (const TYPE *)(file.data + sizeof(header));\
+\
+	if (is_valid && is_checksum_verified)\
+		is_valid = NAME##_checksum(buffer, (size_t)header.length) == header.checksum;\
+\
+	if (!is_valid)\
+	{\
+		hirzel_file_unmap(&file);\
+		return false;\
+	}\
+\
+	mapping->file = file;\
+	mapping->buffer = buffer;\
+	mapping->length = (size_t)header.length;\
+\
+	return true;\
+}\
+\
+void NAME##_unmap(NAME##Mapping *mapping)\
+{\
+	assert(mapping != NULL);\
+\
+	hirzel_file_unmap(&mapping->file);\
+	mapping->buffer = NULL;\
+	mapping->length = 0;\
+}
+
+#endif
@@ -0,0 +1,346 @@
+#ifndef HIRZEL_ARRAY_SORT_H
+#define HIRZEL_ARRAY_SORT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <hirzel/array.h>
+
+/*
+ * Sorting and binary search for a HIRZEL_ARRAY. LESS is a macro or function
+ * taking two const TYPE pointers and returning whether the first item orders
+ * before the second. It is expanded inside every comparison, so it inlines
+ * where qsort would call through a pointer. HIRZEL_SORT_LESS suits any TYPE
+ * that works with <.
+ *
+ * NAME##_sort is an introsort: quicksort on a median of three pivot, switching
+ * to heapsort if it recurses too deep and to insertion sort for short runs. It
+ * isn't stable. NAME##_stable_sort is a merge sort, which needs a buffer as
+ * long as the array from the array's allocator. The bounds take an array
+ * sorted by the same LESS.
+ *
+ *	#define SAMPLE_LESS(a, b) ((a)->time < (b)->time)
+ *	HIRZEL_ARRAY_DECLARE(Sample, SampleArray)
+ *	HIRZEL_ARRAY_DEFINE(Sample, SampleArray)
+ *	HIRZEL_ARRAY_SORT_DECLARE(Sample, SampleArray)
+ *	HIRZEL_ARRAY_SORT_DEFINE(Sample, SampleArray, SAMPLE_LESS)
+ */
+
+#define HIRZEL_SORT_LESS(a, b) (*(a) < *(b))
+
+#ifndef HIRZEL_SORT_INSERTION_LENGTH
+#define HIRZEL_SORT_INSERTION_LENGTH 16
+#endif
+
+#ifndef HIRZEL_SORT_NINTHER_LENGTH
+#define HIRZEL_SORT_NINTHER_LENGTH 128
+#endif
+
+#ifndef HIRZEL_SORT_RUN_LENGTH
+#define HIRZEL_SORT_RUN_LENGTH 32
+#endif
+
+#define HIRZEL_ARRAY_SORT_DECLARE(TYPE, NAME)\
+\
+void NAME##_sort(NAME *array);\
+bool NAME##_stable_sort(NAME *array);\
+size_t NAME##_lower_bound(const NAME *array, const TYPE *item);\
+size_t NAME##_upper_bound(const NAME *array, const TYPE *item);
+
+
+#define HIRZEL_ARRAY_SORT_DEFINE(TYPE, NAME, LESS)\
+\
+static void NAME##_sort_swap(TYPE *a, TYPE *b)\
+{\
+	TYPE tmp = *a;\
+	*a = *b;\
+	*b = tmp;\
+}\
+\
+/* stable, as an item only moves past those strictly greater */\
+static void NAME##_insertion_sort(TYPE *items, size_t length)\
+{\
+	for (size_t i = 1; i < length; ++i)\
+	{\
+		TYPE item = items[i];\
+		size_t j = i;\
+\
+		while (j > 0 && LESS(&item, items + j - 1))\
+		{\
+			items[j] = items[j - 1];\
+			j -= 1;\
+		}\
+\
+		items[j] = item;\
+	}\
+}\
+\
+/* orders the items at a, b and c */\
+static void NAME##_sort3(TYPE *items, size_t a, size_t b, size_t c)\
+{\
+	if (LESS(items + b, items + a))\
+		NAME##_sort_swap(items + b, items + a);\
+\
+	if (LESS(items + c, items + b))\
+	{\
+		NAME##_sort_swap(items + c, items + b);\
+\
+		if (LESS(items + b, items + a))\
+			NAME##_sort_swap(items + b, items + a);\
+	}\
+}\
+\
+static void NAME##_sift_down(TYPE *items, size_t root, size_t length)\
+{\
+	while (true)\
+	{\
+		size_t child = root * 2 + 1;\
+\
+		if (child >= length)\
+			return;\
+\
+		if (child + 1 < length && LESS(items + child, items + child + 1))\
+			child += 1;\
+\
+		if (!LESS(items + root, items + child))\
+			return;\
+\
+		NAME##_sort_swap(items + root, items + child);\
+		root = child;\
+	}\
+}\
+\
+static void NAME##_heap_sort(TYPE *items, size_t length)\
+{\
+	for (size_t i = length / 2; i > 0; --i)\
+		NAME##_sift_down(items, i - 1, length);\
+\
+	for (size_t i = length - 1; i > 0; --i)\
+	{\
+		NAME##_sort_swap(items, items + i);\
+		NAME##_sift_down(items, 0, i);\
+	}\
+}\
+\
+static void NAME##_introsort(TYPE *items, size_t length, size_t depth)\
+{\
+	while (length > HIRZEL_SORT_INSERTION_LENGTH)\
+	{\
+		/* quicksort is degrading on this input, so the rest gets heapsort's n log n */\
+		if (depth == 0)\
+		{\
+			NAME##_heap_sort(items, length);\
+			return;\
+		}\
+\
+		depth -= 1;\
+\
+		size_t last = length - 1;\
+		size_t middle = length / 2;\
+\
+		/* longer ranges take the median of the medians of three samples\
+		 * spread over each end and the middle, which patterns like organ\
+		 * pipes can't push to the edge as easily */\
+		if (length > HIRZEL_SORT_NINTHER_LENGTH)\
+		{\
+			size_t step = length / 8;\
+\
+			NAME##_sort3(items, 0, step, step * 2);\
+			NAME##_sort3(items, middle - step, middle, middle + step);\
+			NAME##_sort3(items, last - step * 2, last - step, last);\
+			NAME##_sort3(items, step, middle, last - step);\
+		}\
+\
+		/* ordering the first, middle and last items leaves the outer two as\
+		 * sentinels, so neither scan below needs a bounds check */\
+		NAME##_sort3(items, 0, middle, last);\
+\
+		TYPE pivot = items[middle];\
+		size_t i = 0;\
+		size_t j = last;\
+\
+		while (true)\
+		{\
+			do\
+				i += 1;\
+			while (LESS(items + i, &pivot));\
+\
+			do\
+				j -= 1;\
+			while (LESS(&pivot, items + j));\
+\
+			if (i >= j)\
+				break;\
+\
+			NAME##_sort_swap(items + i, items + j);\
+		}\
+\
+		/* items up to j are at most the pivot and the rest at least it.\
+		 * Recursing into the shorter side bounds the stack to log n. */\
+		size_t left_length = j + 1;\
+		size_t right_length = length - left_length;\
+\
+		if (left_length < right_length)\
+		{\
+			NAME##_introsort(items, left_length, depth);\
+			items += left_length;\
+			length = right_length;\
+		}\
+		else\
+		{\
+			NAME##_introsort(items + left_length, right_length, depth);\
+			length = left_length;\
+		}\
+	}\
+\
+	NAME##_insertion_sort(items, length);\
+}\
+\
+void NAME##_sort(NAME *array)\
+{\
+	assert(array != NULL);\
+\
+	size_t depth = 0;\
+\
+	for (size_t length = array->length; length > 1; length /= 2)\
+		depth += 2;\
+\
+	NAME##_introsort(array->buffer, array->length, depth);\
+}\
+\
+/* merges two sorted runs into out, taking from the left run on ties to stay stable */\
+static void NAME##_merge(const TYPE *left, size_t left_length, const TYPE *right, size_t right_length, TYPE *out)\
+{\
+	size_t i = 0;\
+	size_t j = 0;\
+\
+	while (i < left_length && j < right_length)\
+	{\
+		if (LESS(right + j, left + i))\
+			*out++ = right[j++];\
+		else\
+			*out++ = left[i++];\
+	}\
+\
+	memcpy(out, left + i, (left_length - i) * sizeof(TYPE));\
+	memcpy(out + (left_length - i), right + j, (right_length - j) * sizeof(TYPE));\
+}\
+\
+/* returns false, leaving the array as it was, if the merge buffer can't be allocated */\
+bool NAME##_stable_sort(NAME *array)\
+{\
+	assert(array != NULL);\
+\
+	size_t length = array->length;\
+\
+	if (length <= HIRZEL_SORT_RUN_LENGTH)\
+	{\
+		NAME##_insertion_sort(array->buffer, length);\
+		return true;\
+	}\
+\
+	TYPE *buffer = hirzel_allocate(array->allocator, length * sizeof(TYPE));\
+\
+	if (!buffer)\
+		return false;\
+\
+	for (size_t i = 0; i < length; i += HIRZEL_SORT_RUN_LENGTH)\
+	{\
+		size_t run_length = length - i < HIRZEL_SORT_RUN_LENGTH\
+			? length - i\
+			: HIRZEL_SORT_RUN_LENGTH;\
+\
+		NAME##_insertion_sort(array->buffer + i, run_length);\
+	}\
+\
+	/* runs double in length each pass, merging back and forth between the two buffers */\
+	TYPE *from = array->buffer;\
+	TYPE *to = buffer;\
+\
+	for (size_t width = HIRZEL_SORT_RUN_LENGTH; width < length; width *= 2)\
+	{\
+		for (size_t start = 0; start < length; start += width * 2)\
+		{\
+			size_t middle = length - start > width\
+				? start + width\
+				: length;\
+			size_t end = length - middle > width\
+				? middle + width\
+				: length;\
+\
+			/* runs already in order are copied rather than merged */\
+			if (middle == end || !LESS(from + middle, from + middle - 1))\
+				memcpy(to + start, from + start, (end - start) * sizeof(TYPE));\
+			else\
+				NAME##_merge(from + start, middle - start, from + middle, end - middle, to + start);\
+		}\
+\
+		TYPE *tmp = from;\
+		from = to;\
+		to = tmp;\
+	}\
+\
+	if (from != array->buffer)\
+		memcpy(array->buffer, from, length * sizeof(TYPE));\
+\
+	hirzel_deallocate(array->allocator, buffer, length * sizeof(TYPE));\
+\
+	return true;\
+}\
+\
+/* index of the first item not less than item, or the length if there is none */\
+size_t NAME##_lower_bound(const NAME *array, const TYPE *item)\
+{\
+	assert(array != NULL);\
+	assert(item != NULL);\
+\
+	size_t begin = 0;\
+	size_t length = array->length;\
+\
+	while (length > 0)\
+	{\
+		size_t half = length / 2;\
+\
+		if (LESS(array->buffer + begin + half, item))\
+		{\
+			begin += half + 1;\
+			length -= half + 1;\
+		}\
+		else\
+		{\
+			length = half;\
+		}\
+	}\
+\
+	return begin;\
+}\
+\
+/* index of the first item greater than item, or the length if there is none */\
+size_t NAME##_upper_bound(const NAME *array, const TYPE *item)\
+{\
+	assert(array != NULL);\
+	assert(item != NULL);\
+\
+	size_t begin = 0;\
+	size_t length = array->length;\
+\
+	while (length > 0)\
+	{\
+		size_t half = length / 2;\
+\
+		if (!LESS(item, array->buffer + begin + half))\
+		{\
+			begin += half + 1;\
+			length -= half + 1;\
+		}\
+		else\
+		{\
+			length = half;\
+		}\
+	}\
+\
+	return begin;\
+}
+
+#endif
@@ -0,0 +1,294 @@
+#ifndef HIRZEL_CONCURRENT_TABLE_H
+#define HIRZEL_CONCURRENT_TABLE_H
+
+#include <hirzel/table.h>
+#include <hirzel/thread.h>
+
+/*
+ * Thread safe string keyed hash table made of independently locked shards,
+ * each a power of two HIRZEL_TABLE behind a reader-writer lock. The high bits
+ * of a key's hash pick its shard and the low bits its slot within it, so a key
+ * is hashed once per call. Lookups on different shards never contend and
+ * lookups on the same shard only wait for writers.
+ *
+ * Values are copied out under the lock, as pointers into a shard are not safe
+ * to hold once it is unlocked.
+ *
+ *	HIRZEL_CONCURRENT_TABLE_DECLARE(int, SharedIntTable)
+ *	HIRZEL_CONCURRENT_TABLE_DEFINE(int, SharedIntTable)
+ */
+
+#define HIRZEL_CONCURRENT_TABLE_DEFAULT_SHARDS 64
+#define HIRZEL_CONCURRENT_TABLE_MAX_SHARDS 65536
+
+#define HIRZEL_CONCURRENT_TABLE_DECLARE(TYPE, NAME)\
+\
+HIRZEL_TABLE_DECLARE(TYPE, NAME##Shard)\
+\
+typedef struct __##NAME##ShardLock\
+{\
+	HirzelRwLock lock;\
+	NAME##Shard table;\
+	/* keeps the lock of one shard off the cache line of its neighbours */\
+	char padding[HIRZEL_CACHE_LINE];\
+} NAME##ShardLock;\
+\
+typedef struct __##NAME\
+{\
+	NAME##ShardLock *shards;\
+	size_t shard_count;\
+	unsigned shard_bits;\
+} NAME;\
+\
+bool NAME##_init(NAME *table, size_t shard_count);\
+void NAME##_free(NAME *table);\
+bool NAME##_reserve(NAME *table, size_t min_count);\
+bool NAME##_set(NAME *table, const char *key, TYPE value);\
+bool NAME##_set_n(NAME *table, const char *key, size_t length, TYPE value);\
+void NAME##_erase(NAME *table, const char *key);\
+void NAME##_erase_n(NAME *table, const char *key, size_t length);\
+void NAME##_clear(NAME *table);\
+bool NAME##_get(NAME *table, TYPE *out, const char *key);\
+bool NAME##_get_n(NAME *table, TYPE *out, const char *key, size_t length);\
+bool NAME##_contains(NAME *table, const char *key);\
+bool NAME##_contains_n(NAME *table, const char *key, size_t length);\
+size_t NAME##_count(NAME *table);
+
+
+#define HIRZEL_CONCURRENT_TABLE_DEFINE(TYPE, NAME)\
+\
+HIRZEL_TABLE_DEFINE_POW2(TYPE, NAME##Shard)\
+\
+/* picks the shard from the top bits of a hash, leaving the low bits to the slot */\
+static NAME##ShardLock *NAME##_get_shard(const NAME *table, size_t hash)\
+{\
+	if (table->shard_bits == 0)\
+		return table->shards;\
+\
+	size_t index = hash >> (sizeof(size_t) * 8 - table->shard_bits);\
+\
+	return table->shards + index;\
+}\
+\
+static size_t NAME##_hash(const NAME *table, const char *key, size_t length)\
+{\
+	return NAME##Shard_hash(&table->shards->table, key, length);\
+}\
+\
+bool NAME##_init(NAME *table, size_t shard_count)\
+{\
+	assert(table != NULL);\
+	assert(shard_count <= HIRZEL_CONCURRENT_TABLE_MAX_SHARDS);\
+\
+	if (shard_count == 0)\
+		shard_count = HIRZEL_CONCURRENT_TABLE_DEFAULT_SHARDS;\
+\
+	unsigned shard_bits = 0;\
+\
+	while (((size_t)1 << shard_bits) < shard_count)\
+		shard_bits += 1;\
+\
+	shard_count = (size_t)1 << shard_bits;\
+\
+	NAME##ShardLock *shards = calloc(shard_count, sizeof(NAME##ShardLock));\
+\
+	if (!shards)\
+		return false;\
+\
+	for (size_t i = 0; i < shard_count; ++i)\
+	{\
+		if (NAME##Shard_init(&shards[i].table))\
+		{\
+			if (hirzel_rwlock_init(&shards[i].lock))\
+				continue;\
+\
+			NAME##Shard_free(&shards[i].table);\
+		}\
+\
+		while (i-- > 0)\
+		{\
+			hirzel_rwlock_destroy(&shards[i].lock);\
+			NAME##Shard_free(&shards[i].table);\
+		}\
+\
+		free(shards);\
+\
+		return false;\
+	}\
+\
+	*table = (NAME) { shards, shard_count, shard_bits };\
+\
+	return true;\
+}\
+\
+void NAME##_free(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	for (size_t i = 0; i < table->shard_count; ++i)\
+	{\
+		hirzel_rwlock_destroy(&table->shards[i].lock);\
+		NAME##Shard_free(&table->shards[i].table);\
+	}\
+\
+	free(table->shards);\
+}\
+\
+bool NAME##_reserve(NAME *table, size_t min_count)\
+{\
+	assert(table != NULL);\
+\
+	/* keys spread evenly, so a little slack per shard covers the variance */\
+	size_t shard_min_count = min_count / table->shard_count + min_count / table->shard_count / 8 + 1;\
+	bool is_reserved = true;\
+\
+	for (size_t i = 0; i < table->shard_count; ++i)\
+	{\
+		NAME##ShardLock *shard = table->shards + i;\
+\
+		hirzel_rwlock_write(&shard->lock);\
+\
+		if (NAME##Shard_get_min_size_index(shard_min_count) > shard->table.size_index)\
+			is_reserved = NAME##Shard_reserve(&shard->table, shard_min_count) && is_reserved;\
+\
+		hirzel_rwlock_write_unlock(&shard->lock);\
+	}\
+\
+	return is_reserved;\
+}\
+\
+bool NAME##_set_n(NAME *table, const char *key, size_t length, TYPE value)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	size_t hash = NAME##_hash(table, key, length);\
+	NAME##ShardLock *shard = NAME##_get_shard(table, hash);\
+\
+	hirzel_rwlock_write(&shard->lock);\
+\
+	NAME##ShardNode *node = NAME##Shard_insert_node(&shard->table, key, length, hash);\
+\
+	if (node)\
+		node->value = value;\
+\
+	hirzel_rwlock_write_unlock(&shard->lock);\
+\
+	return node != NULL;\
+}\
+\
+bool NAME##_set(NAME *table, const char *key, TYPE value)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_set_n(table, key, strlen(key), value);\
+}\
+\
+void NAME##_erase_n(NAME *table, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	size_t hash = NAME##_hash(table, key, length);\
+	NAME##ShardLock *shard = NAME##_get_shard(table, hash);\
+\
+	hirzel_rwlock_write(&shard->lock);\
+\
+	NAME##ShardNode *node = NAME##Shard_find_node_hashed(&shard->table, key, length, hash);\
+\
+	if (node->key)\
+		NAME##Shard_delete_node(&shard->table, node);\
+\
+	hirzel_rwlock_write_unlock(&shard->lock);\
+}\
+\
+void NAME##_erase(NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	NAME##_erase_n(table, key, strlen(key));\
+}\
+\
+void NAME##_clear(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	for (size_t i = 0; i < table->shard_count; ++i)\
+	{\
+		hirzel_rwlock_write(&table->shards[i].lock);\
+		NAME##Shard_clear(&table->shards[i].table);\
+		hirzel_rwlock_write_unlock(&table->shards[i].lock);\
+	}\
+}\
+\
+bool NAME##_get_n(NAME *table, TYPE *out, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(out != NULL);\
+	assert(key != NULL);\
+\
+	size_t hash = NAME##_hash(table, key, length);\
+	NAME##ShardLock *shard = NAME##_get_shard(table, hash);\
+\
+	hirzel_rwlock_read(&shard->lock);\
+\
+	NAME##ShardNode *node = NAME##Shard_find_node_hashed(&shard->table, key, length, hash);\
+	bool is_found = node->key != NULL;\
+\
+	if (is_found)\
+		*out = node->value;\
+\
+	hirzel_rwlock_read_unlock(&shard->lock);\
+\
+	return is_found;\
+}\
+\
+bool NAME##_get(NAME *table, TYPE *out, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_get_n(table, out, key, strlen(key));\
+}\
+\
+bool NAME##_contains_n(NAME *table, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	size_t hash = NAME##_hash(table, key, length);\
+	NAME##ShardLock *shard = NAME##_get_shard(table, hash);\
+\
+	hirzel_rwlock_read(&shard->lock);\
+\
+	bool contains_key = NAME##Shard_find_node_hashed(&shard->table, key, length, hash)->key != NULL;\
+\
+	hirzel_rwlock_read_unlock(&shard->lock);\
+\
+	return contains_key;\
+}\
+\
+bool NAME##_contains(NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_contains_n(table, key, strlen(key));\
+}\
+\
+/* each shard is counted under its own lock, so concurrent writes may be half seen */\
+size_t NAME##_count(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	size_t count = 0;\
+\
+	for (size_t i = 0; i < table->shard_count; ++i)\
+	{\
+		hirzel_rwlock_read(&table->shards[i].lock);\
+		count += table->shards[i].table.count;\
+		hirzel_rwlock_read_unlock(&table->shards[i].lock);\
+	}\
+\
+	return count;\
+}
+
+#endif
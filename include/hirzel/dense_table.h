@@ -0,0 +1,481 @@
+#ifndef HIRZEL_DENSE_TABLE_H
+#define HIRZEL_DENSE_TABLE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include <hirzel/hash.h>
+
+/*
+ * String keyed hash table with the same interface as HIRZEL_TABLE, keeping its
+ * entries contiguous in insertion order. The hash slots hold only the 32 bit
+ * index of an entry, so the probed array stays small, and iterating visits live
+ * entries in the order they were first set without scanning empty slots.
+ *
+ * Erasing a key leaves a hole in the entries that its slot still points to,
+ * which probing steps over. Holes are closed up whenever the slots are rebuilt,
+ * which an insert does in place once holes take up the room it needs.
+ *
+ * Pointers returned by get_ptr are invalidated by any set of a new key, as the
+ * entries may move.
+ *
+ *	HIRZEL_DENSE_TABLE_DECLARE(int, OrderedIntTable)
+ *	HIRZEL_DENSE_TABLE_DEFINE(int, OrderedIntTable)
+ */
+
+#define HIRZEL_DENSE_TABLE_MIN_CAPACITY 16
+
+#define HIRZEL_DENSE_TABLE_DECLARE(TYPE, NAME)\
+\
+typedef struct __##NAME##Entry\
+{\
+	char *key;\
+	size_t key_length;\
+	size_t hash;\
+	TYPE value;\
+} NAME##Entry;\
+\
+typedef struct __##NAME\
+{\
+	NAME##Entry *entries;\
+	uint32_t *slots;\
+	size_t(*hash_function)(const char*, size_t);\
+	size_t capacity;\
+	size_t count;\
+	size_t entry_count;\
+	size_t entry_capacity;\
+} NAME;\
+\
+typedef struct __##NAME##Iter\
+{\
+	size_t index;\
+} NAME##Iter;\
+\
+bool NAME##_init(NAME *table);\
+void NAME##_free(NAME *table);\
+bool NAME##_reserve(NAME *table, size_t min_count);\
+bool NAME##_shrink(NAME *table);\
+bool NAME##_set(NAME *table, const char* key, TYPE value);\
+bool NAME##_set_ptr(NAME *table, const char* key, const TYPE *value);\
+bool NAME##_set_n(NAME *table, const char* key, size_t length, TYPE value);\
+bool NAME##_set_ptr_n(NAME *table, const char* key, size_t length, const TYPE *value);\
+void NAME##_erase(NAME *table, const char *key);\
+void NAME##_erase_n(NAME *table, const char *key, size_t length);\
+void NAME##_clear(NAME *table);\
+bool NAME##_swap(NAME *table, const char *a, const char *b);\
+bool NAME##_get(const NAME *table, TYPE *out, const char *key);\
+bool NAME##_get_n(const NAME *table, TYPE *out, const char *key, size_t length);\
+TYPE *NAME##_get_ptr(const NAME *table, const char *key);\
+TYPE *NAME##_get_ptr_n(const NAME *table, const char *key, size_t length);\
+bool NAME##_contains(const NAME *table, const char *key);\
+bool NAME##_contains_n(const NAME *table, const char *key, size_t length);\
+size_t NAME##_size(const NAME *table);\
+bool NAME##_is_empty(const NAME *table);\
+size_t NAME##_hash_string(const char *key);\
+size_t NAME##_hash_bytes(const char *key, size_t length);\
+NAME##Iter NAME##_iter_begin(const NAME *table);\
+NAME##Entry *NAME##_iter_next(const NAME *table, NAME##Iter *iter);
+
+
+#define HIRZEL_DENSE_TABLE_DEFINE(TYPE, NAME)\
+\
+/* entries a slot array holds before it is rebuilt, counting holes */\
+static size_t NAME##_max_load(size_t capacity)\
+{\
+	return capacity - capacity / 4;\
+}\
+\
+static size_t NAME##_get_min_capacity(size_t count)\
+{\
+	size_t capacity = HIRZEL_DENSE_TABLE_MIN_CAPACITY;\
+\
+	while (NAME##_max_load(capacity) < count)\
+		capacity *= 2;\
+\
+	return capacity;\
+}\
+\
+static size_t NAME##_hash(const NAME *table, const char *key, size_t length)\
+{\
+	return (size_t)hirzel_hash_mix(table->hash_function(key, length));\
+}\
+\
+/* slots store an entry index plus one, so 0 marks an empty slot */\
+static uint32_t *NAME##_find_slot(const NAME *table, const char *key, size_t length, size_t hash)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	size_t mask = table->capacity - 1;\
+	size_t i = hash & mask;\
+\
+	while (table->slots[i])\
+	{\
+		const NAME##Entry *entry = table->entries + table->slots[i] - 1;\
+\
+		if (entry->key && entry->hash == hash && entry->key_length == length && !memcmp(entry->key, key, length))\
+			return table->slots + i;\
+\
+		i = (i + 1) & mask;\
+	}\
+\
+	return NULL;\
+}\
+\
+static void NAME##_place(NAME *table, size_t index)\
+{\
+	assert(table != NULL);\
+\
+	size_t mask = table->capacity - 1;\
+	size_t i = table->entries[index].hash & mask;\
+\
+	while (table->slots[i])\
+		i = (i + 1) & mask;\
+\
+	table->slots[i] = (uint32_t)(index + 1);\
+}\
+\
+/* rebuilds the slots at a new capacity, closing the holes in the entries */\
+static bool NAME##_rebuild(NAME *table, size_t new_capacity)\
+{\
+	assert(table != NULL);\
+	assert((new_capacity & (new_capacity - 1)) == 0);\
+	assert(NAME##_max_load(new_capacity) >= table->count);\
+\
+	size_t entry_capacity = NAME##_max_load(new_capacity);\
+\
+	if (entry_capacity >= UINT32_MAX)\
+		return false;\
+\
+	uint32_t *slots = calloc(new_capacity, sizeof(uint32_t));\
+\
+	if (!slots)\
+		return false;\
+\
+	if (entry_capacity > table->entry_capacity)\
+	{\
+		NAME##Entry *entries = realloc(table->entries, entry_capacity * sizeof(NAME##Entry));\
+\
+		if (!entries)\
+		{\
+			free(slots);\
+			return false;\
+		}\
+\
+		table->entries = entries;\
+		table->entry_capacity = entry_capacity;\
+	}\
+\
+	size_t count = 0;\
+\
+	for (size_t i = 0; i < table->entry_count; ++i)\
+	{\
+		if (table->entries[i].key)\
+			table->entries[count++] = table->entries[i];\
+	}\
+\
+	free(table->slots);\
+	table->slots = slots;\
+	table->capacity = new_capacity;\
+	table->entry_count = count;\
+\
+	for (size_t i = 0; i < count; ++i)\
+		NAME##_place(table, i);\
+\
+	/* a failed shrink just keeps the larger entry array */\
+	if (entry_capacity < table->entry_capacity)\
+	{\
+		NAME##Entry *entries = realloc(table->entries, entry_capacity * sizeof(NAME##Entry));\
+\
+		if (entries)\
+		{\
+			table->entries = entries;\
+			table->entry_capacity = entry_capacity;\
+		}\
+	}\
+\
+	return true;\
+}\
+\
+bool NAME##_init(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	*table = (NAME) { NULL, NULL, NAME##_hash_bytes, 0, 0, 0, 0 };\
+\
+	if (NAME##_rebuild(table, HIRZEL_DENSE_TABLE_MIN_CAPACITY))\
+		return true;\
+\
+	free(table->entries);\
+\
+	return false;\
+}\
+\
+void NAME##_free(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	for (size_t i = 0; i < table->entry_count; ++i)\
+		free(table->entries[i].key);\
+\
+	free(table->entries);\
+	free(table->slots);\
+}\
+\
+bool NAME##_reserve(NAME *table, size_t min_count)\
+{\
+	assert(table != NULL);\
+\
+	size_t capacity = NAME##_get_min_capacity(min_count);\
+\
+	if (capacity <= table->capacity)\
+		return true;\
+\
+	return NAME##_rebuild(table, capacity);\
+}\
+\
+bool NAME##_shrink(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	return NAME##_rebuild(table, NAME##_get_min_capacity(table->count));\
+}\
+\
+bool NAME##_set_ptr_n(NAME *table, const char* key, size_t length, const TYPE *value)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+	assert(value != NULL);\
+\
+	size_t hash = NAME##_hash(table, key, length);\
+	uint32_t *slot = NAME##_find_slot(table, key, length, hash);\
+\
+	if (slot)\
+	{\
+		table->entries[*slot - 1].value = *value;\
+		return true;\
+	}\
+\
+	if (table->entry_count >= NAME##_max_load(table->capacity))\
+	{\
+		/* mostly holes: close them up in place instead of growing */\
+		size_t capacity = (table->count + 1) * 2 > NAME##_max_load(table->capacity)\
+			? table->capacity * 2\
+			: table->capacity;\
+\
+		if (!NAME##_rebuild(table, capacity))\
+			return false;\
+	}\
+\
+	char *key_buffer = malloc(length + 1);\
+\
+	if (!key_buffer)\
+		return false;\
+\
+	memcpy(key_buffer, key, length);\
+	key_buffer[length] = '\0';\
+\
+	size_t index = table->entry_count;\
+\
+	table->entries[index] = (NAME##Entry) { key_buffer, length, hash, *value };\
+	table->entry_count += 1;\
+	table->count += 1;\
+	NAME##_place(table, index);\
+\
+	return true;\
+}\
+\
+bool NAME##_set_ptr(NAME *table, const char* key, const TYPE *value)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_set_ptr_n(table, key, strlen(key), value);\
+}\
+\
+bool NAME##_set_n(NAME *table, const char *key, size_t length, TYPE value)\
+{\
+	return NAME##_set_ptr_n(table, key, length, &value);\
+}\
+\
+bool NAME##_set(NAME *table, const char *key, TYPE value)\
+{\
+	return NAME##_set_ptr(table, key, &value);\
+}\
+\
+TYPE *NAME##_get_ptr_n(const NAME *table, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	uint32_t *slot = NAME##_find_slot(table, key, length, NAME##_hash(table, key, length));\
+\
+	return slot != NULL\
+		? &table->entries[*slot - 1].value\
+		: NULL;\
+}\
+\
+TYPE *NAME##_get_ptr(const NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_get_ptr_n(table, key, strlen(key));\
+}\
+\
+bool NAME##_get_n(const NAME *table, TYPE *out, const char *key, size_t length)\
+{\
+	assert(out != NULL);\
+\
+	TYPE *value = NAME##_get_ptr_n(table, key, length);\
+\
+	if (!value)\
+		return false;\
+\
+	*out = *value;\
+\
+	return true;\
+}\
+\
+bool NAME##_get(const NAME *table, TYPE *out, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_get_n(table, out, key, strlen(key));\
+}\
+\
+bool NAME##_contains_n(const NAME *table, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	return NAME##_find_slot(table, key, length, NAME##_hash(table, key, length)) != NULL;\
+}\
+\
+bool NAME##_contains(const NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_contains_n(table, key, strlen(key));\
+}\
+\
+void NAME##_erase_n(NAME *table, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	uint32_t *slot = NAME##_find_slot(table, key, length, NAME##_hash(table, key, length));\
+\
+	if (!slot)\
+		return;\
+\
+	/* the slot keeps pointing at the hole, so later keys stay reachable */\
+	NAME##Entry *entry = table->entries + *slot - 1;\
+\
+	free(entry->key);\
+	entry->key = NULL;\
+	table->count -= 1;\
+}\
+\
+void NAME##_erase(NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	NAME##_erase_n(table, key, strlen(key));\
+}\
+\
+void NAME##_clear(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	for (size_t i = 0; i < table->entry_count; ++i)\
+		free(table->entries[i].key);\
+\
+	memset(table->slots, 0, table->capacity * sizeof(uint32_t));\
+	table->entry_count = 0;\
+	table->count = 0;\
+}\
+\
+bool NAME##_swap(NAME *table, const char *key_a, const char *key_b)\
+{\
+	assert(table != NULL);\
+	assert(key_a != NULL);\
+	assert(key_b != NULL);\
+\
+	TYPE *value_a = NAME##_get_ptr(table, key_a);\
+\
+	if (!value_a)\
+		return false;\
+\
+	TYPE *value_b = NAME##_get_ptr(table, key_b);\
+\
+	if (!value_b)\
+		return false;\
+\
+	TYPE tmp = *value_a;\
+	*value_a = *value_b;\
+	*value_b = tmp;\
+\
+	return true;\
+}\
+\
+size_t NAME##_size(const NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	return table->capacity;\
+}\
+\
+bool NAME##_is_empty(const NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	return table->count == 0;\
+}\
+\
+size_t NAME##_hash_string(const char *string)\
+{\
+	assert(string != NULL);\
+\
+	return hirzel_hash_string(string);\
+}\
+\
+size_t NAME##_hash_bytes(const char *key, size_t length)\
+{\
+	assert(key != NULL);\
+\
+	return (size_t)hirzel_hash_bytes(key, length, HIRZEL_HASH_DEFAULT_SEED);\
+}\
+\
+NAME##Iter NAME##_iter_begin(const NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	(void)table;\
+\
+	return (NAME##Iter) { 0 };\
+}\
+\
+/* next live entry in insertion order, or NULL once every key has been visited.\
+ * Values may change mid iteration, and so may erasing the entry just visited. */\
+NAME##Entry *NAME##_iter_next(const NAME *table, NAME##Iter *iter)\
+{\
+	assert(table != NULL);\
+	assert(iter != NULL);\
+\
+	while (iter->index < table->entry_count)\
+	{\
+		NAME##Entry *entry = table->entries + iter->index;\
+\
+		iter->index += 1;\
+\
+		if (entry->key)\
+			return entry;\
+	}\
+\
+	return NULL;\
+}
+
+#endif
@@ -0,0 +1,340 @@
+#ifndef HIRZEL_DEQUE_H
+#define HIRZEL_DEQUE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <hirzel/allocator.h>
+
+/*
+ * Double ended queue in a circular buffer. Items occupy capacity slots
+ * starting at head and wrapping around to the start of the buffer, so pushing
+ * and popping at either end moves no other item. The capacity is a power of
+ * two, which reduces wrapping to a mask.
+ *
+ * The items are at most two runs of the buffer, which NAME##_slices gives for
+ * bulk copies, and NAME##_push_n and NAME##_popf_n copy whole runs at a time.
+ * Allocation follows HIRZEL_ARRAY_ALLOCATOR.
+ *
+ *	HIRZEL_DEQUE_DECLARE(Job, JobQueue)
+ *	HIRZEL_DEQUE_DEFINE(Job, JobQueue)
+ */
+
+#define HIRZEL_DEQUE_MIN_CAPACITY 8
+
+#ifndef HIRZEL_ARRAY_ALLOCATOR
+#define HIRZEL_ARRAY_ALLOCATOR NULL
+#endif
+
+#define HIRZEL_DEQUE_DECLARE(TYPE, NAME)\
+\
+typedef struct __##NAME\
+{\
+	TYPE *buffer;\
+	size_t head;\
+	size_t length;\
+	size_t capacity;\
+	const HirzelAllocator *allocator;\
+} NAME;\
+\
+typedef struct __##NAME##Slice\
+{\
+	TYPE *data;\
+	size_t length;\
+} NAME##Slice;\
+\
+NAME NAME##_init();\
+NAME NAME##_init_allocator(const HirzelAllocator *allocator);\
+void NAME##_free(NAME *deque);\
+bool NAME##_reserve(NAME *deque, size_t min_capacity);\
+TYPE *NAME##_push_raw(NAME *deque);\
+TYPE *NAME##_push(NAME *deque, TYPE item);\
+TYPE *NAME##_push_ptr(NAME *deque, const TYPE *item);\
+TYPE *NAME##_pushf_raw(NAME *deque);\
+TYPE *NAME##_pushf(NAME *deque, TYPE item);\
+TYPE *NAME##_pushf_ptr(NAME *deque, const TYPE *item);\
+bool NAME##_push_n(NAME *deque, const TYPE *items, size_t count);\
+void NAME##_pop(NAME *deque);\
+void NAME##_popf(NAME *deque);\
+size_t NAME##_popf_n(NAME *deque, TYPE *out, size_t count);\
+void NAME##_slices(NAME *deque, NAME##Slice *first, NAME##Slice *second);\
+void NAME##_set(NAME *deque, size_t pos, TYPE item);\
+void NAME##_set_ptr(NAME *deque, size_t pos, const TYPE *item);\
+TYPE NAME##_get(NAME *deque, size_t i);\
+TYPE *NAME##_get_ptr(NAME *deque, size_t i);\
+TYPE NAME##_front(NAME *deque);\
+TYPE *NAME##_front_ptr(NAME *deque);\
+TYPE NAME##_back(NAME *deque);\
+TYPE *NAME##_back_ptr(NAME *deque);\
+inline static void NAME##_clear(NAME *deque) { assert(deque != NULL); deque->head = 0; deque->length = 0; }\
+inline static bool NAME##_is_empty(NAME *deque) { assert(deque != NULL); return deque->length == 0; }\
+inline static size_t NAME##_length(NAME *deque) { assert(deque != NULL); return deque->length; }\
+inline static size_t NAME##_capacity(NAME *deque) { assert(deque != NULL); return deque->capacity; }
+
+
+#define HIRZEL_DEQUE_DEFINE(TYPE, NAME)\
+\
+NAME NAME##_init()\
+{\
+	return (NAME) { NULL, 0, 0, 0, HIRZEL_ARRAY_ALLOCATOR };\
+}\
+\
+NAME NAME##_init_allocator(const HirzelAllocator *allocator)\
+{\
+	return (NAME) { NULL, 0, 0, 0, allocator };\
+}\
+\
+void NAME##_free(NAME *deque)\
+{\
+	assert(deque != NULL);\
+\
+	hirzel_deallocate(deque->allocator, deque->buffer, deque->capacity * sizeof(TYPE));\
+	deque->buffer = NULL;\
+	deque->head = 0;\
+	deque->length = 0;\
+	deque->capacity = 0;\
+}\
+\
+/* buffer slot of the item at pos */\
+static size_t NAME##_slot(const NAME *deque, size_t pos)\
+{\
+	return (deque->head + pos) & (deque->capacity - 1);\
+}\
+\
+/* grows to a power of two of at least min_capacity, unwrapping the items that had wrapped around */\
+bool NAME##_reserve(NAME *deque, size_t min_capacity)\
+{\
+	assert(deque != NULL);\
+\
+	if (min_capacity <= deque->capacity)\
+		return true;\
+\
+	size_t capacity = deque->capacity ? deque->capacity : HIRZEL_DEQUE_MIN_CAPACITY;\
+\
+	while (capacity < min_capacity)\
+		capacity *= 2;\
+\
+	TYPE *buffer = hirzel_reallocate(deque->allocator, deque->buffer, deque->capacity * sizeof(TYPE), capacity * sizeof(TYPE));\
+\
+	if (!buffer)\
+		return false;\
+\
+	/* the wrapped run fits after the old end, as the capacity at least doubled */\
+	if (deque->head + deque->length > deque->capacity)\
+	{\
+		size_t wrapped = deque->head + deque->length - deque->capacity;\
+\
+		memcpy(buffer + deque->capacity, buffer, wrapped * sizeof(TYPE));\
+	}\
+\
+	deque->buffer = buffer;\
+	deque->capacity = capacity;\
+\
+	return true;\
+}\
+\
+TYPE *NAME##_push_raw(NAME *deque)\
+{\
+	assert(deque != NULL);\
+\
+	if (deque->length == deque->capacity && !NAME##_reserve(deque, deque->length + 1))\
+		return NULL;\
+\
+	TYPE *back = deque->buffer + NAME##_slot(deque, deque->length);\
+	deque->length += 1;\
+\
+	return back;\
+}\
+\
+TYPE *NAME##_push(NAME *deque, TYPE item)\
+{\
+	TYPE *back = NAME##_push_raw(deque);\
+\
+	if (back != NULL)\
+		*back = item;\
+\
+	return back;\
+}\
+\
+TYPE *NAME##_push_ptr(NAME *deque, const TYPE *item)\
+{\
+	assert(item != NULL);\
+\
+	TYPE *back = NAME##_push_raw(deque);\
+\
+	if (back != NULL)\
+		*back = *item;\
+\
+	return back;\
+}\
+\
+TYPE *NAME##_pushf_raw(NAME *deque)\
+{\
+	assert(deque != NULL);\
+\
+	if (deque->length == deque->capacity && !NAME##_reserve(deque, deque->length + 1))\
+		return NULL;\
+\
+	deque->head = (deque->head + deque->capacity - 1) & (deque->capacity - 1);\
+	deque->length += 1;\
+\
+	return deque->buffer + deque->head;\
+}\
+\
+TYPE *NAME##_pushf(NAME *deque, TYPE item)\
+{\
+	TYPE *front = NAME##_pushf_raw(deque);\
+\
+	if (front != NULL)\
+		*front = item;\
+\
+	return front;\
+}\
+\
+TYPE *NAME##_pushf_ptr(NAME *deque, const TYPE *item)\
+{\
+	assert(item != NULL);\
+\
+	TYPE *front = NAME##_pushf_raw(deque);\
+\
+	if (front != NULL)\
+		*front = *item;\
+\
+	return front;\
+}\
+\
+/* appends count items to the back with at most two copies */\
+bool NAME##_push_n(NAME *deque, const TYPE *items, size_t count)\
+{\
+	assert(deque != NULL);\
+	assert(items != NULL || count == 0);\
+\
+	if (count == 0)\
+		return true;\
+\
+	if (!NAME##_reserve(deque, deque->length + count))\
+		return false;\
+\
+	size_t slot = NAME##_slot(deque, deque->length);\
+	size_t first = deque->capacity - slot < count\
+		? deque->capacity - slot\
+		: count;\
+\
+	memcpy(deque->buffer + slot, items, first * sizeof(TYPE));\
+	memcpy(deque->buffer, items + first, (count - first) * sizeof(TYPE));\
+	deque->length += count;\
+\
+	return true;\
+}\
+\
+void NAME##_pop(NAME *deque)\
+{\
+	assert(deque != NULL);\
+\
+	if (deque->length > 0)\
+		deque->length -= 1;\
+}\
+\
+void NAME##_popf(NAME *deque)\
+{\
+	assert(deque != NULL);\
+\
+	if (deque->length == 0)\
+		return;\
+\
+	deque->head = NAME##_slot(deque, 1);\
+	deque->length -= 1;\
+}\
+\
+/* removes up to count items from the front, copying them to out if it isn't NULL, and returns how many */\
+size_t NAME##_popf_n(NAME *deque, TYPE *out, size_t count)\
+{\
+	assert(deque != NULL);\
+\
+	if (count > deque->length)\
+		count = deque->length;\
+\
+	if (count == 0)\
+		return 0;\
+\
+	if (out)\
+	{\
+		size_t first = deque->capacity - deque->head < count\
+			? deque->capacity - deque->head\
+			: count;\
+\
+		memcpy(out, deque->buffer + deque->head, first * sizeof(TYPE));\
+		memcpy(out + first, deque->buffer, (count - first) * sizeof(TYPE));\
+	}\
+\
+	deque->head = NAME##_slot(deque, count);\
+	deque->length -= count;\
+\
+	return count;\
+}\
+\
+/* the items in order as two runs of the buffer, the second of which is empty unless they wrap */\
+void NAME##_slices(NAME *deque, NAME##Slice *first, NAME##Slice *second)\
+{\
+	assert(deque != NULL);\
+	assert(first != NULL);\
+	assert(second != NULL);\
+\
+	size_t first_length = deque->capacity - deque->head < deque->length\
+		? deque->capacity - deque->head\
+		: deque->length;\
+\
+	*first = (NAME##Slice) { deque->buffer + deque->head, first_length };\
+	*second = (NAME##Slice) { deque->buffer, deque->length - first_length };\
+}\
+\
+TYPE *NAME##_get_ptr(NAME *deque, size_t i)\
+{\
+	assert(deque != NULL);\
+	assert(i < deque->length);\
+	return deque->buffer + NAME##_slot(deque, i);\
+}\
+\
+TYPE NAME##_get(NAME *deque, size_t i)\
+{\
+	return *NAME##_get_ptr(deque, i);\
+}\
+\
+void NAME##_set_ptr(NAME *deque, size_t pos, const TYPE *item)\
+{\
+	assert(item != NULL);\
+	*NAME##_get_ptr(deque, pos) = *item;\
+}\
+\
+void NAME##_set(NAME *deque, size_t pos, TYPE item)\
+{\
+	NAME##_set_ptr(deque, pos, &item);\
+}\
+\
+TYPE *NAME##_front_ptr(NAME *deque)\
+{\
+	assert(deque != NULL);\
+	assert(deque->length > 0);\
+	return deque->buffer + deque->head;\
+}\
+\
+TYPE NAME##_front(NAME *deque)\
+{\
+	return *NAME##_front_ptr(deque);\
+}\
+\
+TYPE *NAME##_back_ptr(NAME *deque)\
+{\
+	assert(deque != NULL);\
+	assert(deque->length > 0);\
+	return deque->buffer + NAME##_slot(deque, deque->length - 1);\
+}\
+\
+TYPE NAME##_back(NAME *deque)\
+{\
+	return *NAME##_back_ptr(deque);\
+}
+
+#endif
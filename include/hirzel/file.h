@@ -0,0 +1,1134 @@
+#ifndef HIRZEL_FILE_H
+#define HIRZEL_FILE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+/*
+ * File i/o helpers. hirzel_file_map maps a whole file read-only, so its bytes
+ * are paged in on first use rather than copied up front. Where mapping isn't
+ * possible, such as for pipes or empty files, the file is read into the heap
+ * instead and the result is used the same way.
+ *
+ * HirzelFileReader splits a stream into lines or other delimited records. It
+ * reads into one large buffer and hands out slices of it, so no record is
+ * copied or allocated on its own. HirzelFileWriter gathers small writes into a
+ * large buffer and passes them to the file in one call once it fills.
+ *
+ * HirzelFileQueue keeps several reads of one file in flight at once, each
+ * into memory the caller chooses, such as the buffer of a HIRZEL_ARRAY.
+ * HirzelFileBlocks builds on it to hand out a file block by block in order
+ * while the blocks after it are being read. Defining HIRZEL_FILE_IO_URING
+ * before including this header makes the queue submit its reads through
+ * io_uring on Linux. Without it, or where the kernel refuses to set up a
+ * ring, each read is a blocking pread when it is waited for.
+ */
+
+#define HIRZEL_FILE_BUFFER_SIZE (1 << 20)
+
+#ifndef HIRZEL_FILE_BLOCK_SIZE
+#define HIRZEL_FILE_BLOCK_SIZE (1 << 20)
+#endif
+
+#ifndef HIRZEL_FILE_QUEUE_DEPTH
+#define HIRZEL_FILE_QUEUE_DEPTH 8
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(HIRZEL_FILE_IO_URING)
+#if !defined(__linux__)
+#error "HIRZEL_FILE_IO_URING is only available on Linux"
+#endif
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+typedef struct HirzelFileMap
+{
+	const char *data;
+	size_t size;
+	bool is_mapped;
+} HirzelFileMap;
+
+static inline bool hirzel_file_read_all(HirzelFileMap *map, const char *path)
+{
+	assert(map != NULL);
+	assert(path != NULL);
+
+	FILE *file = fopen(path, "rb");
+
+	if (!file)
+		return false;
+
+	size_t capacity = 0;
+	size_t size = 0;
+	char *data = NULL;
+
+	while (true)
+	{
+		if (size == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 65536;
+
+			char *new_data = realloc(data, capacity);
+
+			if (!new_data)
+				break;
+
+			data = new_data;
+		}
+
+		size_t read_size = fread(data + size, 1, capacity - size, file);
+
+		size += read_size;
+
+		if (read_size == 0)
+			break;
+	}
+
+	bool is_read = !ferror(file) && feof(file);
+
+	fclose(file);
+
+	if (!is_read)
+	{
+		free(data);
+		return false;
+	}
+
+	*map = (HirzelFileMap) { data, size, false };
+
+	return true;
+}
+
+static inline bool hirzel_file_map(HirzelFileMap *map, const char *path)
+{
+	assert(map != NULL);
+	assert(path != NULL);
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		LARGE_INTEGER size;
+		const char *data = NULL;
+
+		if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && (unsigned long long)size.QuadPart <= (size_t)-1)
+		{
+			HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+			// the view keeps the file open once both handles are closed
+			if (mapping)
+			{
+				data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);
+			}
+		}
+
+		CloseHandle(file);
+
+		if (data)
+		{
+			*map = (HirzelFileMap) { data, (size_t)size.QuadPart, true };
+			return true;
+		}
+	}
+#else
+	int file = open(path, O_RDONLY);
+
+	if (file != -1)
+	{
+		struct stat info;
+		void *data = MAP_FAILED;
+
+		if (!fstat(file, &info) && S_ISREG(info.st_mode) && info.st_size > 0 && (unsigned long long)info.st_size <= (size_t)-1)
+			data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+		close(file);
+
+		if (data != MAP_FAILED)
+		{
+			*map = (HirzelFileMap) { data, (size_t)info.st_size, true };
+			return true;
+		}
+	}
+#endif
+
+	return hirzel_file_read_all(map, path);
+}
+
+static inline void hirzel_file_unmap(HirzelFileMap *map)
+{
+	assert(map != NULL);
+
+	if (!map->is_mapped)
+	{
+		free((void *)map->data);
+	}
+	else
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(map->data);
+#else
+		munmap((void *)map->data, map->size);
+#endif
+	}
+
+	*map = (HirzelFileMap) { NULL, 0, false };
+}
+
+typedef struct HirzelFileSlice
+{
+	const char *data;
+	size_t length;
+} HirzelFileSlice;
+
+typedef struct HirzelFileReader
+{
+	FILE *file;
+	char *buffer;
+	size_t capacity;
+	size_t begin;
+	size_t end;
+	bool is_owned;
+	bool is_error;
+} HirzelFileReader;
+
+/* reads from an open file, which stays open after the reader is closed */
+static inline bool hirzel_file_reader_init(HirzelFileReader *reader, FILE *file, size_t buffer_size)
+{
+	assert(reader != NULL);
+	assert(file != NULL);
+
+	if (buffer_size == 0)
+		buffer_size = HIRZEL_FILE_BUFFER_SIZE;
+
+	char *buffer = malloc(buffer_size);
+
+	if (!buffer)
+		return false;
+
+	*reader = (HirzelFileReader) { file, buffer, buffer_size, 0, 0, false, false };
+
+	return true;
+}
+
+static inline bool hirzel_file_reader_open(HirzelFileReader *reader, const char *path, size_t buffer_size)
+{
+	assert(reader != NULL);
+	assert(path != NULL);
+
+	FILE *file = fopen(path, "rb");
+
+	if (!file)
+		return false;
+
+	// the reader's own buffer replaces stdio's, saving a copy of every byte
+	setvbuf(file, NULL, _IONBF, 0);
+
+	if (!hirzel_file_reader_init(reader, file, buffer_size))
+	{
+		fclose(file);
+		return false;
+	}
+
+	reader->is_owned = true;
+
+	return true;
+}
+
+static inline void hirzel_file_reader_close(HirzelFileReader *reader)
+{
+	assert(reader != NULL);
+
+	if (reader->is_owned)
+		fclose(reader->file);
+
+	free(reader->buffer);
+	reader->file = NULL;
+	reader->buffer = NULL;
+}
+
+/* moves unread bytes to the front of the buffer, growing it if it is full, and reads more after them */
+static inline bool hirzel_file_reader_fill(HirzelFileReader *reader)
+{
+	assert(reader != NULL);
+
+	size_t unread = reader->end - reader->begin;
+
+	if (unread == reader->capacity)
+	{
+		char *buffer = realloc(reader->buffer, reader->capacity * 2);
+
+		if (!buffer)
+		{
+			reader->is_error = true;
+			return false;
+		}
+
+		reader->buffer = buffer;
+		reader->capacity *= 2;
+	}
+	else if (reader->begin > 0)
+	{
+		memmove(reader->buffer, reader->buffer + reader->begin, unread);
+	}
+
+	reader->begin = 0;
+	reader->end = unread;
+
+	size_t read_size = fread(reader->buffer + unread, 1, reader->capacity - unread, reader->file);
+
+	reader->end += read_size;
+
+	if (read_size == 0 && ferror(reader->file))
+		reader->is_error = true;
+
+	return read_size > 0;
+}
+
+/*
+ * Next record up to the delimiter, which is left out. The last record is
+ * returned even without a delimiter after it. The slice points into the
+ * reader's buffer and is valid until the next call. Returns false at the end
+ * of the file or on an error, which sets is_error.
+ */
+static inline bool hirzel_file_reader_next(HirzelFileReader *reader, char delimiter, HirzelFileSlice *out)
+{
+	assert(reader != NULL);
+	assert(out != NULL);
+
+	size_t searched = reader->begin;
+
+	while (true)
+	{
+		const char *end = memchr(reader->buffer + searched, delimiter, reader->end - searched);
+
+		if (end)
+		{
+			out->data = reader->buffer + reader->begin;
+			out->length = (size_t)(end - out->data);
+			reader->begin += out->length + 1;
+
+			return true;
+		}
+
+		size_t searched_count = reader->end - reader->begin;
+
+		if (!hirzel_file_reader_fill(reader))
+			break;
+
+		searched = reader->begin + searched_count;
+	}
+
+	if (reader->is_error || reader->begin == reader->end)
+		return false;
+
+	out->data = reader->buffer + reader->begin;
+	out->length = reader->end - reader->begin;
+	reader->begin = reader->end;
+
+	return true;
+}
+
+/* next line without its line ending, which may be \n or \r\n */
+static inline bool hirzel_file_reader_next_line(HirzelFileReader *reader, HirzelFileSlice *out)
+{
+	if (!hirzel_file_reader_next(reader, '\n', out))
+		return false;
+
+	if (out->length > 0 && out->data[out->length - 1] == '\r')
+		out->length -= 1;
+
+	return true;
+}
+
+typedef struct HirzelFileWriter
+{
+	FILE *file;
+	char *buffer;
+	size_t capacity;
+	size_t length;
+	bool is_owned;
+	bool is_error;
+} HirzelFileWriter;
+
+/* writes to an open file, which stays open after the writer is closed */
+static inline bool hirzel_file_writer_init(HirzelFileWriter *writer, FILE *file, size_t buffer_size)
+{
+	assert(writer != NULL);
+	assert(file != NULL);
+
+	if (buffer_size == 0)
+		buffer_size = HIRZEL_FILE_BUFFER_SIZE;
+
+	char *buffer = malloc(buffer_size);
+
+	if (!buffer)
+		return false;
+
+	*writer = (HirzelFileWriter) { file, buffer, buffer_size, 0, false, false };
+
+	return true;
+}
+
+static inline bool hirzel_file_writer_open(HirzelFileWriter *writer, const char *path, size_t buffer_size)
+{
+	assert(writer != NULL);
+	assert(path != NULL);
+
+	FILE *file = fopen(path, "wb");
+
+	if (!file)
+		return false;
+
+	setvbuf(file, NULL, _IONBF, 0);
+
+	if (!hirzel_file_writer_init(writer, file, buffer_size))
+	{
+		fclose(file);
+		return false;
+	}
+
+	writer->is_owned = true;
+
+	return true;
+}
+
+static inline bool hirzel_file_writer_flush(HirzelFileWriter *writer)
+{
+	assert(writer != NULL);
+
+	if (writer->length > 0 && !writer->is_error)
+		writer->is_error = fwrite(writer->buffer, 1, writer->length, writer->file) != writer->length;
+
+	writer->length = 0;
+
+	return !writer->is_error && !fflush(writer->file);
+}
+
+/* errors stick, so a run of writes can be checked once at flush or close */
+static inline bool hirzel_file_writer_write(HirzelFileWriter *writer, const void *data, size_t size)
+{
+	assert(writer != NULL);
+	assert(data != NULL || size == 0);
+
+	if (writer->capacity - writer->length < size)
+	{
+		hirzel_file_writer_flush(writer);
+
+		// too large to be worth buffering
+		if (size >= writer->capacity)
+		{
+			if (!writer->is_error)
+				writer->is_error = fwrite(data, 1, size, writer->file) != size;
+
+			return !writer->is_error;
+		}
+	}
+
+	memcpy(writer->buffer + writer->length, data, size);
+	writer->length += size;
+
+	return !writer->is_error;
+}
+
+static inline bool hirzel_file_writer_write_string(HirzelFileWriter *writer, const char *string)
+{
+	assert(string != NULL);
+
+	return hirzel_file_writer_write(writer, string, strlen(string));
+}
+
+static inline bool hirzel_file_writer_printf(HirzelFileWriter *writer, const char *format, ...)
+{
+	assert(writer != NULL);
+	assert(format != NULL);
+
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(writer->buffer + writer->length, writer->capacity - writer->length, format, args);
+	va_end(args);
+
+	if (length < 0)
+	{
+		writer->is_error = true;
+		return false;
+	}
+
+	if ((size_t)length < writer->capacity - writer->length)
+	{
+		writer->length += (size_t)length;
+		return !writer->is_error;
+	}
+
+	// didn't fit in what was left of the buffer, so format it again on its own
+	char *text = malloc((size_t)length + 1);
+
+	if (!text)
+	{
+		writer->is_error = true;
+		return false;
+	}
+
+	va_start(args, format);
+	vsnprintf(text, (size_t)length + 1, format, args);
+	va_end(args);
+
+	hirzel_file_writer_write(writer, text, (size_t)length);
+	free(text);
+
+	return !writer->is_error;
+}
+
+/* flushes the writer, closing the file if it opened it, and returns whether every write succeeded */
+static inline bool hirzel_file_writer_close(HirzelFileWriter *writer)
+{
+	assert(writer != NULL);
+
+	bool is_written = hirzel_file_writer_flush(writer);
+
+	if (writer->is_owned)
+		is_written = !fclose(writer->file) && is_written;
+
+	free(writer->buffer);
+	writer->file = NULL;
+	writer->buffer = NULL;
+
+	return is_written;
+}
+
+typedef struct HirzelFileRead
+{
+	char *buffer;
+	size_t size;
+	uint64_t offset;
+	size_t length;
+} HirzelFileRead;
+
+#if defined(HIRZEL_FILE_IO_URING)
+typedef struct HirzelFileRing
+{
+	int ring;
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_mask;
+	unsigned *sq_array;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned *cq_mask;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+	struct iovec *iovecs;
+	void *sq_map;
+	size_t sq_map_size;
+	void *cq_map;
+	size_t cq_map_size;
+	size_t sqes_size;
+} HirzelFileRing;
+#endif
+
+/*
+ * Reads of one file in flight at once, each in one of depth slots. A read
+ * completes once its buffer is full or the end of the file is reached, and
+ * reads[slot].length then holds how much was read.
+ */
+typedef struct HirzelFileQueue
+{
+#if defined(_WIN32)
+	HANDLE file;
+#else
+	int file;
+#endif
+	uint64_t size;
+	HirzelFileRead *reads;
+	size_t *pending;
+	size_t depth;
+	size_t pending_begin;
+	size_t pending_count;
+	bool is_error;
+#if defined(HIRZEL_FILE_IO_URING)
+	bool is_ring;
+	HirzelFileRing ring;
+#endif
+} HirzelFileQueue;
+
+#if defined(HIRZEL_FILE_IO_URING)
+static inline bool hirzel_file_ring_init(HirzelFileRing *ring, size_t depth)
+{
+	assert(ring != NULL);
+
+	struct io_uring_params params;
+
+	memset(&params, 0, sizeof(params));
+
+	int fd = (int)syscall(__NR_io_uring_setup, (unsigned)depth, &params);
+
+	if (fd < 0)
+		return false;
+
+	ring->ring = fd;
+	ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	// newer kernels share one mapping between both rings
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (ring->cq_map_size > ring->sq_map_size)
+			ring->sq_map_size = ring->cq_map_size;
+
+		ring->cq_map_size = 0;
+	}
+
+	ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	ring->cq_map = ring->cq_map_size
+		? mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING)
+		: ring->sq_map;
+	ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	ring->iovecs = malloc(depth * sizeof(struct iovec));
+
+	if (ring->sq_map == MAP_FAILED || ring->cq_map == MAP_FAILED || ring->sqes == MAP_FAILED || !ring->iovecs)
+	{
+		if (ring->sqes != MAP_FAILED)
+			munmap(ring->sqes, ring->sqes_size);
+
+		if (ring->cq_map_size && ring->cq_map != MAP_FAILED)
+			munmap(ring->cq_map, ring->cq_map_size);
+
+		if (ring->sq_map != MAP_FAILED)
+			munmap(ring->sq_map, ring->sq_map_size);
+
+		free(ring->iovecs);
+		close(fd);
+
+		return false;
+	}
+
+	char *sq = ring->sq_map;
+	char *cq = ring->cq_map;
+
+	ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+	ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+	ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+	ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+	ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+	ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+	ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+	return true;
+}
+
+static inline void hirzel_file_ring_free(HirzelFileRing *ring)
+{
+	assert(ring != NULL);
+
+	munmap(ring->sqes, ring->sqes_size);
+
+	if (ring->cq_map_size)
+		munmap(ring->cq_map, ring->cq_map_size);
+
+	munmap(ring->sq_map, ring->sq_map_size);
+	free(ring->iovecs);
+	close(ring->ring);
+}
+
+/* queues a read of what is left of the slot's buffer and submits it */
+static inline bool hirzel_file_ring_submit(HirzelFileQueue *queue, size_t slot)
+{
+	assert(queue != NULL);
+
+	HirzelFileRing *ring = &queue->ring;
+	HirzelFileRead *read = queue->reads + slot;
+	unsigned tail = *ring->sq_tail;
+	unsigned index = tail & *ring->sq_mask;
+	struct io_uring_sqe *sqe = ring->sqes + index;
+
+	// at most depth reads are in flight, so the submission ring never fills
+	ring->iovecs[slot].iov_base = read->buffer + read->length;
+	ring->iovecs[slot].iov_len = read->size - read->length;
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = IORING_OP_READV;
+	sqe->fd = queue->file;
+	sqe->off = read->offset + read->length;
+	sqe->addr = (uint64_t)(uintptr_t)(ring->iovecs + slot);
+	sqe->len = 1;
+	sqe->user_data = slot;
+
+	ring->sq_array[index] = index;
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	return syscall(__NR_io_uring_enter, ring->ring, 1, 0, 0, NULL, 0) == 1;
+}
+
+static inline bool hirzel_file_ring_wait(HirzelFileQueue *queue, size_t *slot)
+{
+	assert(queue != NULL);
+	assert(slot != NULL);
+
+	HirzelFileRing *ring = &queue->ring;
+
+	while (true)
+	{
+		unsigned head = *ring->cq_head;
+
+		if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+		{
+			if (syscall(__NR_io_uring_enter, ring->ring, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
+				return false;
+
+			continue;
+		}
+
+		struct io_uring_cqe *cqe = ring->cqes + (head & *ring->cq_mask);
+		size_t completed = (size_t)cqe->user_data;
+		int result = cqe->res;
+
+		__atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+
+		if (result == -EINTR || result == -EAGAIN)
+		{
+			if (!hirzel_file_ring_submit(queue, completed))
+				return false;
+
+			continue;
+		}
+
+		if (result < 0)
+			return false;
+
+		HirzelFileRead *read = queue->reads + completed;
+
+		read->length += (size_t)result;
+
+		// a short read before the end of the file is finished by another
+		if (result > 0 && read->length < read->size)
+		{
+			if (!hirzel_file_ring_submit(queue, completed))
+				return false;
+
+			continue;
+		}
+
+		*slot = completed;
+
+		return true;
+	}
+}
+#endif
+
+/* blocking read of the slot's buffer, stopping early only at the end of the file */
+static inline bool hirzel_file_queue_read_slot(HirzelFileQueue *queue, size_t slot)
+{
+	assert(queue != NULL);
+
+	HirzelFileRead *read = queue->reads + slot;
+
+	while (read->length < read->size)
+	{
+		size_t size = read->size - read->length;
+		uint64_t offset = read->offset + read->length;
+
+#if defined(_WIN32)
+		OVERLAPPED overlapped;
+		DWORD read_size;
+
+		memset(&overlapped, 0, sizeof(overlapped));
+		overlapped.Offset = (DWORD)offset;
+		overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+		if (size > 0x40000000)
+			size = 0x40000000;
+
+		if (!ReadFile(queue->file, read->buffer + read->length, (DWORD)size, &read_size, &overlapped))
+			return GetLastError() == ERROR_HANDLE_EOF;
+#else
+		ssize_t read_size = pread(queue->file, read->buffer + read->length, size, (off_t)offset);
+
+		if (read_size < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			return false;
+		}
+#endif
+
+		if (read_size == 0)
+			break;
+
+		read->length += (size_t)read_size;
+	}
+
+	return true;
+}
+
+/* depth of 0 uses HIRZEL_FILE_QUEUE_DEPTH */
+static inline bool hirzel_file_queue_open(HirzelFileQueue *queue, const char *path, size_t depth)
+{
+	assert(queue != NULL);
+	assert(path != NULL);
+
+	if (depth == 0)
+		depth = HIRZEL_FILE_QUEUE_DEPTH;
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	LARGE_INTEGER size;
+
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	queue->size = (uint64_t)size.QuadPart;
+#else
+	int file = open(path, O_RDONLY);
+	struct stat info;
+
+	if (file == -1)
+		return false;
+
+	if (fstat(file, &info))
+	{
+		close(file);
+		return false;
+	}
+
+	queue->size = (uint64_t)info.st_size;
+#endif
+
+	queue->file = file;
+	queue->reads = calloc(depth, sizeof(HirzelFileRead));
+	queue->pending = malloc(depth * sizeof(size_t));
+	queue->depth = depth;
+	queue->pending_begin = 0;
+	queue->pending_count = 0;
+	queue->is_error = false;
+
+	if (!queue->reads || !queue->pending)
+	{
+		free(queue->reads);
+		free(queue->pending);
+#if defined(_WIN32)
+		CloseHandle(file);
+#else
+		close(file);
+#endif
+		return false;
+	}
+
+#if defined(HIRZEL_FILE_IO_URING)
+	queue->is_ring = hirzel_file_ring_init(&queue->ring, depth);
+#endif
+
+	return true;
+}
+
+/* waits for reads still in flight, as their buffers may belong to the caller */
+static inline void hirzel_file_queue_close(HirzelFileQueue *queue)
+{
+	assert(queue != NULL);
+
+#if defined(HIRZEL_FILE_IO_URING)
+	if (queue->is_ring)
+	{
+		size_t slot;
+
+		while (queue->pending_count > 0 && hirzel_file_ring_wait(queue, &slot))
+			queue->pending_count -= 1;
+
+		hirzel_file_ring_free(&queue->ring);
+	}
+#endif
+
+#if defined(_WIN32)
+	CloseHandle(queue->file);
+#else
+	close(queue->file);
+#endif
+	free(queue->reads);
+	free(queue->pending);
+	queue->reads = NULL;
+	queue->pending = NULL;
+}
+
+/*
+ * Starts reading size bytes at offset into buffer in a free slot, which must
+ * not be reused until wait returns it. Returns false if every slot is in use
+ * or the read can't be submitted, which sets is_error.
+ */
+static inline bool hirzel_file_queue_submit(HirzelFileQueue *queue, size_t slot, void *buffer, size_t size, uint64_t offset)
+{
+	assert(queue != NULL);
+	assert(slot < queue->depth);
+	assert(buffer != NULL || size == 0);
+
+	if (queue->pending_count == queue->depth || queue->is_error)
+		return false;
+
+	queue->reads[slot] = (HirzelFileRead) { buffer, size, offset, 0 };
+
+#if defined(HIRZEL_FILE_IO_URING)
+	if (queue->is_ring)
+	{
+		if (!hirzel_file_ring_submit(queue, slot))
+		{
+			queue->is_error = true;
+			return false;
+		}
+
+		queue->pending_count += 1;
+
+		return true;
+	}
+#endif
+
+	queue->pending[(queue->pending_begin + queue->pending_count) % queue->depth] = slot;
+	queue->pending_count += 1;
+
+	return true;
+}
+
+/* waits for any submitted read to complete and gives its slot, or false on an error or if none are in flight */
+static inline bool hirzel_file_queue_wait(HirzelFileQueue *queue, size_t *slot)
+{
+	assert(queue != NULL);
+	assert(slot != NULL);
+
+	if (queue->pending_count == 0 || queue->is_error)
+		return false;
+
+#if defined(HIRZEL_FILE_IO_URING)
+	if (queue->is_ring)
+	{
+		if (!hirzel_file_ring_wait(queue, slot))
+		{
+			queue->is_error = true;
+			return false;
+		}
+
+		queue->pending_count -= 1;
+
+		return true;
+	}
+#endif
+
+	// without a ring, reads are done in the order they were submitted
+	*slot = queue->pending[queue->pending_begin];
+	queue->pending_begin = (queue->pending_begin + 1) % queue->depth;
+	queue->pending_count -= 1;
+
+	if (!hirzel_file_queue_read_slot(queue, *slot))
+	{
+		queue->is_error = true;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Reads size bytes at offset into buffer as blocks of block_size, or
+ * HIRZEL_FILE_BLOCK_SIZE if 0, with up to depth of them in flight. Fails if the
+ * file ends first. Every slot must be free.
+ */
+static inline bool hirzel_file_queue_read(HirzelFileQueue *queue, void *buffer, size_t size, uint64_t offset, size_t block_size)
+{
+	assert(queue != NULL);
+	assert(buffer != NULL || size == 0);
+	assert(queue->pending_count == 0);
+
+	if (block_size == 0)
+		block_size = HIRZEL_FILE_BLOCK_SIZE;
+
+	char *data = buffer;
+	size_t submitted = 0;
+	size_t slot = 0;
+	bool is_read = true;
+
+	while (submitted < size && slot < queue->depth)
+	{
+		size_t read_size = size - submitted < block_size
+			? size - submitted
+			: block_size;
+
+		if (!hirzel_file_queue_submit(queue, slot, data + submitted, read_size, offset + submitted))
+			break;
+
+		submitted += read_size;
+		slot += 1;
+	}
+
+	while (queue->pending_count > 0)
+	{
+		if (!hirzel_file_queue_wait(queue, &slot))
+			return false;
+
+		HirzelFileRead *read = queue->reads + slot;
+
+		if (read->length < read->size)
+			is_read = false;
+
+		if (!is_read || submitted == size)
+			continue;
+
+		size_t read_size = size - submitted < block_size
+			? size - submitted
+			: block_size;
+
+		if (!hirzel_file_queue_submit(queue, slot, data + submitted, read_size, offset + submitted))
+			return false;
+
+		submitted += read_size;
+	}
+
+	return is_read && submitted == size && !queue->is_error;
+}
+
+/* a file handed out block by block in order, with the blocks after the current one read ahead */
+typedef struct HirzelFileBlocks
+{
+	HirzelFileQueue queue;
+	char *buffer;
+	bool *is_done;
+	size_t block_size;
+	size_t slot;
+	uint64_t offset;
+	uint64_t next_offset;
+	bool is_started;
+} HirzelFileBlocks;
+
+/* block_size and depth of 0 use HIRZEL_FILE_BLOCK_SIZE and HIRZEL_FILE_QUEUE_DEPTH */
+static inline bool hirzel_file_blocks_open(HirzelFileBlocks *blocks, const char *path, size_t block_size, size_t depth)
+{
+	assert(blocks != NULL);
+	assert(path != NULL);
+
+	if (block_size == 0)
+		block_size = HIRZEL_FILE_BLOCK_SIZE;
+
+	if (!hirzel_file_queue_open(&blocks->queue, path, depth))
+		return false;
+
+	depth = blocks->queue.depth;
+	blocks->buffer = malloc(depth * block_size);
+	blocks->is_done = calloc(depth, sizeof(bool));
+	blocks->block_size = block_size;
+	blocks->slot = 0;
+	blocks->offset = 0;
+	blocks->next_offset = 0;
+	blocks->is_started = false;
+
+	if (!blocks->buffer || !blocks->is_done)
+	{
+		free(blocks->buffer);
+		free(blocks->is_done);
+		hirzel_file_queue_close(&blocks->queue);
+		return false;
+	}
+
+	for (size_t i = 0; i < depth && blocks->next_offset < blocks->queue.size; ++i)
+	{
+		if (!hirzel_file_queue_submit(&blocks->queue, i, blocks->buffer + i * block_size, block_size, blocks->next_offset))
+			break;
+
+		blocks->next_offset += block_size;
+	}
+
+	return true;
+}
+
+static inline void hirzel_file_blocks_close(HirzelFileBlocks *blocks)
+{
+	assert(blocks != NULL);
+
+	hirzel_file_queue_close(&blocks->queue);
+	free(blocks->buffer);
+	free(blocks->is_done);
+	blocks->buffer = NULL;
+	blocks->is_done = NULL;
+}
+
+/*
+ * Next block of the file, which is block_size long except at the end. The
+ * slice is valid until the next call, when its buffer is reused to read ahead.
+ * Returns false at the end of the file or on an error, which sets
+ * queue.is_error.
+ */
+static inline bool hirzel_file_blocks_next(HirzelFileBlocks *blocks, HirzelFileSlice *out)
+{
+	assert(blocks != NULL);
+	assert(out != NULL);
+
+	HirzelFileQueue *queue = &blocks->queue;
+
+	// the block given out last has been used, so its buffer reads the next one ahead
+	if (blocks->is_started)
+	{
+		size_t last = blocks->slot;
+
+		blocks->is_done[last] = false;
+		blocks->slot = (last + 1) % queue->depth;
+		blocks->offset += blocks->block_size;
+
+		if (blocks->next_offset < queue->size)
+		{
+			if (!hirzel_file_queue_submit(queue, last, blocks->buffer + last * blocks->block_size, blocks->block_size, blocks->next_offset))
+				return false;
+
+			blocks->next_offset += blocks->block_size;
+		}
+	}
+
+	if (blocks->offset >= queue->size)
+		return false;
+
+	blocks->is_started = true;
+
+	while (!blocks->is_done[blocks->slot])
+	{
+		size_t slot;
+
+		if (!hirzel_file_queue_wait(queue, &slot))
+			return false;
+
+		blocks->is_done[slot] = true;
+	}
+
+	HirzelFileRead *read = queue->reads + blocks->slot;
+
+	// the file shrank since it was opened
+	if (read->length == 0)
+		return false;
+
+	out->data = read->buffer;
+	out->length = read->length;
+
+	return true;
+}
+
+#endif
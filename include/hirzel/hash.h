@@ -0,0 +1,162 @@
+#ifndef HIRZEL_HASH_H
+#define HIRZEL_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#endif
+
+/*
+ * 64-bit string hashing shared by the containers. hirzel_hash_bytes follows
+ * wyhash: input is consumed 8 or 16 bytes at a time and folded with 64x64->128
+ * bit multiplies, which compile to a single mul/mulx on 64-bit targets.
+ *
+ * Tables that may be filled with untrusted keys should hash with a secret,
+ * per-process seed through hirzel_hash_string_seeded.
+ */
+
+#define HIRZEL_HASH_DEFAULT_SEED 0xa0761d6478bd642full
+
+static const uint64_t hirzel_hash_secret[4] = {
+	0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+	0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+static inline void hirzel_hash_mum(uint64_t *a, uint64_t *b)
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t product = (__uint128_t)*a * *b;
+
+	*a = (uint64_t)product;
+	*b = (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	*a = _umul128(*a, *b, b);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32;
+	uint64_t la = (uint32_t)*a, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32);
+	uint64_t carry = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+
+	carry += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+static inline uint64_t hirzel_hash_fold(uint64_t a, uint64_t b)
+{
+	hirzel_hash_mum(&a, &b);
+
+	return a ^ b;
+}
+
+static inline uint64_t hirzel_hash_read64(const uint8_t *p)
+{
+	uint64_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static inline uint64_t hirzel_hash_read32(const uint8_t *p)
+{
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static inline uint64_t hirzel_hash_bytes(const void *data, size_t length, uint64_t seed)
+{
+	const uint8_t *p = data;
+	const uint64_t *secret = hirzel_hash_secret;
+	uint64_t a, b;
+
+	seed ^= hirzel_hash_fold(seed ^ secret[0], secret[1]);
+
+	if (length <= 16)
+	{
+		if (length >= 4)
+		{
+			size_t offset = (length >> 3) << 2;
+
+			a = (hirzel_hash_read32(p) << 32) | hirzel_hash_read32(p + offset);
+			b = (hirzel_hash_read32(p + length - 4) << 32) | hirzel_hash_read32(p + length - 4 - offset);
+		}
+		else if (length > 0)
+		{
+			a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+			b = 0;
+		}
+		else
+		{
+			a = b = 0;
+		}
+	}
+	else
+	{
+		size_t i = length;
+
+		if (i > 48)
+		{
+			uint64_t see1 = seed, see2 = seed;
+
+			do
+			{
+				seed = hirzel_hash_fold(hirzel_hash_read64(p) ^ secret[1], hirzel_hash_read64(p + 8) ^ seed);
+				see1 = hirzel_hash_fold(hirzel_hash_read64(p + 16) ^ secret[2], hirzel_hash_read64(p + 24) ^ see1);
+				see2 = hirzel_hash_fold(hirzel_hash_read64(p + 32) ^ secret[3], hirzel_hash_read64(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			}
+			while (i > 48);
+
+			seed ^= see1 ^ see2;
+		}
+
+		while (i > 16)
+		{
+			seed = hirzel_hash_fold(hirzel_hash_read64(p) ^ secret[1], hirzel_hash_read64(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+
+		a = hirzel_hash_read64(p + i - 16);
+		b = hirzel_hash_read64(p + i - 8);
+	}
+
+	a ^= secret[1];
+	b ^= seed;
+	hirzel_hash_mum(&a, &b);
+
+	return hirzel_hash_fold(a ^ secret[0] ^ length, b ^ secret[1]);
+}
+
+static inline size_t hirzel_hash_string_seeded(const char *string, uint64_t seed)
+{
+	return (size_t)hirzel_hash_bytes(string, strlen(string), seed);
+}
+
+static inline size_t hirzel_hash_string(const char *string)
+{
+	return hirzel_hash_string_seeded(string, HIRZEL_HASH_DEFAULT_SEED);
+}
+
+// MurmurHash3's fmix64 finalizer for hashes of unknown quality, after which a
+// flipped input bit flips each output bit with probability close to one half
+static inline uint64_t hirzel_hash_mix(uint64_t hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ull;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+#endif
@@ -0,0 +1,314 @@
+#ifndef HIRZEL_MAP_H
+#define HIRZEL_MAP_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include <hirzel/hash.h>
+
+/*
+ * Hash map with keys of any type stored inline in its slots. HASH(key) must
+ * evaluate to a size_t for a KEY value and EQ(a, b) to true when two KEY values
+ * are equal; both are expanded in place, so they may be macros. Capacities are
+ * powers of two probed triangularly, and HASH is mixed before indexing.
+ *
+ *	HIRZEL_MAP_DECLARE(int, float, IntFloatMap, HIRZEL_MAP_INT_HASH, HIRZEL_MAP_INT_EQ)
+ *	HIRZEL_MAP_DEFINE(int, float, IntFloatMap, HIRZEL_MAP_INT_HASH, HIRZEL_MAP_INT_EQ)
+ */
+
+#define HIRZEL_MAP_EMPTY 0
+#define HIRZEL_MAP_FULL 1
+#define HIRZEL_MAP_DELETED 2
+
+#define HIRZEL_MAP_MIN_CAPACITY 16
+
+// integer and pointer keys: no allocation, no indirection
+#define HIRZEL_MAP_INT_HASH(key) ((size_t)(uint64_t)(key))
+#define HIRZEL_MAP_INT_EQ(a, b) ((a) == (b))
+#define HIRZEL_MAP_PTR_HASH(key) ((size_t)(uintptr_t)(key))
+#define HIRZEL_MAP_PTR_EQ(a, b) ((a) == (b))
+
+#define HIRZEL_MAP_DECLARE(KEY, VALUE, NAME, HASH, EQ)\
+\
+typedef struct __##NAME##Slot\
+{\
+	KEY key;\
+	VALUE value;\
+	uint8_t state;\
+} NAME##Slot;\
+\
+typedef struct __##NAME\
+{\
+	NAME##Slot *slots;\
+	size_t capacity;\
+	size_t count;\
+	size_t deleted_count;\
+} NAME;\
+\
+bool NAME##_init(NAME *map);\
+void NAME##_free(NAME *map);\
+bool NAME##_reserve(NAME *map, size_t min_count);\
+bool NAME##_shrink(NAME *map);\
+bool NAME##_set(NAME *map, KEY key, VALUE value);\
+bool NAME##_set_ptr(NAME *map, const KEY *key, const VALUE *value);\
+void NAME##_erase(NAME *map, KEY key);\
+void NAME##_clear(NAME *map);\
+bool NAME##_get(const NAME *map, VALUE *out, KEY key);\
+VALUE *NAME##_get_ptr(const NAME *map, KEY key);\
+bool NAME##_contains(const NAME *map, KEY key);\
+size_t NAME##_size(const NAME *map);\
+bool NAME##_is_empty(const NAME *map);
+
+
+#define HIRZEL_MAP_DEFINE(KEY, VALUE, NAME, HASH, EQ)\
+\
+static size_t NAME##_max_load(size_t capacity)\
+{\
+	return capacity / 4 * 3;\
+}\
+\
+static size_t NAME##_get_min_capacity(size_t count)\
+{\
+	size_t capacity = HIRZEL_MAP_MIN_CAPACITY;\
+\
+	while (NAME##_max_load(capacity) < count)\
+		capacity *= 2;\
+\
+	return capacity;\
+}\
+\
+static size_t NAME##_hash(KEY key)\
+{\
+	return (size_t)hirzel_hash_mix((uint64_t)HASH(key));\
+}\
+\
+static NAME##Slot *NAME##_find_slot(const NAME *map, KEY key)\
+{\
+	assert(map != NULL);\
+\
+	size_t mask = map->capacity - 1;\
+	size_t i = NAME##_hash(key) & mask;\
+	size_t step = 0;\
+\
+	while (true)\
+	{\
+		NAME##Slot *slot = map->slots + i;\
+\
+		if (slot->state == HIRZEL_MAP_EMPTY)\
+			return NULL;\
+\
+		if (slot->state == HIRZEL_MAP_FULL && EQ(slot->key, key))\
+			return slot;\
+\
+		step += 1;\
+		i = (i + step) & mask;\
+	}\
+}\
+\
+/* first empty or deleted slot in the probe sequence, for keys known to be absent */\
+static NAME##Slot *NAME##_find_free_slot(const NAME *map, size_t hash)\
+{\
+	assert(map != NULL);\
+\
+	size_t mask = map->capacity - 1;\
+	size_t i = hash & mask;\
+	size_t step = 0;\
+\
+	while (map->slots[i].state == HIRZEL_MAP_FULL)\
+	{\
+		step += 1;\
+		i = (i + step) & mask;\
+	}\
+\
+	return map->slots + i;\
+}\
+\
+static bool NAME##_rehash(NAME *map, size_t new_capacity)\
+{\
+	assert(map != NULL);\
+	assert((new_capacity & (new_capacity - 1)) == 0);\
+	assert(NAME##_max_load(new_capacity) >= map->count);\
+\
+	NAME##Slot *new_slots = calloc(new_capacity, sizeof(NAME##Slot));\
+\
+	if (!new_slots)\
+		return false;\
+\
+	NAME old = *map;\
+\
+	map->slots = new_slots;\
+	map->capacity = new_capacity;\
+	map->deleted_count = 0;\
+\
+	for (size_t i = 0; i < old.capacity; ++i)\
+	{\
+		if (old.slots[i].state != HIRZEL_MAP_FULL)\
+			continue;\
+\
+		*NAME##_find_free_slot(map, NAME##_hash(old.slots[i].key)) = old.slots[i];\
+	}\
+\
+	free(old.slots);\
+\
+	return true;\
+}\
+\
+bool NAME##_init(NAME *map)\
+{\
+	assert(map != NULL);\
+\
+	*map = (NAME) { NULL, 0, 0, 0 };\
+\
+	return NAME##_rehash(map, HIRZEL_MAP_MIN_CAPACITY);\
+}\
+\
+void NAME##_free(NAME *map)\
+{\
+	assert(map != NULL);\
+\
+	free(map->slots);\
+}\
+\
+bool NAME##_reserve(NAME *map, size_t min_count)\
+{\
+	assert(map != NULL);\
+\
+	size_t capacity = NAME##_get_min_capacity(min_count);\
+\
+	if (capacity <= map->capacity)\
+		return true;\
+\
+	return NAME##_rehash(map, capacity);\
+}\
+\
+bool NAME##_shrink(NAME *map)\
+{\
+	assert(map != NULL);\
+\
+	size_t capacity = NAME##_get_min_capacity(map->count);\
+\
+	if (capacity >= map->capacity)\
+		return true;\
+\
+	return NAME##_rehash(map, capacity);\
+}\
+\
+bool NAME##_set_ptr(NAME *map, const KEY *key, const VALUE *value)\
+{\
+	assert(map != NULL);\
+	assert(key != NULL);\
+	assert(value != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(map, *key);\
+\
+	if (slot)\
+	{\
+		slot->value = *value;\
+		return true;\
+	}\
+\
+	if (map->count + map->deleted_count + 1 > NAME##_max_load(map->capacity))\
+	{\
+		/* mostly tombstones: clean up in place instead of growing */\
+		size_t new_capacity = map->count + 1 > NAME##_max_load(map->capacity) / 2\
+			? map->capacity * 2\
+			: map->capacity;\
+\
+		if (!NAME##_rehash(map, new_capacity))\
+			return false;\
+	}\
+\
+	slot = NAME##_find_free_slot(map, NAME##_hash(*key));\
+\
+	if (slot->state == HIRZEL_MAP_DELETED)\
+		map->deleted_count -= 1;\
+\
+	slot->key = *key;\
+	slot->value = *value;\
+	slot->state = HIRZEL_MAP_FULL;\
+	map->count += 1;\
+\
+	return true;\
+}\
+\
+bool NAME##_set(NAME *map, KEY key, VALUE value)\
+{\
+	return NAME##_set_ptr(map, &key, &value);\
+}\
+\
+bool NAME##_get(const NAME *map, VALUE *out, KEY key)\
+{\
+	assert(map != NULL);\
+	assert(out != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(map, key);\
+\
+	if (!slot)\
+		return false;\
+\
+	*out = slot->value;\
+\
+	return true;\
+}\
+\
+VALUE *NAME##_get_ptr(const NAME *map, KEY key)\
+{\
+	assert(map != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(map, key);\
+\
+	return slot != NULL\
+		? &slot->value\
+		: NULL;\
+}\
+\
+bool NAME##_contains(const NAME *map, KEY key)\
+{\
+	assert(map != NULL);\
+\
+	return NAME##_find_slot(map, key) != NULL;\
+}\
+\
+void NAME##_erase(NAME *map, KEY key)\
+{\
+	assert(map != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(map, key);\
+\
+	if (!slot)\
+		return;\
+\
+	slot->state = HIRZEL_MAP_DELETED;\
+	map->count -= 1;\
+	map->deleted_count += 1;\
+}\
+\
+void NAME##_clear(NAME *map)\
+{\
+	assert(map != NULL);\
+\
+	for (size_t i = 0; i < map->capacity; ++i)\
+		map->slots[i].state = HIRZEL_MAP_EMPTY;\
+\
+	map->count = 0;\
+	map->deleted_count = 0;\
+}\
+\
+size_t NAME##_size(const NAME *map)\
+{\
+	assert(map != NULL);\
+\
+	return map->capacity;\
+}\
+\
+bool NAME##_is_empty(const NAME *map)\
+{\
+	assert(map != NULL);\
+\
+	return map->count == 0;\
+}
+
+#endif
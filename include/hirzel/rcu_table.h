@@ -0,0 +1,351 @@
+#ifndef HIRZEL_RCU_TABLE_H
+#define HIRZEL_RCU_TABLE_H
+
+#include <hirzel/table.h>
+#include <hirzel/thread.h>
+
+/*
+ * Read-mostly string keyed hash table. Readers look keys up in an immutable
+ * version of the table without taking a lock; writers copy the current
+ * version, change the copy and publish it with a single pointer store. Old
+ * versions are freed once every reader that could still see them has left its
+ * read section, tracked with per-reader epochs.
+ *
+ * Each reading thread registers once for a reader slot and brackets its
+ * lookups with read_lock / read_unlock. Entering costs one sequentially
+ * consistent store on the reader's own cache line and leaving one release
+ * store, with the full fence on the writer's side, and pointers from the
+ * version it returns stay valid until read_unlock. Read sections must not
+ * nest or span a write on the same thread, since a writer waits for every
+ * reader to move on.
+ *
+ * Every write copies the whole table, costing O(n) however few keys change, so
+ * changes should be batched with set_batch or between write_begin and
+ * write_commit where possible.
+ *
+ *	HIRZEL_RCU_TABLE_DECLARE(int, RouteTable)
+ *	HIRZEL_RCU_TABLE_DEFINE(int, RouteTable)
+ */
+
+#define HIRZEL_RCU_TABLE_DEFAULT_READERS 128
+
+#define HIRZEL_RCU_TABLE_DECLARE(TYPE, NAME)\
+\
+HIRZEL_TABLE_DECLARE(TYPE, NAME##Version)\
+\
+typedef struct __##NAME##Reader\
+{\
+	volatile size_t epoch;\
+	volatile size_t is_used;\
+	char padding[HIRZEL_CACHE_LINE];\
+} NAME##Reader;\
+\
+typedef struct __##NAME\
+{\
+	NAME##Version *volatile current;\
+	NAME##Reader *readers;\
+	size_t reader_count;\
+	volatile size_t epoch;\
+	HirzelRwLock write_lock;\
+} NAME;\
+\
+bool NAME##_init(NAME *table, size_t reader_count);\
+void NAME##_free(NAME *table);\
+NAME##Reader *NAME##_reader_register(NAME *table);\
+void NAME##_reader_unregister(NAME *table, NAME##Reader *reader);\
+const NAME##Version *NAME##_read_lock(NAME *table, NAME##Reader *reader);\
+void NAME##_read_unlock(NAME *table, NAME##Reader *reader);\
+bool NAME##_get(NAME *table, NAME##Reader *reader, TYPE *out, const char *key);\
+bool NAME##_contains(NAME *table, NAME##Reader *reader, const char *key);\
+NAME##Version *NAME##_write_begin(NAME *table);\
+void NAME##_write_commit(NAME *table, NAME##Version *version);\
+void NAME##_write_abort(NAME *table, NAME##Version *version);\
+bool NAME##_set(NAME *table, const char *key, TYPE value);\
+bool NAME##_set_batch(NAME *table, const char *const *keys, const TYPE *values, size_t count);\
+bool NAME##_erase(NAME *table, const char *key);
+
+
+#define HIRZEL_RCU_TABLE_DEFINE(TYPE, NAME)\
+\
+HIRZEL_TABLE_DEFINE_POW2(TYPE, NAME##Version)\
+\
+static void NAME##_destroy_version(NAME##Version *version)\
+{\
+	NAME##Version_free(version);\
+	free(version);\
+}\
+\
+/* private copy of a version, reusing its stored hashes */\
+static NAME##Version *NAME##_clone(const NAME##Version *from)\
+{\
+	assert(from != NULL);\
+\
+	NAME##Version *version = malloc(sizeof(NAME##Version));\
+\
+	if (!version)\
+		return NULL;\
+\
+	if (!NAME##Version_init_arena(version))\
+	{\
+		free(version);\
+		return NULL;\
+	}\
+\
+	version->hash_function = from->hash_function;\
+\
+	if (!NAME##Version_reserve(version, from->count))\
+	{\
+		NAME##_destroy_version(version);\
+		return NULL;\
+	}\
+\
+	size_t i = 0;\
+	const NAME##VersionNode *node;\
+\
+	while ((node = NAME##Version_next_node(from, &i)))\
+	{\
+		NAME##VersionNode *copy = NAME##Version_insert_node(version, node->key, node->key_length, node->hash);\
+\
+		if (!copy)\
+		{\
+			NAME##_destroy_version(version);\
+			return NULL;\
+		}\
+\
+		copy->value = node->value;\
+	}\
+\
+	return version;\
+}\
+\
+/* waits until no reader can still be using a version unpublished before this call */\
+static void NAME##_synchronize(NAME *table)\
+{\
+	size_t epoch = table->epoch + 1;\
+\
+	hirzel_atomic_store(&table->epoch, epoch);\
+	hirzel_atomic_fence();\
+\
+	for (size_t i = 0; i < table->reader_count; ++i)\
+	{\
+		while (true)\
+		{\
+			size_t reader_epoch = hirzel_atomic_load(&table->readers[i].epoch);\
+\
+			if (reader_epoch == 0 || reader_epoch >= epoch)\
+				break;\
+\
+			hirzel_thread_yield();\
+		}\
+	}\
+}\
+\
+bool NAME##_init(NAME *table, size_t reader_count)\
+{\
+	assert(table != NULL);\
+\
+	if (reader_count == 0)\
+		reader_count = HIRZEL_RCU_TABLE_DEFAULT_READERS;\
+\
+	NAME##Version *version = malloc(sizeof(NAME##Version));\
+	NAME##Reader *readers = calloc(reader_count, sizeof(NAME##Reader));\
+\
+	if (!version || !readers || !NAME##Version_init_arena(version))\
+	{\
+		free(version);\
+		free(readers);\
+		return false;\
+	}\
+\
+	table->current = version;\
+	table->readers = readers;\
+	table->reader_count = reader_count;\
+	table->epoch = 1;\
+\
+	if (!hirzel_rwlock_init(&table->write_lock))\
+	{\
+		NAME##_destroy_version(version);\
+		free(readers);\
+		return false;\
+	}\
+\
+	return true;\
+}\
+\
+/* there must be no readers or writers left */\
+void NAME##_free(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	NAME##_destroy_version(table->current);\
+	free(table->readers);\
+	hirzel_rwlock_destroy(&table->write_lock);\
+}\
+\
+NAME##Reader *NAME##_reader_register(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	for (size_t i = 0; i < table->reader_count; ++i)\
+	{\
+		if (hirzel_atomic_claim(&table->readers[i].is_used))\
+			return table->readers + i;\
+	}\
+\
+	return NULL;\
+}\
+\
+void NAME##_reader_unregister(NAME *table, NAME##Reader *reader)\
+{\
+	assert(table != NULL);\
+	assert(reader != NULL);\
+	assert(reader->epoch == 0);\
+\
+	(void)table;\
+	hirzel_atomic_store(&reader->is_used, 0);\
+}\
+\
+const NAME##Version *NAME##_read_lock(NAME *table, NAME##Reader *reader)\
+{\
+	assert(table != NULL);\
+	assert(reader != NULL);\
+	assert(reader->epoch == 0);\
+\
+	/* both accesses are sequentially consistent, as is the writer's fence in\
+	 * synchronize, so a writer either sees this epoch or this reader sees its\
+	 * new version */\
+	hirzel_atomic_store_seq_cst(&reader->epoch, hirzel_atomic_load(&table->epoch));\
+\
+	return hirzel_atomic_load_ptr_seq_cst((void *volatile *)&table->current);\
+}\
+\
+void NAME##_read_unlock(NAME *table, NAME##Reader *reader)\
+{\
+	assert(table != NULL);\
+	assert(reader != NULL);\
+\
+	(void)table;\
+	hirzel_atomic_store(&reader->epoch, 0);\
+}\
+\
+bool NAME##_get(NAME *table, NAME##Reader *reader, TYPE *out, const char *key)\
+{\
+	assert(out != NULL);\
+	assert(key != NULL);\
+\
+	const NAME##Version *version = NAME##_read_lock(table, reader);\
+	bool is_found = NAME##Version_get(version, out, key);\
+\
+	NAME##_read_unlock(table, reader);\
+\
+	return is_found;\
+}\
+\
+bool NAME##_contains(NAME *table, NAME##Reader *reader, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	const NAME##Version *version = NAME##_read_lock(table, reader);\
+	bool contains_key = NAME##Version_contains(version, key);\
+\
+	NAME##_read_unlock(table, reader);\
+\
+	return contains_key;\
+}\
+\
+/* a copy of the current version, holding off other writers until committed or aborted */\
+NAME##Version *NAME##_write_begin(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	hirzel_rwlock_write(&table->write_lock);\
+\
+	NAME##Version *version = NAME##_clone(table->current);\
+\
+	if (!version)\
+		hirzel_rwlock_write_unlock(&table->write_lock);\
+\
+	return version;\
+}\
+\
+void NAME##_write_commit(NAME *table, NAME##Version *version)\
+{\
+	assert(table != NULL);\
+	assert(version != NULL);\
+\
+	NAME##Version *old = table->current;\
+\
+	hirzel_atomic_store_ptr((void *volatile *)&table->current, version);\
+	NAME##_synchronize(table);\
+	NAME##_destroy_version(old);\
+\
+	hirzel_rwlock_write_unlock(&table->write_lock);\
+}\
+\
+void NAME##_write_abort(NAME *table, NAME##Version *version)\
+{\
+	assert(table != NULL);\
+	assert(version != NULL);\
+\
+	NAME##_destroy_version(version);\
+	hirzel_rwlock_write_unlock(&table->write_lock);\
+}\
+\
+bool NAME##_set(NAME *table, const char *key, TYPE value)\
+{\
+	assert(key != NULL);\
+\
+	NAME##Version *version = NAME##_write_begin(table);\
+\
+	if (!version)\
+		return false;\
+\
+	if (!NAME##Version_set(version, key, value))\
+	{\
+		NAME##_write_abort(table, version);\
+		return false;\
+	}\
+\
+	NAME##_write_commit(table, version);\
+\
+	return true;\
+}\
+\
+/* sets every key in one copy of the table, committing none of them on failure */\
+bool NAME##_set_batch(NAME *table, const char *const *keys, const TYPE *values, size_t count)\
+{\
+	assert(keys != NULL);\
+	assert(values != NULL);\
+\
+	NAME##Version *version = NAME##_write_begin(table);\
+\
+	if (!version)\
+		return false;\
+\
+	if (!NAME##Version_set_batch(version, keys, values, count))\
+	{\
+		NAME##_write_abort(table, version);\
+		return false;\
+	}\
+\
+	NAME##_write_commit(table, version);\
+\
+	return true;\
+}\
+\
+bool NAME##_erase(NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	NAME##Version *version = NAME##_write_begin(table);\
+\
+	if (!version)\
+		return false;\
+\
+	NAME##Version_erase(version, key);\
+	NAME##_write_commit(table, version);\
+\
+	return true;\
+}
+
+#endif
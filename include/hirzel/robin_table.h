@@ -0,0 +1,431 @@
+#ifndef HIRZEL_ROBIN_TABLE_H
+#define HIRZEL_ROBIN_TABLE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include <hirzel/hash.h>
+
+/*
+ * String keyed hash table with the same interface as HIRZEL_TABLE, using
+ * Robin Hood linear probing. Each slot records its distance from the key's home
+ * slot, and an insert takes the place of any key closer to home than itself,
+ * which keeps probe lengths short and even. Erasing shifts the following keys
+ * back one slot instead of leaving a tombstone, so heavy insert / erase churn
+ * never degrades lookups or forces a resize.
+ *
+ * Pointers returned by get_ptr are invalidated by any set or erase, as both
+ * move other keys.
+ */
+
+#define HIRZEL_ROBIN_TABLE_MIN_CAPACITY 16
+
+#define HIRZEL_ROBIN_TABLE_DECLARE(TYPE, NAME)\
+\
+typedef struct __##NAME##Slot\
+{\
+	char *key;\
+	size_t key_length;\
+	size_t hash;\
+	TYPE value;\
+	uint32_t distance;\
+} NAME##Slot;\
+\
+typedef struct __##NAME\
+{\
+	NAME##Slot *slots;\
+	size_t(*hash_function)(const char*, size_t);\
+	size_t capacity;\
+	size_t count;\
+} NAME;\
+\
+bool NAME##_init(NAME *table);\
+void NAME##_free(NAME *table);\
+bool NAME##_reserve(NAME *table, size_t min_count);\
+bool NAME##_shrink(NAME *table);\
+bool NAME##_set(NAME *table, const char* key, TYPE value);\
+bool NAME##_set_ptr(NAME *table, const char* key, const TYPE *value);\
+bool NAME##_set_n(NAME *table, const char* key, size_t length, TYPE value);\
+bool NAME##_set_ptr_n(NAME *table, const char* key, size_t length, const TYPE *value);\
+void NAME##_erase(NAME *table, const char *key);\
+void NAME##_erase_n(NAME *table, const char *key, size_t length);\
+void NAME##_clear(NAME *table);\
+bool NAME##_swap(NAME *table, const char *a, const char *b);\
+bool NAME##_get(const NAME *table, TYPE *out, const char *key);\
+bool NAME##_get_n(const NAME *table, TYPE *out, const char *key, size_t length);\
+TYPE *NAME##_get_ptr(const NAME *table, const char *key);\
+TYPE *NAME##_get_ptr_n(const NAME *table, const char *key, size_t length);\
+bool NAME##_contains(const NAME *table, const char *key);\
+bool NAME##_contains_n(const NAME *table, const char *key, size_t length);\
+size_t NAME##_size(const NAME *table);\
+bool NAME##_is_empty(const NAME *table);\
+size_t NAME##_hash_string(const char *key);\
+size_t NAME##_hash_bytes(const char *key, size_t length);
+
+
+#define HIRZEL_ROBIN_TABLE_DEFINE(TYPE, NAME)\
+\
+static size_t NAME##_max_load(size_t capacity)\
+{\
+	return capacity - capacity / 8;\
+}\
+\
+static size_t NAME##_get_min_capacity(size_t count)\
+{\
+	size_t capacity = HIRZEL_ROBIN_TABLE_MIN_CAPACITY;\
+\
+	while (NAME##_max_load(capacity) < count)\
+		capacity *= 2;\
+\
+	return capacity;\
+}\
+\
+static size_t NAME##_hash(const NAME *table, const char *key, size_t length)\
+{\
+	return (size_t)hirzel_hash_mix(table->hash_function(key, length));\
+}\
+\
+/* a distance of 0 marks an empty slot, so a key in its home slot has distance 1 */\
+static NAME##Slot *NAME##_find_slot(const NAME *table, const char *key, size_t length, size_t hash)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	size_t mask = table->capacity - 1;\
+	size_t i = hash & mask;\
+	uint32_t distance = 1;\
+\
+	while (true)\
+	{\
+		NAME##Slot *slot = table->slots + i;\
+\
+		/* the key would have displaced any slot closer to home than itself */\
+		if (slot->distance < distance)\
+			return NULL;\
+\
+		if (slot->hash == hash && slot->key_length == length && !memcmp(slot->key, key, length))\
+			return slot;\
+\
+		distance += 1;\
+		i = (i + 1) & mask;\
+	}\
+}\
+\
+/* inserts a slot whose key is known to be absent */\
+static void NAME##_place(NAME *table, NAME##Slot entry)\
+{\
+	assert(table != NULL);\
+	assert(table->count < table->capacity);\
+\
+	size_t mask = table->capacity - 1;\
+	size_t i = entry.hash & mask;\
+\
+	entry.distance = 1;\
+\
+	while (true)\
+	{\
+		NAME##Slot *slot = table->slots + i;\
+\
+		if (slot->distance == 0)\
+		{\
+			*slot = entry;\
+			return;\
+		}\
+\
+		if (slot->distance < entry.distance)\
+		{\
+			NAME##Slot displaced = *slot;\
+			*slot = entry;\
+			entry = displaced;\
+		}\
+\
+		entry.distance += 1;\
+		i = (i + 1) & mask;\
+	}\
+}\
+\
+static bool NAME##_rehash(NAME *table, size_t new_capacity)\
+{\
+	assert(table != NULL);\
+	assert((new_capacity & (new_capacity - 1)) == 0);\
+	assert(NAME##_max_load(new_capacity) >= table->count);\
+\
+	NAME##Slot *new_slots = calloc(new_capacity, sizeof(NAME##Slot));\
+\
+	if (!new_slots)\
+		return false;\
+\
+	NAME old = *table;\
+\
+	table->slots = new_slots;\
+	table->capacity = new_capacity;\
+\
+	for (size_t i = 0; i < old.capacity; ++i)\
+	{\
+		if (old.slots[i].distance > 0)\
+			NAME##_place(table, old.slots[i]);\
+	}\
+\
+	free(old.slots);\
+\
+	return true;\
+}\
+\
+bool NAME##_init(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	*table = (NAME) { NULL, NAME##_hash_bytes, 0, 0 };\
+\
+	return NAME##_rehash(table, HIRZEL_ROBIN_TABLE_MIN_CAPACITY);\
+}\
+\
+void NAME##_free(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	for (size_t i = 0; i < table->capacity; ++i)\
+		free(table->slots[i].key);\
+\
+	free(table->slots);\
+}\
+\
+bool NAME##_reserve(NAME *table, size_t min_count)\
+{\
+	assert(table != NULL);\
+\
+	size_t capacity = NAME##_get_min_capacity(min_count);\
+\
+	if (capacity <= table->capacity)\
+		return true;\
+\
+	return NAME##_rehash(table, capacity);\
+}\
+\
+bool NAME##_shrink(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	size_t capacity = NAME##_get_min_capacity(table->count);\
+\
+	if (capacity >= table->capacity)\
+		return true;\
+\
+	return NAME##_rehash(table, capacity);\
+}\
+\
+bool NAME##_set_ptr_n(NAME *table, const char* key, size_t length, const TYPE *value)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+	assert(value != NULL);\
+\
+	size_t hash = NAME##_hash(table, key, length);\
+	NAME##Slot *slot = NAME##_find_slot(table, key, length, hash);\
+\
+	if (slot)\
+	{\
+		slot->value = *value;\
+		return true;\
+	}\
+\
+	if (table->count + 1 > NAME##_max_load(table->capacity) && !NAME##_rehash(table, table->capacity * 2))\
+		return false;\
+\
+	char *key_buffer = malloc(length + 1);\
+\
+	if (!key_buffer)\
+		return false;\
+\
+	memcpy(key_buffer, key, length);\
+	key_buffer[length] = '\0';\
+\
+	NAME##_place(table, (NAME##Slot) { key_buffer, length, hash, *value, 0 });\
+	table->count += 1;\
+\
+	return true;\
+}\
+\
+bool NAME##_set_ptr(NAME *table, const char* key, const TYPE *value)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_set_ptr_n(table, key, strlen(key), value);\
+}\
+\
+bool NAME##_set_n(NAME *table, const char *key, size_t length, TYPE value)\
+{\
+	return NAME##_set_ptr_n(table, key, length, &value);\
+}\
+\
+bool NAME##_set(NAME *table, const char *key, TYPE value)\
+{\
+	return NAME##_set_ptr(table, key, &value);\
+}\
+\
+bool NAME##_get_n(const NAME *table, TYPE *out, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(out != NULL);\
+	assert(key != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(table, key, length, NAME##_hash(table, key, length));\
+\
+	if (!slot)\
+		return false;\
+\
+	*out = slot->value;\
+\
+	return true;\
+}\
+\
+bool NAME##_get(const NAME *table, TYPE *out, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_get_n(table, out, key, strlen(key));\
+}\
+\
+TYPE *NAME##_get_ptr_n(const NAME *table, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(table, key, length, NAME##_hash(table, key, length));\
+\
+	return slot != NULL\
+		? &slot->value\
+		: NULL;\
+}\
+\
+TYPE *NAME##_get_ptr(const NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_get_ptr_n(table, key, strlen(key));\
+}\
+\
+bool NAME##_contains_n(const NAME *table, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	return NAME##_find_slot(table, key, length, NAME##_hash(table, key, length)) != NULL;\
+}\
+\
+bool NAME##_contains(const NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_contains_n(table, key, strlen(key));\
+}\
+\
+void NAME##_erase_n(NAME *table, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(table, key, length, NAME##_hash(table, key, length));\
+\
+	if (!slot)\
+		return;\
+\
+	free(slot->key);\
+\
+	/* backward shift: pull each following displaced key one slot closer to home */\
+	size_t mask = table->capacity - 1;\
+	size_t i = (size_t)(slot - table->slots);\
+	size_t next = (i + 1) & mask;\
+\
+	while (table->slots[next].distance > 1)\
+	{\
+		table->slots[i] = table->slots[next];\
+		table->slots[i].distance -= 1;\
+		i = next;\
+		next = (i + 1) & mask;\
+	}\
+\
+	table->slots[i].key = NULL;\
+	table->slots[i].distance = 0;\
+	table->count -= 1;\
+}\
+\
+void NAME##_erase(NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	NAME##_erase_n(table, key, strlen(key));\
+}\
+\
+void NAME##_clear(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	for (size_t i = 0; i < table->capacity; ++i)\
+	{\
+		free(table->slots[i].key);\
+		table->slots[i].key = NULL;\
+		table->slots[i].distance = 0;\
+	}\
+\
+	table->count = 0;\
+}\
+\
+bool NAME##_swap(NAME *table, const char *key_a, const char *key_b)\
+{\
+	assert(table != NULL);\
+	assert(key_a != NULL);\
+	assert(key_b != NULL);\
+\
+	size_t length_a = strlen(key_a);\
+	NAME##Slot *slot_a = NAME##_find_slot(table, key_a, length_a, NAME##_hash(table, key_a, length_a));\
+\
+	if (!slot_a)\
+		return false;\
+\
+	size_t length_b = strlen(key_b);\
+	NAME##Slot *slot_b = NAME##_find_slot(table, key_b, length_b, NAME##_hash(table, key_b, length_b));\
+\
+	if (!slot_b)\
+		return false;\
+\
+	TYPE tmp = slot_a->value;\
+	slot_a->value = slot_b->value;\
+	slot_b->value = tmp;\
+\
+	return true;\
+}\
+\
+size_t NAME##_size(const NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	return table->capacity;\
+}\
+\
+bool NAME##_is_empty(const NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	return table->count == 0;\
+}\
+\
+size_t NAME##_hash_string(const char *string)\
+{\
+	assert(string != NULL);\
+\
+	return hirzel_hash_string(string);\
+}\
+\
+size_t NAME##_hash_bytes(const char *key, size_t length)\
+{\
+	assert(key != NULL);\
+\
+	return (size_t)hirzel_hash_bytes(key, length, HIRZEL_HASH_DEFAULT_SEED);\
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef HIRZEL_SET_H
+#define HIRZEL_SET_H
+
+#include <hirzel/table.h>
+
+/*
+ * Set of string keys on the probing core of hirzel/table.h. Nodes hold only a
+ * key and its hash, and the table functions that don't touch values (reserve,
+ * erase, contains, clear, ...) are shared with HIRZEL_TABLE.
+ *
+ * The bulk operations write into an initialized set distinct from their inputs,
+ * clearing it first and reserving room for the result up front. Nodes carry
+ * their hash, so keys move between sets with the same hash_function without
+ * being hashed again.
+ *
+ *	HIRZEL_SET_DECLARE(StringSet)
+ *	HIRZEL_SET_DEFINE(StringSet)
+ */
+
+#define HIRZEL_SET_DECLARE(NAME)\
+\
+HIRZEL_TABLE_CORE_DECLARE(NAME, )\
+\
+bool NAME##_insert(NAME *set, const char *key);\
+bool NAME##_insert_n(NAME *set, const char *key, size_t length);\
+bool NAME##_union(NAME *out, const NAME *a, const NAME *b);\
+bool NAME##_intersection(NAME *out, const NAME *a, const NAME *b);\
+bool NAME##_difference(NAME *out, const NAME *a, const NAME *b);
+
+#define HIRZEL_SET_DEFINE(NAME) HIRZEL_SET_DEFINE_SIZING(NAME, HIRZEL_TABLE_PRIME)
+#define HIRZEL_SET_DEFINE_POW2(NAME) HIRZEL_SET_DEFINE_SIZING(NAME, HIRZEL_TABLE_POW2)
+
+#define HIRZEL_SET_DEFINE_SIZING(NAME, SIZING)\
+\
+HIRZEL_TABLE_CORE_DEFINE(NAME, SIZING)\
+\
+bool NAME##_insert_n(NAME *set, const char *key, size_t length)\
+{\
+	assert(set != NULL);\
+	assert(key != NULL);\
+\
+	return NAME##_insert_node(set, key, length, NAME##_hash(set, key, length)) != NULL;\
+}\
+\
+bool NAME##_insert(NAME *set, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_insert_n(set, key, strlen(key));\
+}\
+\
+/* hash of a node from another set, reused when both sets hash alike */\
+static size_t NAME##_node_hash(const NAME *set, const NAME *from, const NAME##Node *node)\
+{\
+	return set->hash_function == from->hash_function\
+		? node->hash\
+		: NAME##_hash(set, node->key, node->key_length);\
+}\
+\
+static bool NAME##_contains_node(const NAME *set, const NAME *from, const NAME##Node *node)\
+{\
+	size_t hash = NAME##_node_hash(set, from, node);\
+\
+	return NAME##_find_node_hashed(set, node->key, node->key_length, hash)->key != NULL;\
+}\
+\
+static bool NAME##_insert_from(NAME *set, const NAME *from, const NAME##Node *node)\
+{\
+	size_t hash = NAME##_node_hash(set, from, node);\
+\
+	return NAME##_insert_node(set, node->key, node->key_length, hash) != NULL;\
+}\
+\
+/* clears out and grows it to hold count keys, never shrinking it */\
+static bool NAME##_prepare_output(NAME *out, size_t count)\
+{\
+	NAME##_clear(out);\
+\
+	size_t size_index = NAME##_get_min_size_index(count);\
+\
+	if (size_index <= out->size_index)\
+		return true;\
+\
+	return NAME##_resize(out, size_index);\
+}\
+\
+bool NAME##_union(NAME *out, const NAME *a, const NAME *b)\
+{\
+	assert(out != NULL);\
+	assert(a != NULL);\
+	assert(b != NULL);\
+	assert(out != a && out != b);\
+\
+	if (!NAME##_prepare_output(out, a->count + b->count))\
+		return false;\
+\
+	const NAME *sets[] = { a, b };\
+\
+	for (size_t s = 0; s < 2; ++s)\
+	{\
+		size_t i = 0;\
+		const NAME##Node *node;\
+\
+		while ((node = NAME##_next_node(sets[s], &i)))\
+		{\
+			if (!NAME##_insert_from(out, sets[s], node))\
+				return false;\
+		}\
+	}\
+\
+	return true;\
+}\
+\
+bool NAME##_intersection(NAME *out, const NAME *a, const NAME *b)\
+{\
+	assert(out != NULL);\
+	assert(a != NULL);\
+	assert(b != NULL);\
+	assert(out != a && out != b);\
+\
+	const NAME *smaller = a->count <= b->count ? a : b;\
+	const NAME *larger = smaller == a ? b : a;\
+\
+	if (!NAME##_prepare_output(out, smaller->count))\
+		return false;\
+\
+	size_t i = 0;\
+	const NAME##Node *node;\
+\
+	while ((node = NAME##_next_node(smaller, &i)))\
+	{\
+		if (!NAME##_contains_node(larger, smaller, node))\
+			continue;\
+\
+		if (!NAME##_insert_from(out, smaller, node))\
+			return false;\
+	}\
+\
+	return true;\
+}\
+\
+/* every key of a is visited whichever side is smaller, as only a can contribute */\
+bool NAME##_difference(NAME *out, const NAME *a, const NAME *b)\
+{\
+	assert(out != NULL);\
+	assert(a != NULL);\
+	assert(b != NULL);\
+	assert(out != a && out != b);\
+\
+	if (!NAME##_prepare_output(out, a->count))\
+		return false;\
+\
+	size_t i = 0;\
+	const NAME##Node *node;\
+\
+	while ((node = NAME##_next_node(a, &i)))\
+	{\
+		if (NAME##_contains_node(b, a, node))\
+			continue;\
+\
+		if (!NAME##_insert_from(out, a, node))\
+			return false;\
+	}\
+\
+	return true;\
+}
+
+#endif
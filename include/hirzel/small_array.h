@@ -0,0 +1,360 @@
+#ifndef HIRZEL_SMALL_ARRAY_H
+#define HIRZEL_SMALL_ARRAY_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include <hirzel/array.h>
+
+/*
+ * HIRZEL_ARRAY that keeps its first N items inside the struct and only moves
+ * them to the heap once it outgrows them, so arrays that stay short never
+ * allocate. The inline items share their space with the heap pointer, and the
+ * capacity tells which is in use: it is N while the items are inline and more
+ * once they have spilled. NAME##_data gives the items either way, and no
+ * pointer into the struct is kept, so arrays can still be copied by value.
+ * Growth and the default allocator follow HIRZEL_ARRAY_GROWTH and
+ * HIRZEL_ARRAY_ALLOCATOR.
+ *
+ *	HIRZEL_SMALL_ARRAY_DECLARE(int, 8, IntSmallArray)
+ *	HIRZEL_SMALL_ARRAY_DEFINE(int, 8, IntSmallArray)
+ */
+
+#define HIRZEL_SMALL_ARRAY_DECLARE(TYPE, N, NAME)\
+\
+typedef struct __##NAME\
+{\
+	size_t length;\
+	size_t capacity;\
+	const HirzelAllocator *allocator;\
+	union\
+	{\
+		TYPE *heap;\
+		TYPE items[N];\
+	} storage;\
+} NAME;\
+\
+NAME NAME##_init();\
+NAME NAME##_init_allocator(const HirzelAllocator *allocator);\
+void NAME##_free(NAME *array);\
+bool NAME##_reserve(NAME *array, size_t capacity);\
+bool NAME##_resize(NAME *array, size_t length);\
+TYPE *NAME##_push_raw(NAME *array);\
+TYPE *NAME##_push(NAME *array, TYPE item);\
+TYPE *NAME##_push_ptr(NAME *array, const TYPE *item);\
+TYPE *NAME##_pushf_raw(NAME *array);\
+TYPE *NAME##_pushf(NAME *array, TYPE item);\
+TYPE *NAME##_pushf_ptr(NAME *array, const TYPE *item);\
+TYPE *NAME##_insert_raw(NAME *array, size_t pos);\
+TYPE *NAME##_insert(NAME *array, size_t pos, TYPE item);\
+TYPE *NAME##_insert_ptr(NAME *array, size_t pos, const TYPE *item);\
+void NAME##_pop(NAME *array);\
+void NAME##_popf(NAME *array);\
+void NAME##_erase(NAME *array, size_t pos);\
+void NAME##_set(NAME *array, size_t pos, TYPE item);\
+void NAME##_set_ptr(NAME *array, size_t pos, const TYPE *item);\
+void NAME##_swap(NAME *array, size_t a, size_t b);\
+TYPE NAME##_get(NAME *array, size_t i);\
+TYPE *NAME##_get_ptr(NAME *array, size_t i);\
+TYPE NAME##_front(NAME *array);\
+TYPE *NAME##_front_ptr(NAME *array);\
+TYPE NAME##_back(NAME *array);\
+TYPE *NAME##_back_ptr(NAME *array);\
+inline static bool NAME##_is_inline(const NAME *array) { assert(array != NULL); return array->capacity <= (N); }\
+inline static TYPE *NAME##_data(NAME *array) { assert(array != NULL); return array->capacity > (N) ? array->storage.heap : array->storage.items; }\
+inline static void NAME##_clear(NAME *array) { assert(array != NULL); array->length = 0; }\
+inline static bool NAME##_is_empty(NAME *array) { assert(array != NULL); return array->length == 0; }\
+inline static size_t NAME##_length(NAME *array) { assert(array != NULL); return array->length; }\
+inline static size_t NAME##_capacity(NAME *array) { assert(array != NULL); return array->capacity; }
+
+
+#define HIRZEL_SMALL_ARRAY_DEFINE(TYPE, N, NAME)\
+\
+NAME NAME##_init()\
+{\
+	return NAME##_init_allocator(HIRZEL_ARRAY_ALLOCATOR);\
+}\
+\
+NAME NAME##_init_allocator(const HirzelAllocator *allocator)\
+{\
+	NAME array;\
+\
+	array.length = 0;\
+	array.capacity = (N);\
+	array.allocator = allocator;\
+\
+	return array;\
+}\
+\
+/* moves the items to a heap buffer of the given capacity, which must be over N */\
+static bool NAME##_spill(NAME *array, size_t capacity)\
+{\
+	assert(array != NULL);\
+	assert(capacity > (N));\
+\
+	TYPE *heap;\
+\
+	if (NAME##_is_inline(array))\
+	{\
+		heap = hirzel_allocate(array->allocator, capacity * sizeof(TYPE));\
+\
+		if (!heap)\
+			return false;\
+\
+		memcpy(heap, array->storage.items, array->length * sizeof(TYPE));\
+	}\
+	else\
+	{\
+		heap = hirzel_reallocate(array->allocator, array->storage.heap, array->capacity * sizeof(TYPE), capacity * sizeof(TYPE));\
+\
+		if (!heap)\
+			return false;\
+	}\
+\
+	array->storage.heap = heap;\
+	array->capacity = capacity;\
+\
+	return true;\
+}\
+\
+static bool NAME##_grow(NAME *array, size_t min_capacity)\
+{\
+	assert(array != NULL);\
+\
+	size_t capacity = HIRZEL_ARRAY_GROWTH(array->capacity);\
+\
+	if (capacity < min_capacity)\
+		capacity = min_capacity;\
+\
+	return NAME##_spill(array, capacity);\
+}\
+\
+void NAME##_free(NAME *array)\
+{\
+	assert(array != NULL);\
+\
+	if (!NAME##_is_inline(array))\
+		hirzel_deallocate(array->allocator, array->storage.heap, array->capacity * sizeof(TYPE));\
+\
+	array->length = 0;\
+	array->capacity = (N);\
+}\
+\
+/* capacities of N or less bring the items back inline */\
+bool NAME##_reserve(NAME *array, size_t capacity)\
+{\
+	assert(array != NULL);\
+\
+	if (capacity > (N))\
+	{\
+		if (capacity < array->length)\
+			array->length = capacity;\
+\
+		return capacity == array->capacity || NAME##_spill(array, capacity);\
+	}\
+\
+	if (array->length > capacity)\
+		array->length = capacity;\
+\
+	if (!NAME##_is_inline(array))\
+	{\
+		TYPE *heap = array->storage.heap;\
+\
+		memcpy(array->storage.items, heap, array->length * sizeof(TYPE));\
+		hirzel_deallocate(array->allocator, heap, array->capacity * sizeof(TYPE));\
+		array->capacity = (N);\
+	}\
+\
+	return true;\
+}\
+\
+bool NAME##_resize(NAME *array, size_t length)\
+{\
+	assert(array != NULL);\
+\
+	if (length > array->capacity && !NAME##_grow(array, length))\
+		return false;\
+\
+	array->length = length;\
+\
+	return true;\
+}\
+\
+TYPE *NAME##_push_raw(NAME *array)\
+{\
+	assert(array != NULL);\
+\
+	if (array->length == array->capacity && !NAME##_grow(array, array->length + 1))\
+		return NULL;\
+\
+	TYPE *back = NAME##_data(array) + array->length;\
+	array->length += 1;\
+\
+	return back;\
+}\
+\
+TYPE *NAME##_push_ptr(NAME *array, const TYPE *item)\
+{\
+	assert(array != NULL);\
+	assert(item != NULL);\
+\
+	TYPE *back = NAME##_push_raw(array);\
+\
+	if (back != NULL)\
+		*back = *item;\
+\
+	return back;\
+}\
+\
+TYPE *NAME##_push(NAME *array, TYPE item)\
+{\
+	assert(array != NULL);\
+\
+	TYPE *back = NAME##_push_raw(array);\
+\
+	if (back != NULL)\
+		*back = item;\
+\
+	return back;\
+}\
+\
+TYPE *NAME##_insert_raw(NAME *array, size_t pos)\
+{\
+	assert(array != NULL);\
+	assert(pos <= array->length);\
+\
+	if (NAME##_push_raw(array) == NULL)\
+		return NULL;\
+\
+	TYPE *data = NAME##_data(array);\
+\
+	memmove(data + pos + 1, data + pos, (array->length - 1 - pos) * sizeof(TYPE));\
+\
+	return data + pos;\
+}\
+\
+TYPE *NAME##_insert(NAME *array, size_t pos, TYPE item)\
+{\
+	TYPE *ptr = NAME##_insert_raw(array, pos);\
+\
+	if (ptr != NULL)\
+		*ptr = item;\
+\
+	return ptr;\
+}\
+\
+TYPE *NAME##_insert_ptr(NAME *array, size_t pos, const TYPE *item)\
+{\
+	assert(item != NULL);\
+\
+	TYPE *ptr = NAME##_insert_raw(array, pos);\
+\
+	if (ptr != NULL)\
+		*ptr = *item;\
+\
+	return ptr;\
+}\
+\
+TYPE *NAME##_pushf_raw(NAME *array)\
+{\
+	return NAME##_insert_raw(array, 0);\
+}\
+\
+TYPE *NAME##_pushf(NAME *array, TYPE item)\
+{\
+	return NAME##_insert(array, 0, item);\
+}\
+\
+TYPE *NAME##_pushf_ptr(NAME *array, const TYPE *item)\
+{\
+	return NAME##_insert_ptr(array, 0, item);\
+}\
+\
+void NAME##_pop(NAME *array)\
+{\
+	assert(array != NULL);\
+	if (array->length > 0) array->length -= 1;\
+}\
+\
+void NAME##_erase(NAME *array, size_t pos)\
+{\
+	assert(array != NULL);\
+	assert(pos < array->length);\
+\
+	TYPE *data = NAME##_data(array);\
+\
+	memmove(data + pos, data + pos + 1, (array->length - 1 - pos) * sizeof(TYPE));\
+	array->length -= 1;\
+}\
+\
+void NAME##_popf(NAME *array)\
+{\
+	assert(array != NULL);\
+\
+	if (array->length > 0)\
+		NAME##_erase(array, 0);\
+}\
+\
+void NAME##_set_ptr(NAME *array, size_t pos, const TYPE *item)\
+{\
+	assert(array != NULL);\
+	assert(item != NULL);\
+	assert(pos < array->length);\
+	NAME##_data(array)[pos] = *item;\
+}\
+\
+void NAME##_set(NAME *array, size_t pos, TYPE item)\
+{\
+	NAME##_set_ptr(array, pos, &item);\
+}\
+\
+void NAME##_swap(NAME *array, size_t pos_a, size_t pos_b)\
+{\
+	assert(array != NULL);\
+	assert(pos_a < array->length);\
+	assert(pos_b < array->length);\
+	TYPE *data = NAME##_data(array);\
+	TYPE tmp = data[pos_a];\
+	data[pos_a] = data[pos_b];\
+	data[pos_b] = tmp;\
+}\
+\
+TYPE *NAME##_get_ptr(NAME *array, size_t i)\
+{\
+	assert(array != NULL);\
+	assert(i < array->length);\
+	return NAME##_data(array) + i;\
+}\
+\
+TYPE NAME##_get(NAME *array, size_t i)\
+{\
+	return *NAME##_get_ptr(array, i);\
+}\
+\
+TYPE *NAME##_front_ptr(NAME *array)\
+{\
+	assert(array != NULL);\
+	assert(array->length > 0);\
+	return NAME##_data(array);\
+}\
+\
+TYPE NAME##_front(NAME *array)\
+{\
+	return *NAME##_front_ptr(array);\
+}\
+\
+TYPE *NAME##_back_ptr(NAME *array)\
+{\
+	assert(array != NULL);\
+	assert(array->length > 0);\
+	return NAME##_data(array) + (array->length - 1);\
+}\
+\
+TYPE NAME##_back(NAME *array)\
+{\
+	return *NAME##_back_ptr(array);\
+}
+
+#endif
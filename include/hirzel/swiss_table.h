@@ -0,0 +1,512 @@
+#ifndef HIRZEL_SWISS_TABLE_H
+#define HIRZEL_SWISS_TABLE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include <hirzel/hash.h>
+
+/*
+ * String keyed hash table with the same interface as HIRZEL_TABLE, laid out
+ * after Google's SwissTable. Every slot has a one byte control tag stored in a
+ * separate array: empty, deleted or the low 7 bits of the key's hash. Lookups
+ * scan the tags 16 at a time and only compare keys whose tag matches. Slots
+ * keep the key's full hash, so growing moves them without hashing any key.
+ */
+
+#define HIRZEL_SWISS_GROUP_WIDTH 16
+#define HIRZEL_SWISS_EMPTY ((int8_t)-128)
+#define HIRZEL_SWISS_DELETED ((int8_t)-2)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HIRZEL_SWISS_SSE2
+#define HIRZEL_SWISS_LANE_SHIFT 0
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HIRZEL_SWISS_NEON
+#define HIRZEL_SWISS_LANE_SHIFT 2
+#else
+#define HIRZEL_SWISS_LANE_SHIFT 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// bitmask with one set bit per matching control byte in a group
+typedef uint64_t HirzelSwissMask;
+
+#if defined(HIRZEL_SWISS_NEON)
+static inline HirzelSwissMask hirzel_swiss_neon_mask(uint8x16_t lanes)
+{
+	uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(lanes), 4);
+
+	return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull;
+}
+#endif
+
+static inline HirzelSwissMask hirzel_swiss_match(const int8_t *group, int8_t tag)
+{
+#if defined(HIRZEL_SWISS_SSE2)
+	__m128i control = _mm_loadu_si128((const __m128i *)group);
+
+	return (HirzelSwissMask)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(tag)));
+#elif defined(HIRZEL_SWISS_NEON)
+	return hirzel_swiss_neon_mask(vceqq_s8(vld1q_s8(group), vdupq_n_s8(tag)));
+#else
+	HirzelSwissMask mask = 0;
+
+	for (unsigned i = 0; i < HIRZEL_SWISS_GROUP_WIDTH; ++i)
+		mask |= (HirzelSwissMask)(group[i] == tag) << i;
+
+	return mask;
+#endif
+}
+
+static inline HirzelSwissMask hirzel_swiss_match_empty(const int8_t *group)
+{
+	return hirzel_swiss_match(group, HIRZEL_SWISS_EMPTY);
+}
+
+static inline HirzelSwissMask hirzel_swiss_match_empty_or_deleted(const int8_t *group)
+{
+#if defined(HIRZEL_SWISS_SSE2)
+	return (HirzelSwissMask)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#elif defined(HIRZEL_SWISS_NEON)
+	return hirzel_swiss_neon_mask(vcltq_s8(vld1q_s8(group), vdupq_n_s8(0)));
+#else
+	HirzelSwissMask mask = 0;
+
+	for (unsigned i = 0; i < HIRZEL_SWISS_GROUP_WIDTH; ++i)
+		mask |= (HirzelSwissMask)(group[i] < 0) << i;
+
+	return mask;
+#endif
+}
+
+static inline size_t hirzel_swiss_lowest(HirzelSwissMask mask)
+{
+	assert(mask != 0);
+
+#if defined(__GNUC__) || defined(__clang__)
+	return (size_t)__builtin_ctzll(mask) >> HIRZEL_SWISS_LANE_SHIFT;
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return (size_t)index >> HIRZEL_SWISS_LANE_SHIFT;
+#else
+	size_t index = 0;
+
+	while (!(mask & 1))
+	{
+		mask >>= 1;
+		index += 1;
+	}
+
+	return index >> HIRZEL_SWISS_LANE_SHIFT;
+#endif
+}
+
+#define HIRZEL_SWISS_TABLE_DECLARE(TYPE, NAME)\
+\
+typedef struct __##NAME##Slot\
+{\
+	char *key;\
+	size_t hash;\
+	TYPE value;\
+} NAME##Slot;\
+\
+typedef struct __##NAME\
+{\
+	int8_t *control;\
+	NAME##Slot *slots;\
+	size_t(*hash_function)(const char*, size_t);\
+	size_t capacity;\
+	size_t count;\
+	size_t growth_left;\
+} NAME;\
+\
+bool NAME##_init(NAME *table);\
+void NAME##_free(NAME *table);\
+bool NAME##_reserve(NAME *table, size_t min_count);\
+bool NAME##_shrink(NAME *table);\
+bool NAME##_set(NAME *table, const char* key, TYPE value);\
+bool NAME##_set_ptr(NAME *table, const char* key, const TYPE *value);\
+void NAME##_erase(NAME *table, const char *key);\
+void NAME##_clear(NAME *table);\
+bool NAME##_swap(NAME *table, const char *a, const char *b);\
+bool NAME##_get(const NAME *table, TYPE *out, const char *key);\
+TYPE *NAME##_get_ptr(const NAME *table, const char *key);\
+bool NAME##_contains(const NAME *table, const char *key);\
+size_t NAME##_size(const NAME *table);\
+bool NAME##_is_empty(const NAME *table);\
+size_t NAME##_hash_string(const char *key);\
+size_t NAME##_hash_bytes(const char *key, size_t length);
+
+
+#define HIRZEL_SWISS_TABLE_DEFINE(TYPE, NAME)\
+\
+static size_t NAME##_max_load(size_t capacity)\
+{\
+	return capacity - capacity / 8;\
+}\
+\
+static size_t NAME##_get_min_capacity(size_t count)\
+{\
+	size_t capacity = HIRZEL_SWISS_GROUP_WIDTH;\
+\
+	while (NAME##_max_load(capacity) < count)\
+		capacity *= 2;\
+\
+	return capacity;\
+}\
+\
+/* custom hash functions may be weak in the bits used for group and tag */\
+static size_t NAME##_hash(const NAME *table, const char *key, size_t length)\
+{\
+	return (size_t)hirzel_hash_mix(table->hash_function(key, length));\
+}\
+\
+static NAME##Slot *NAME##_find_slot_hashed(const NAME *table, const char *key, size_t hash)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	int8_t tag = (int8_t)(hash & 0x7F);\
+	size_t group_mask = table->capacity / HIRZEL_SWISS_GROUP_WIDTH - 1;\
+	size_t group = (hash >> 7) & group_mask;\
+	size_t step = 0;\
+\
+	while (true)\
+	{\
+		size_t offset = group * HIRZEL_SWISS_GROUP_WIDTH;\
+		const int8_t *control = table->control + offset;\
+		HirzelSwissMask match = hirzel_swiss_match(control, tag);\
+\
+		while (match)\
+		{\
+			NAME##Slot *slot = table->slots + offset + hirzel_swiss_lowest(match);\
+\
+			if (slot->hash == hash && !strcmp(slot->key, key))\
+				return slot;\
+\
+			match &= match - 1;\
+		}\
+\
+		if (hirzel_swiss_match_empty(control))\
+			return NULL;\
+\
+		step += 1;\
+		group = (group + step) & group_mask;\
+	}\
+}\
+\
+static NAME##Slot *NAME##_find_slot(const NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_find_slot_hashed(table, key, NAME##_hash(table, key, strlen(key)));\
+}\
+\
+static size_t NAME##_find_free_index(const NAME *table, size_t hash)\
+{\
+	assert(table != NULL);\
+\
+	size_t group_mask = table->capacity / HIRZEL_SWISS_GROUP_WIDTH - 1;\
+	size_t group = (hash >> 7) & group_mask;\
+	size_t step = 0;\
+\
+	while (true)\
+	{\
+		size_t offset = group * HIRZEL_SWISS_GROUP_WIDTH;\
+		HirzelSwissMask free_mask = hirzel_swiss_match_empty_or_deleted(table->control + offset);\
+\
+		if (free_mask)\
+			return offset + hirzel_swiss_lowest(free_mask);\
+\
+		step += 1;\
+		group = (group + step) & group_mask;\
+	}\
+}\
+\
+static bool NAME##_rehash(NAME *table, size_t new_capacity)\
+{\
+	assert(table != NULL);\
+	assert(new_capacity % HIRZEL_SWISS_GROUP_WIDTH == 0);\
+	assert(NAME##_max_load(new_capacity) >= table->count);\
+\
+	int8_t *new_control = malloc(new_capacity);\
+	NAME##Slot *new_slots = malloc(new_capacity * sizeof(NAME##Slot));\
+\
+	if (!new_control || !new_slots)\
+	{\
+		free(new_control);\
+		free(new_slots);\
+		return false;\
+	}\
+\
+	memset(new_control, HIRZEL_SWISS_EMPTY, new_capacity);\
+\
+	NAME old = *table;\
+\
+	table->control = new_control;\
+	table->slots = new_slots;\
+	table->capacity = new_capacity;\
+	table->growth_left = NAME##_max_load(new_capacity) - table->count;\
+\
+	for (size_t i = 0; i < old.capacity; ++i)\
+	{\
+		if (old.control[i] < 0)\
+			continue;\
+\
+		/* slots keep their full hash, so growing never rehashes a key */\
+		size_t hash = old.slots[i].hash;\
+		size_t index = NAME##_find_free_index(table, hash);\
+\
+		table->control[index] = (int8_t)(hash & 0x7F);\
+		table->slots[index] = old.slots[i];\
+	}\
+\
+	free(old.control);\
+	free(old.slots);\
+\
+	return true;\
+}\
+\
+bool NAME##_init(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	*table = (NAME) { NULL, NULL, NAME##_hash_bytes, 0, 0, 0 };\
+\
+	return NAME##_rehash(table, HIRZEL_SWISS_GROUP_WIDTH);\
+}\
+\
+void NAME##_free(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	for (size_t i = 0; i < table->capacity; ++i)\
+	{\
+		if (table->control[i] >= 0)\
+			free(table->slots[i].key);\
+	}\
+\
+	free(table->control);\
+	free(table->slots);\
+}\
+\
+bool NAME##_reserve(NAME *table, size_t min_count)\
+{\
+	assert(table != NULL);\
+\
+	size_t capacity = NAME##_get_min_capacity(min_count);\
+\
+	if (capacity <= table->capacity)\
+		return true;\
+\
+	return NAME##_rehash(table, capacity);\
+}\
+\
+bool NAME##_shrink(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	size_t capacity = NAME##_get_min_capacity(table->count);\
+\
+	if (capacity >= table->capacity)\
+		return true;\
+\
+	return NAME##_rehash(table, capacity);\
+}\
+\
+bool NAME##_set_ptr(NAME *table, const char *key, const TYPE *value)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+	assert(value != NULL);\
+\
+	/* hashed once, as the hash doesn't depend on the capacity a rehash below may change */\
+	size_t length = strlen(key);\
+	size_t hash = NAME##_hash(table, key, length);\
+	NAME##Slot *slot = NAME##_find_slot_hashed(table, key, hash);\
+\
+	if (slot)\
+	{\
+		slot->value = *value;\
+		return true;\
+	}\
+\
+	if (table->growth_left == 0)\
+	{\
+		/* mostly tombstones: clean up in place instead of growing */\
+		size_t new_capacity = table->count < NAME##_max_load(table->capacity) / 2\
+			? table->capacity\
+			: table->capacity * 2;\
+\
+		if (!NAME##_rehash(table, new_capacity))\
+			return false;\
+	}\
+\
+	char *key_buffer = malloc(length + 1);\
+\
+	if (!key_buffer)\
+		return false;\
+\
+	memcpy(key_buffer, key, length + 1);\
+\
+	size_t index = NAME##_find_free_index(table, hash);\
+\
+	if (table->control[index] == HIRZEL_SWISS_EMPTY)\
+		table->growth_left -= 1;\
+\
+	table->control[index] = (int8_t)(hash & 0x7F);\
+	table->slots[index] = (NAME##Slot) { key_buffer, hash, *value };\
+	table->count += 1;\
+\
+	return true;\
+}\
+\
+bool NAME##_set(NAME *table, const char *key, TYPE value)\
+{\
+	return NAME##_set_ptr(table, key, &value);\
+}\
+\
+bool NAME##_get(const NAME *table, TYPE *out, const char *key)\
+{\
+	assert(table != NULL);\
+	assert(out != NULL);\
+	assert(key != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(table, key);\
+\
+	if (!slot)\
+		return false;\
+\
+	*out = slot->value;\
+\
+	return true;\
+}\
+\
+TYPE *NAME##_get_ptr(const NAME *table, const char *key)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(table, key);\
+\
+	return slot != NULL\
+		? &slot->value\
+		: NULL;\
+}\
+\
+bool NAME##_contains(const NAME *table, const char *key)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	return NAME##_find_slot(table, key) != NULL;\
+}\
+\
+void NAME##_erase(NAME *table, const char *key)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	NAME##Slot *slot = NAME##_find_slot(table, key);\
+\
+	if (!slot)\
+		return;\
+\
+	size_t index = (size_t)(slot - table->slots);\
+	size_t offset = index - index % HIRZEL_SWISS_GROUP_WIDTH;\
+\
+	free(slot->key);\
+	slot->key = NULL;\
+\
+	/* probes never continue past a group that still has an empty slot */\
+	if (hirzel_swiss_match_empty(table->control + offset))\
+	{\
+		table->control[index] = HIRZEL_SWISS_EMPTY;\
+		table->growth_left += 1;\
+	}\
+	else\
+	{\
+		table->control[index] = HIRZEL_SWISS_DELETED;\
+	}\
+\
+	table->count -= 1;\
+}\
+\
+void NAME##_clear(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	for (size_t i = 0; i < table->capacity; ++i)\
+	{\
+		if (table->control[i] >= 0)\
+			free(table->slots[i].key);\
+	}\
+\
+	memset(table->control, HIRZEL_SWISS_EMPTY, table->capacity);\
+	table->count = 0;\
+	table->growth_left = NAME##_max_load(table->capacity);\
+}\
+\
+bool NAME##_swap(NAME *table, const char *key_a, const char *key_b)\
+{\
+	assert(table != NULL);\
+	assert(key_a != NULL);\
+	assert(key_b != NULL);\
+\
+	NAME##Slot *slot_a = NAME##_find_slot(table, key_a);\
+\
+	if (!slot_a)\
+		return false;\
+\
+	NAME##Slot *slot_b = NAME##_find_slot(table, key_b);\
+\
+	if (!slot_b)\
+		return false;\
+\
+	TYPE tmp = slot_a->value;\
+	slot_a->value = slot_b->value;\
+	slot_b->value = tmp;\
+\
+	return true;\
+}\
+\
+size_t NAME##_size(const NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	return table->capacity;\
+}\
+\
+bool NAME##_is_empty(const NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	return table->count == 0;\
+}\
+\
+size_t NAME##_hash_string(const char *string)\
+{\
+	assert(string != NULL);\
+\
+	return hirzel_hash_string(string);\
+}\
+\
+size_t NAME##_hash_bytes(const char *key, size_t length)\
+{\
+	assert(key != NULL);\
+\
+	return (size_t)hirzel_hash_bytes(key, length, HIRZEL_HASH_DEFAULT_SEED);\
+}
+
+#endif
@@ -2,54 +2,254 @@
 #define HIRZEL_TABLE_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
 
-#define HIRZEL_TABLE_DECLARE(TYPE, NAME)\
+#include <hirzel/allocator.h>
+#include <hirzel/hash.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define HIRZEL_PREFETCH(address) _mm_prefetch((const char *)(address), _MM_HINT_T0)
+#elif defined(__GNUC__) || defined(__clang__)
+#define HIRZEL_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define HIRZEL_PREFETCH(address) ((void)(address))
+#endif
+
+/*
+ * Optional bump allocator for the keys of a table. Keys are carved out of
+ * blocks that double in size, so loading n keys costs O(log n) allocations and
+ * clearing the table frees all but the newest block. Erased keys keep their
+ * bytes until the table is compacted. Blocks come from the table's allocator.
+ */
+#define HIRZEL_KEY_ARENA_MIN_BLOCK 4096
+
+typedef struct HirzelKeyBlock
+{
+	struct HirzelKeyBlock *next;
+	size_t used;
+	size_t capacity;
+	char data[];
+} HirzelKeyBlock;
+
+typedef struct HirzelKeyArena
+{
+	HirzelKeyBlock *blocks;
+	size_t live_size;
+	bool is_enabled;
+} HirzelKeyArena;
+
+static inline bool hirzel_key_arena_add_block(HirzelKeyArena *arena, const HirzelAllocator *allocator, size_t capacity)
+{
+	assert(arena != NULL);
+
+	HirzelKeyBlock *block = hirzel_allocate(allocator, sizeof(HirzelKeyBlock) + capacity);
+
+	if (!block)
+		return false;
+
+	block->next = arena->blocks;
+	block->used = 0;
+	block->capacity = capacity;
+	arena->blocks = block;
+
+	return true;
+}
+
+static inline char *hirzel_key_arena_alloc(HirzelKeyArena *arena, const HirzelAllocator *allocator, size_t size)
+{
+	assert(arena != NULL);
+
+	HirzelKeyBlock *block = arena->blocks;
+
+	if (!block || block->capacity - block->used < size)
+	{
+		size_t capacity = block
+			? block->capacity * 2
+			: HIRZEL_KEY_ARENA_MIN_BLOCK;
+
+		if (capacity < size)
+			capacity = size;
+
+		if (!hirzel_key_arena_add_block(arena, allocator, capacity))
+			return NULL;
+
+		block = arena->blocks;
+	}
+
+	char *out = block->data + block->used;
+
+	block->used += size;
+	arena->live_size += size;
+
+	return out;
+}
+
+static inline void hirzel_key_arena_free_blocks(const HirzelAllocator *allocator, HirzelKeyBlock *block)
+{
+	while (block)
+	{
+		HirzelKeyBlock *next = block->next;
+		hirzel_deallocate(allocator, block, sizeof(HirzelKeyBlock) + block->capacity);
+		block = next;
+	}
+}
+
+static inline void hirzel_key_arena_reset(HirzelKeyArena *arena, const HirzelAllocator *allocator)
+{
+	assert(arena != NULL);
+
+	if (arena->blocks)
+	{
+		hirzel_key_arena_free_blocks(allocator, arena->blocks->next);
+		arena->blocks->next = NULL;
+		arena->blocks->used = 0;
+	}
+
+	arena->live_size = 0;
+}
+
+/*
+ * Allocator that NAME##_init gives new tables, expanded inside the DEFINE
+ * macros so it can be overridden for a single instantiation like
+ * HIRZEL_ARRAY_ALLOCATOR. NULL uses malloc. It serves the node arrays and keys.
+ */
+#ifndef HIRZEL_TABLE_ALLOCATOR
+#define HIRZEL_TABLE_ALLOCATOR NULL
+#endif
+
+/*
+ * Probing core shared by HIRZEL_TABLE and HIRZEL_SET. NODE_FIELDS are the
+ * members a container stores beside each key, and may be left empty.
+ */
+#define HIRZEL_TABLE_CORE_DECLARE(NAME, NODE_FIELDS)\
 \
 typedef struct __##NAME##Node\
 {\
 	char *key;\
-	TYPE value;\
+	size_t key_length;\
+	size_t hash;\
+	NODE_FIELDS\
 	bool is_deleted;\
 } NAME##Node;\
 \
 typedef struct __##NAME\
 {\
 	NAME##Node *data;\
-	size_t(*hash_function)(const char*);\
+	size_t(*hash_function)(const char*, size_t);\
 	size_t size_index;\
 	size_t count;\
+	size_t deleted_count;\
+	HirzelKeyArena key_arena;\
+	NAME##Node *old_data;\
+	size_t old_size_index;\
+	size_t migrate_index;\
+	bool is_incremental;\
+	const HirzelAllocator *allocator;\
 } NAME;\
 \
+typedef struct __##NAME##Iter\
+{\
+	size_t index;\
+} NAME##Iter;\
+\
 bool NAME##_init(NAME *table);\
+bool NAME##_init_arena(NAME *table);\
+bool NAME##_init_allocator(NAME *table, const HirzelAllocator *allocator);\
+void NAME##_set_incremental(NAME *table, bool is_incremental);\
 void NAME##_free(NAME *table);\
 bool NAME##_resize(NAME *table, size_t new_size_index);\
 bool NAME##_reserve(NAME *table, size_t min_count);\
 bool NAME##_shrink(NAME *table);\
-bool NAME##_set(NAME *table, const char* key, TYPE value);\
-bool NAME##_set_ptr(NAME *table, const char* key, const TYPE *value);\
+bool NAME##_compact(NAME *table);\
 void NAME##_erase(NAME *table, const char *key);\
+void NAME##_erase_n(NAME *table, const char *key, size_t length);\
 void NAME##_clear(NAME *table);\
-bool NAME##_swap(NAME *table, const char *a, const char *b);\
-bool NAME##_get(const NAME *table, TYPE *out, const char *key);\
-TYPE *NAME##_get_ptr(const NAME *table, const char *key);\
 bool NAME##_contains(const NAME *table, const char *key);\
+bool NAME##_contains_n(const NAME *table, const char *key, size_t length);\
 size_t NAME##_size(const NAME *table);\
 bool NAME##_is_empty(const NAME *table);\
-size_t NAME##_hash_string(const char *key);
+size_t NAME##_hash_string(const char *key);\
+size_t NAME##_hash_bytes(const char *key, size_t length);\
+NAME##Iter NAME##_iter_begin(const NAME *table);\
+NAME##Node *NAME##_iter_next(const NAME *table, NAME##Iter *iter);
 
-
-#define HIRZEL_TABLE_DEFINE(TYPE, NAME)\
+#define HIRZEL_TABLE_DECLARE(TYPE, NAME)\
+\
+HIRZEL_TABLE_CORE_DECLARE(NAME, TYPE value;)\
 \
-static const size_t NAME##_sizes[] = {\
+bool NAME##_set(NAME *table, const char* key, TYPE value);\
+bool NAME##_set_ptr(NAME *table, const char* key, const TYPE *value);\
+bool NAME##_set_n(NAME *table, const char* key, size_t length, TYPE value);\
+bool NAME##_set_ptr_n(NAME *table, const char* key, size_t length, const TYPE *value);\
+bool NAME##_swap(NAME *table, const char *a, const char *b);\
+bool NAME##_get(const NAME *table, TYPE *out, const char *key);\
+bool NAME##_get_n(const NAME *table, TYPE *out, const char *key, size_t length);\
+TYPE *NAME##_get_ptr(const NAME *table, const char *key);\
+TYPE *NAME##_get_ptr_n(const NAME *table, const char *key, size_t length);\
+size_t NAME##_get_batch(const NAME *table, TYPE *out, bool *is_found, const char *const *keys, size_t count);\
+bool NAME##_set_batch(NAME *table, const char *const *keys, const TYPE *values, size_t count);
+
+
+/*
+ * Sizing policies select the slot counts and probe sequence of a table. Each
+ * provides SIZES, the capacities a table steps through, MIX, applied to every
+ * hash, INDEX, the home slot of a hash, and PROBE, the slot visited after a
+ * number of steps.
+ *
+ * HIRZEL_TABLE_PRIME uses prime capacities with quadratic probing, so every
+ * probe costs an integer division. HIRZEL_TABLE_POW2 uses power of two
+ * capacities with triangular probing, which reduces indexing to a mask, and
+ * mixes the hash first as only its low bits pick the slot.
+ */
+#define HIRZEL_TABLE_PRIME_SIZES\
 	11, 23, 47, 97, 197, 397, 797, 1597, 3203, 6421, 12853,\
 	25717, 51437, 102877, 205759, 411527, 823117, 1646237, 3292489, 6584983,\
 	13169977, 26339969, 52679969, 105359939, 210719881, 421439783, 842879579,\
-	1685759167, 3371518343, 6743036717\
-};\
+	1685759167, 3371518343, 6743036717
+#define HIRZEL_TABLE_PRIME_MIX(hash) (hash)
+#define HIRZEL_TABLE_PRIME_INDEX(hash, size) ((hash) % (size))
+#define HIRZEL_TABLE_PRIME_PROBE(hash, index, step, size) (((hash) + (step) * (step)) % (size))
+
+#define HIRZEL_TABLE_POW2_SIZES\
+	16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768,\
+	65536, 131072, 262144, 524288, 1048576, 2097152, 4194304, 8388608,\
+	16777216, 33554432, 67108864, 134217728, 268435456, 536870912,\
+	1073741824, 2147483648, 4294967296, 8589934592
+#define HIRZEL_TABLE_POW2_MIX(hash) ((size_t)hirzel_hash_mix(hash))
+#define HIRZEL_TABLE_POW2_INDEX(hash, size) ((hash) & ((size) - 1))
+#define HIRZEL_TABLE_POW2_PROBE(hash, index, step, size) (((index) + (step)) & ((size) - 1))
+
+/*
+ * Tables given NAME##_set_incremental grow without rehashing every key at
+ * once. The old array is kept beside the new one and each set or erase moves
+ * the next HIRZEL_TABLE_MIGRATE_STEP of its slots over, while lookups fall
+ * back to the old array for keys not moved yet. Explicit resizes still finish
+ * in one call.
+ */
+#ifndef HIRZEL_TABLE_MIGRATE_STEP
+#define HIRZEL_TABLE_MIGRATE_STEP 64
+#endif
+
+/*
+ * The batch functions hash this many keys and prefetch their home slots before
+ * probing for any of them, so the cache misses of a batch overlap rather than
+ * being waited on one key at a time.
+ */
+#ifndef HIRZEL_TABLE_BATCH_SIZE
+#define HIRZEL_TABLE_BATCH_SIZE 16
+#endif
+
+#define HIRZEL_TABLE_DEFINE(TYPE, NAME) HIRZEL_TABLE_DEFINE_SIZING(TYPE, NAME, HIRZEL_TABLE_PRIME)
+#define HIRZEL_TABLE_DEFINE_POW2(TYPE, NAME) HIRZEL_TABLE_DEFINE_SIZING(TYPE, NAME, HIRZEL_TABLE_POW2)
+
+#define HIRZEL_TABLE_CORE_DEFINE(NAME, SIZING)\
+\
+static const size_t NAME##_sizes[] = { SIZING##_SIZES };\
 \
 static const size_t NAME##_size_count = sizeof(NAME##_sizes) / sizeof(*NAME##_sizes);\
 \
@@ -66,108 +266,309 @@ static size_t NAME##_get_min_size_index(size_t count)\
 	return size_index;\
 }\
 \
-static bool NAME##_init_node(NAME##Node *out, const NAME *table, const char *key, const TYPE *value)\
+static char *NAME##_alloc_key(NAME *table, size_t size)\
+{\
+	return table->key_arena.is_enabled\
+		? hirzel_key_arena_alloc(&table->key_arena, table->allocator, size)\
+		: hirzel_allocate(table->allocator, size);\
+}\
+\
+static void NAME##_free_key(NAME *table, NAME##Node *node)\
+{\
+	if (!node->key)\
+		return;\
+\
+	if (table->key_arena.is_enabled)\
+		table->key_arena.live_size -= node->key_length + 1;\
+	else\
+		hirzel_deallocate(table->allocator, node->key, node->key_length + 1);\
+}\
+\
+/* keys are copied with a terminator so they can still be used as strings */\
+static bool NAME##_init_key(NAME##Node *out, NAME *table, const char *key, size_t length, size_t hash)\
 {\
 	assert(table != NULL);\
 	assert(out != NULL);\
 	assert(key != NULL);\
-	assert(value != NULL);\
 \
-	size_t key_len = strlen(key) + 1;\
-	char *key_buffer = malloc(key_len);\
+	char *key_buffer = NAME##_alloc_key(table, length + 1);\
 \
 	if (!key_buffer)\
 		return false;\
 \
-	*out = (NAME##Node) { key_buffer, *value, false };\
-	strcpy(out->key, key);\
-	out->value = *value;\
+	memcpy(key_buffer, key, length);\
+	key_buffer[length] = '\0';\
+\
+	out->key = key_buffer;\
+	out->key_length = length;\
+	out->hash = hash;\
+	out->is_deleted = false;\
 \
 	return true;\
 }\
 \
-static void NAME##_delete_node(NAME##Node *node)\
+static void NAME##_delete_node(NAME *table, NAME##Node *node)\
 {\
 	assert(node != NULL);\
 \
-	free(node->key);\
+	NAME##_free_key(table, node);\
+\
+	/* a key not migrated yet leaves its tombstone in the old array, which\
+	 * doesn't count towards the load of the current one */\
+	uintptr_t begin = (uintptr_t)table->data;\
+	uintptr_t end = (uintptr_t)(table->data + NAME##_sizes[table->size_index]);\
+	bool is_current = (uintptr_t)node >= begin && (uintptr_t)node < end;\
 \
 	node->key = NULL;\
 	node->is_deleted = true;\
+	table->count -= 1;\
+\
+	if (is_current)\
+		table->deleted_count += 1;\
 }\
 \
-static void NAME##_clear_node(NAME##Node *node)\
+static size_t NAME##_hash(const NAME *table, const char *key, size_t length)\
 {\
-	assert(node != NULL);\
-\
-	free(node->key);\
-\
-	node->key = NULL;\
-	node->is_deleted = false;\
+	return SIZING##_MIX(table->hash_function(key, length));\
 }\
 \
-static NAME##Node *NAME##_find_node(const NAME *table, const char *key)\
+static NAME##Node *NAME##_probe_node(NAME##Node *data, size_t size, const char *key, size_t length, size_t hash)\
 {\
-	assert(table != NULL);\
+	assert(data != NULL);\
 	assert(key != NULL);\
 \
-	size_t size = NAME##_sizes[table->size_index];\
-	size_t hash = table->hash_function(key);\
-	size_t i = hash % size;\
+	size_t i = SIZING##_INDEX(hash, size);\
 	size_t step = 0;\
 \
 	while (true)\
 	{\
-		NAME##Node *node = table->data + i;\
+		NAME##Node *node = data + i;\
 \
-		if (node->key == NULL && !node->is_deleted)\
-			break;\
-		else if (!strcmp(node->key, key))\
+		if (node->key == NULL)\
+		{\
+			if (!node->is_deleted)\
+				break;\
+		}\
+		else if (node->hash == hash && node->key_length == length && !memcmp(node->key, key, length))\
+		{\
 			break;\
+		}\
 \
 		step += 1;\
-		i = (hash + step * step) % size;\
+		i = SIZING##_PROBE(hash, i, step, size);\
 	}\
 \
-	NAME##Node *out = table->data + i;\
+	NAME##Node *out = data + i;\
 \
 	return out;\
 }\
 \
-bool NAME##_init(NAME *table)\
+/* node of a key, or the empty node it would be inserted at */\
+static NAME##Node *NAME##_find_node_hashed(const NAME *table, const char *key, size_t length, size_t hash)\
+{\
+	assert(table != NULL);\
+\
+	NAME##Node *node = NAME##_probe_node(table->data, NAME##_sizes[table->size_index], key, length, hash);\
+\
+	if (!node->key && table->old_data)\
+	{\
+		NAME##Node *old_node = NAME##_probe_node(table->old_data, NAME##_sizes[table->old_size_index], key, length, hash);\
+\
+		if (old_node->key)\
+			return old_node;\
+	}\
+\
+	return node;\
+}\
+\
+static NAME##Node *NAME##_find_node(const NAME *table, const char *key, size_t length)\
+{\
+	return NAME##_find_node_hashed(table, key, length, NAME##_hash(table, key, length));\
+}\
+\
+/* first unused node in the probe sequence of a hash, for keys known to be absent */\
+static NAME##Node *NAME##_find_free_node(const NAME *table, size_t hash)\
 {\
 	assert(table != NULL);\
 \
-	NAME##Node *data = calloc(NAME##_sizes[0], sizeof(NAME##Node));\
+	size_t size = NAME##_sizes[table->size_index];\
+	size_t i = SIZING##_INDEX(hash, size);\
+	size_t step = 0;\
+\
+	while (table->data[i].key != NULL)\
+	{\
+		step += 1;\
+		i = SIZING##_PROBE(hash, i, step, size);\
+	}\
+\
+	return table->data + i;\
+}\
+\
+/* next node holding a key at or after index, covering both arrays during a resize */\
+static NAME##Node *NAME##_next_node(const NAME *table, size_t *index)\
+{\
+	assert(table != NULL);\
+	assert(index != NULL);\
+\
+	size_t size = NAME##_sizes[table->size_index];\
+	size_t end = table->old_data\
+		? size + NAME##_sizes[table->old_size_index]\
+		: size;\
+\
+	/* old slots before migrate_index have all been moved */\
+	if (table->old_data && *index >= size && *index < size + table->migrate_index)\
+		*index = size + table->migrate_index;\
+\
+	while (*index < end)\
+	{\
+		size_t i = *index;\
+		NAME##Node *node = i < size\
+			? table->data + i\
+			: table->old_data + (i - size);\
+\
+		*index += 1;\
+\
+		if (node->key)\
+			return node;\
+	}\
+\
+	return NULL;\
+}\
+\
+/* moves up to count slots of the old array into the current one */\
+static void NAME##_migrate(NAME *table, size_t count)\
+{\
+	assert(table != NULL);\
+	assert(table->old_data != NULL);\
+\
+	size_t old_size = NAME##_sizes[table->old_size_index];\
+	size_t end = old_size - table->migrate_index > count\
+		? table->migrate_index + count\
+		: old_size;\
+\
+	for (size_t i = table->migrate_index; i < end; ++i)\
+	{\
+		NAME##Node *node = table->old_data + i;\
+\
+		if (!node->key)\
+			continue;\
+\
+		*NAME##_find_free_node(table, node->hash) = *node;\
+\
+		/* left as a tombstone so keys probing past it can still be found */\
+		node->key = NULL;\
+		node->is_deleted = true;\
+	}\
+\
+	table->migrate_index = end;\
+\
+	if (end == old_size)\
+	{\
+		hirzel_deallocate(table->allocator, table->old_data, old_size * sizeof(NAME##Node));\
+		table->old_data = NULL;\
+	}\
+}\
+\
+static void NAME##_finish_migration(NAME *table)\
+{\
+	if (table->old_data)\
+		NAME##_migrate(table, (size_t)-1);\
+}\
+\
+/* swaps in an empty array of the new size, leaving the keys to be migrated */\
+static bool NAME##_start_migration(NAME *table, size_t new_size_index)\
+{\
+	assert(table != NULL);\
+\
+	NAME##_finish_migration(table);\
+\
+	NAME##Node *new_data = hirzel_allocate_zeroed(table->allocator, NAME##_sizes[new_size_index], sizeof(NAME##Node));\
+\
+	if (new_data == NULL)\
+		return false;\
+\
+	table->old_data = table->data;\
+	table->old_size_index = table->size_index;\
+	table->migrate_index = 0;\
+	table->data = new_data;\
+	table->size_index = new_size_index;\
+	table->deleted_count = 0;\
+\
+	return true;\
+}\
+\
+bool NAME##_init_allocator(NAME *table, const HirzelAllocator *allocator)\
+{\
+	assert(table != NULL);\
+\
+	NAME##Node *data = hirzel_allocate_zeroed(allocator, NAME##_sizes[0], sizeof(NAME##Node));\
 \
 	if (data == NULL)\
 		return false;\
 \
-	*table = (NAME) { data, NAME##_hash_string, 0, 0 };\
+	*table = (NAME) { data, NAME##_hash_bytes, 0, 0, 0, { NULL, 0, false }, NULL, 0, 0, false, allocator };\
+	return true;\
+}\
+\
+bool NAME##_init(NAME *table)\
+{\
+	return NAME##_init_allocator(table, HIRZEL_TABLE_ALLOCATOR);\
+}\
+\
+bool NAME##_init_arena(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	if (!NAME##_init(table))\
+		return false;\
+\
+	table->key_arena.is_enabled = true;\
+\
 	return true;\
 }\
 \
+/* turning it off finishes any resize underway, so later growth rehashes in one go */\
+void NAME##_set_incremental(NAME *table, bool is_incremental)\
+{\
+	assert(table != NULL);\
+\
+	if (!is_incremental)\
+		NAME##_finish_migration(table);\
+\
+	table->is_incremental = is_incremental;\
+}\
+\
 void NAME##_free(NAME *table)\
 {\
 	assert(table != NULL);\
 \
-	size_t size = NAME##_sizes[table->size_index];\
+	if (table->key_arena.is_enabled)\
+	{\
+		hirzel_key_arena_free_blocks(table->allocator, table->key_arena.blocks);\
+	}\
+	else\
+	{\
+		size_t i = 0;\
+		NAME##Node *node;\
 \
-	for (size_t i = 0; i < size; ++i)\
-		free(table->data[i].key);\
+		while ((node = NAME##_next_node(table, &i)))\
+			hirzel_deallocate(table->allocator, node->key, node->key_length + 1);\
+	}\
+\
+	hirzel_deallocate(table->allocator, table->data, NAME##_sizes[table->size_index] * sizeof(NAME##Node));\
+\
+	if (table->old_data)\
+		hirzel_deallocate(table->allocator, table->old_data, NAME##_sizes[table->old_size_index] * sizeof(NAME##Node));\
 }\
 \
-bool NAME##_resize(NAME *table, size_t new_size_index)\
+/* moves every key into a fresh array, dropping all tombstones */\
+static bool NAME##_rebuild(NAME *table, size_t new_size_index)\
 {\
 	assert(table != NULL);\
-	assert(new_size_index < NAME##_size_count);\
 \
-	if (new_size_index == table->size_index)\
-		return true;\
-	if (NAME##_sizes[new_size_index] < table->count)\
-		return false;\
+	NAME##_finish_migration(table);\
 \
-	NAME##Node *new_data = calloc(NAME##_sizes[new_size_index], sizeof(NAME##Node));\
+	NAME##Node *new_data = hirzel_allocate_zeroed(table->allocator, NAME##_sizes[new_size_index], sizeof(NAME##Node));\
 \
 	if (new_data == NULL)\
 		return false;\
@@ -177,21 +578,35 @@ bool NAME##_resize(NAME *table, size_t new_size_index)\
 \
 	table->data = new_data;\
 	table->size_index = new_size_index;\
+	table->deleted_count = 0;\
 \
 	for (size_t i = 0; i < old_size; ++i)\
 	{\
 		if (old_data[i].key)\
 		{\
-			NAME##Node *tnode = NAME##_find_node(table, old_data[i].key);\
+			NAME##Node *tnode = NAME##_find_free_node(table, old_data[i].hash);\
 			*tnode = old_data[i];\
 		}\
 	}\
 \
-	free(old_data);\
+	hirzel_deallocate(table->allocator, old_data, old_size * sizeof(NAME##Node));\
 \
 	return true;\
 }\
 \
+bool NAME##_resize(NAME *table, size_t new_size_index)\
+{\
+	assert(table != NULL);\
+	assert(new_size_index < NAME##_size_count);\
+\
+	if (new_size_index == table->size_index)\
+		return true;\
+	if (NAME##_sizes[new_size_index] < table->count)\
+		return false;\
+\
+	return NAME##_rebuild(table, new_size_index);\
+}\
+\
 bool NAME##_reserve(NAME *table, size_t min_count)\
 {\
 	assert(table != NULL);\
@@ -202,119 +617,101 @@ bool NAME##_reserve(NAME *table, size_t min_count)\
 	return is_resized;\
 }\
 \
-bool NAME##_set_ptr(NAME *table, const char* key, const TYPE *value)\
+/* node holding a key, inserted without a value if absent */\
+static NAME##Node *NAME##_insert_node(NAME *table, const char* key, size_t length, size_t hash)\
 {\
 	assert(table != NULL);\
 	assert(key != NULL);\
-	assert(value != NULL);\
+\
+	if (table->old_data)\
+		NAME##_migrate(table, HIRZEL_TABLE_MIGRATE_STEP);\
 \
 	size_t size = NAME##_sizes[table->size_index];\
-	bool is_table_half_full = (size / (table->count + 1)) <= 1;\
+	bool is_table_half_full = (size / (table->count + table->deleted_count + 1)) <= 1;\
 \
 	if (is_table_half_full)\
 	{\
+		/* mostly tombstones: clean up in place instead of growing */\
+		bool is_mostly_live = (table->count + 1) * 4 > size;\
 		size_t new_size_index = table->size_index;\
 		\
-		if (new_size_index < NAME##_size_count - 1)\
+		if (is_mostly_live && new_size_index < NAME##_size_count - 1)\
 			new_size_index += 1;\
 \
-		if (!NAME##_resize(table, new_size_index))\
-			return false;\
+		bool is_resized = table->is_incremental && new_size_index != table->size_index\
+			? NAME##_start_migration(table, new_size_index)\
+			: NAME##_rebuild(table, new_size_index);\
+\
+		if (!is_resized)\
+			return NULL;\
 	}\
 	\
-	NAME##Node *node = NAME##_find_node(table, key);\
+	NAME##Node *node = NAME##_find_node_hashed(table, key, length, hash);\
 	\
 	if (!node->key)\
 	{\
-		if (!NAME##_init_node(node, table, key, value))\
-			return false;\
+		if (!NAME##_init_key(node, table, key, length, hash))\
+			return NULL;\
 \
 		table->count += 1;\
 	}\
-	else\
-	{\
-		node->value = *value;\
-	}\
 \
-	return true;\
-}\
-bool NAME##_set(NAME *table, const char *key, TYPE value)\
-{\
-	return NAME##_set_ptr(table, key, &value);\
+	return node;\
 }\
 \
-bool NAME##_get(const NAME *table, TYPE *out, const char *key)\
+bool NAME##_contains_n(const NAME *table, const char *key, size_t length)\
 {\
 	assert(table != NULL);\
-	assert(out != NULL);\
 	assert(key != NULL);\
 \
-	NAME##Node *node = NAME##_find_node(table, key);\
-\
-	if (!node->key)\
-		return false;\
-\
-	*out = node->value;\
+	NAME##Node *node = NAME##_find_node(table, key, length);\
+	bool contains_key = node->key ? true : false;\
 \
-	return true;\
+	return contains_key;\
 }\
 \
-TYPE *NAME##_get_ptr(const NAME *table, const char *key)\
+bool NAME##_contains(const NAME *table, const char *key)\
 {\
-	assert(table != NULL);\
 	assert(key != NULL);\
 \
-	NAME##Node *node = NAME##_find_node(table, key);\
-	\
-	TYPE *out = node != NULL\
-		? &node->value\
-		: NULL;\
-\
-	return out;\
+	return NAME##_contains_n(table, key, strlen(key));\
 }\
 \
-bool NAME##_contains(const NAME *table, const char *key)\
+void NAME##_erase_n(NAME *table, const char *key, size_t length)\
 {\
 	assert(table != NULL);\
 	assert(key != NULL);\
 \
-	NAME##Node *node = NAME##_find_node(table, key);\
-	bool contains_key = node->key ? true : false;\
+	if (table->old_data)\
+		NAME##_migrate(table, HIRZEL_TABLE_MIGRATE_STEP);\
 \
-	return contains_key;\
+	NAME##Node *node = NAME##_find_node(table, key, length);\
+\
+	if (!node->key)\
+		return;\
+\
+	NAME##_delete_node(table, node);\
 }\
 \
 void NAME##_erase(NAME *table, const char *key)\
 {\
-	assert(table != NULL);\
 	assert(key != NULL);\
 \
-	NAME##Node *node = NAME##_find_node(table, key);\
-\
-	if (!node->key)\
-		return;\
-\
-	NAME##_delete_node(node);\
-	table->count -= 1;\
+	NAME##_erase_n(table, key, strlen(key));\
 }\
 \
 size_t NAME##_hash_string(const char *string)\
 {\
 	assert(string != NULL);\
 \
-	const size_t p = 97;\
-	const size_t m = 1000000009;\
-	size_t hash = 0;\
-	size_t pop = 1;\
+	return hirzel_hash_string(string);\
+}\
 \
-	while (*string)\
-	{\
-		hash = (hash + (*string - 'a' + 1) * pop) % m;\
-		pop = (pop * p) % m;\
-		string += 1;\
-	}\
+size_t NAME##_hash_bytes(const char *key, size_t length)\
+{\
+	assert(key != NULL);\
 \
-	return hash;\
+	return (size_t)hirzel_hash_bytes(key, length, HIRZEL_HASH_DEFAULT_SEED);\
 }\
 \
 bool NAME##_is_empty(const NAME *table)\
@@ -329,15 +726,34 @@ void NAME##_clear(NAME *table)\
 	assert(table != NULL);\
 	\
 	size_t size = NAME##_sizes[table->size_index];\
+\
+	if (table->key_arena.is_enabled)\
+		hirzel_key_arena_reset(&table->key_arena, table->allocator);\
+\
+	if (table->old_data)\
+	{\
+		size_t old_size = NAME##_sizes[table->old_size_index];\
+\
+		for (size_t i = table->migrate_index; i < old_size && !table->key_arena.is_enabled; ++i)\
+			hirzel_deallocate(table->allocator, table->old_data[i].key, table->old_data[i].key_length + 1);\
+\
+		hirzel_deallocate(table->allocator, table->old_data, old_size * sizeof(NAME##Node));\
+		table->old_data = NULL;\
+	}\
 \
 	for (size_t i = 0; i < size; ++i)\
 	{\
 		NAME##Node *node = table->data + i;\
 \
-		NAME##_clear_node(node);\
+		if (!table->key_arena.is_enabled)\
+			hirzel_deallocate(table->allocator, node->key, node->key_length + 1);\
+\
+		node->key = NULL;\
+		node->is_deleted = false;\
 	}\
 \
 	table->count = 0;\
+	table->deleted_count = 0;\
 }\
 \
 size_t NAME##_size(const NAME *table)\
@@ -353,12 +769,141 @@ bool NAME##_shrink(NAME *table)\
 \
 	size_t new_size_index = NAME##_get_min_size_index(table->count);\
 \
-	if (new_size_index >= table->size_index)\
+	if (new_size_index < table->size_index && !NAME##_resize(table, new_size_index))\
+		return false;\
+\
+	return NAME##_compact(table);\
+}\
+\
+bool NAME##_compact(NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	if (!table->key_arena.is_enabled)\
 		return true;\
 \
-	bool is_resized = NAME##_resize(table, new_size_index);\
+	HirzelKeyArena arena = { NULL, 0, true };\
+	size_t live_size = table->key_arena.live_size;\
 \
-	return is_resized;\
+	if (live_size > 0 && !hirzel_key_arena_add_block(&arena, table->allocator, live_size))\
+		return false;\
+\
+	size_t i = 0;\
+	NAME##Node *node;\
+\
+	while ((node = NAME##_next_node(table, &i)))\
+	{\
+		size_t key_size = node->key_length + 1;\
+		char *key = hirzel_key_arena_alloc(&arena, table->allocator, key_size);\
+\
+		memcpy(key, node->key, key_size);\
+		node->key = key;\
+	}\
+\
+	hirzel_key_arena_free_blocks(table->allocator, table->key_arena.blocks);\
+	table->key_arena = arena;\
+\
+	return true;\
+}\
+\
+NAME##Iter NAME##_iter_begin(const NAME *table)\
+{\
+	assert(table != NULL);\
+\
+	(void)table;\
+\
+	return (NAME##Iter) { 0 };\
+}\
+\
+/* next node holding a key, or NULL once every key has been visited. Only node\
+ * values may change mid iteration, as inserts and erases move nodes around. */\
+NAME##Node *NAME##_iter_next(const NAME *table, NAME##Iter *iter)\
+{\
+	assert(table != NULL);\
+	assert(iter != NULL);\
+\
+	return NAME##_next_node(table, &iter->index);\
+}
+
+#define HIRZEL_TABLE_DEFINE_SIZING(TYPE, NAME, SIZING)\
+\
+HIRZEL_TABLE_CORE_DEFINE(NAME, SIZING)\
+\
+bool NAME##_set_ptr_n(NAME *table, const char* key, size_t length, const TYPE *value)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+	assert(value != NULL);\
+\
+	NAME##Node *node = NAME##_insert_node(table, key, length, NAME##_hash(table, key, length));\
+\
+	if (!node)\
+		return false;\
+\
+	node->value = *value;\
+\
+	return true;\
+}\
+\
+bool NAME##_set_ptr(NAME *table, const char* key, const TYPE *value)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_set_ptr_n(table, key, strlen(key), value);\
+}\
+\
+bool NAME##_set_n(NAME *table, const char *key, size_t length, TYPE value)\
+{\
+	return NAME##_set_ptr_n(table, key, length, &value);\
+}\
+\
+bool NAME##_set(NAME *table, const char *key, TYPE value)\
+{\
+	return NAME##_set_ptr(table, key, &value);\
+}\
+\
+bool NAME##_get_n(const NAME *table, TYPE *out, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(out != NULL);\
+	assert(key != NULL);\
+\
+	NAME##Node *node = NAME##_find_node(table, key, length);\
+\
+	if (!node->key)\
+		return false;\
+\
+	*out = node->value;\
+\
+	return true;\
+}\
+\
+bool NAME##_get(const NAME *table, TYPE *out, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_get_n(table, out, key, strlen(key));\
+}\
+\
+TYPE *NAME##_get_ptr_n(const NAME *table, const char *key, size_t length)\
+{\
+	assert(table != NULL);\
+	assert(key != NULL);\
+\
+	NAME##Node *node = NAME##_find_node(table, key, length);\
+	\
+	TYPE *out = node->key != NULL\
+		? &node->value\
+		: NULL;\
+\
+	return out;\
+}\
+\
+TYPE *NAME##_get_ptr(const NAME *table, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##_get_ptr_n(table, key, strlen(key));\
 }\
 \
 bool NAME##_swap(NAME *table, const char *key_a, const char *key_b)\
@@ -367,12 +912,12 @@ bool NAME##_swap(NAME *table, const char *key_a, const char *key_b)\
 	assert(key_a != NULL);\
 	assert(key_b != NULL);\
 \
-	NAME##Node *node_a = NAME##_find_node(table, key_a);\
+	NAME##Node *node_a = NAME##_find_node(table, key_a, strlen(key_a));\
 \
 	if (!node_a->key)\
 		return false;\
 \
-	NAME##Node *node_b = NAME##_find_node(table, key_b);\
+	NAME##Node *node_b = NAME##_find_node(table, key_b, strlen(key_b));\
 \
 	if (!node_b->key)\
 		return false;\
@@ -383,5 +928,93 @@ bool NAME##_swap(NAME *table, const char *key_a, const char *key_b)\
 \
 	return true;\
 }\
+\
+static void NAME##_prefetch_node(const NAME *table, size_t hash)\
+{\
+	HIRZEL_PREFETCH(table->data + SIZING##_INDEX(hash, NAME##_sizes[table->size_index]));\
+}\
+\
+/* hashes up to HIRZEL_TABLE_BATCH_SIZE keys, prefetching where their probes start */\
+static size_t NAME##_hash_batch(const NAME *table, size_t *hashes, size_t *lengths, const char *const *keys, size_t count)\
+{\
+	if (count > HIRZEL_TABLE_BATCH_SIZE)\
+		count = HIRZEL_TABLE_BATCH_SIZE;\
+\
+	for (size_t i = 0; i < count; ++i)\
+	{\
+		assert(keys[i] != NULL);\
+\
+		lengths[i] = strlen(keys[i]);\
+		hashes[i] = NAME##_hash(table, keys[i], lengths[i]);\
+		NAME##_prefetch_node(table, hashes[i]);\
+	}\
+\
+	return count;\
+}\
+\
+/* looks up count keys, setting out[i] for each key found and returning how many were */\
+size_t NAME##_get_batch(const NAME *table, TYPE *out, bool *is_found, const char *const *keys, size_t count)\
+{\
+	assert(table != NULL);\
+	assert(out != NULL);\
+	assert(is_found != NULL);\
+	assert(keys != NULL);\
+\
+	size_t hashes[HIRZEL_TABLE_BATCH_SIZE];\
+	size_t lengths[HIRZEL_TABLE_BATCH_SIZE];\
+	size_t found_count = 0;\
+\
+	for (size_t start = 0; start < count;)\
+	{\
+		size_t batch_count = NAME##_hash_batch(table, hashes, lengths, keys + start, count - start);\
+\
+		for (size_t i = 0; i < batch_count; ++i)\
+		{\
+			NAME##Node *node = NAME##_find_node_hashed(table, keys[start + i], lengths[i], hashes[i]);\
+\
+			is_found[start + i] = node->key != NULL;\
+\
+			if (!node->key)\
+				continue;\
+\
+			out[start + i] = node->value;\
+			found_count += 1;\
+		}\
+\
+		start += batch_count;\
+	}\
+\
+	return found_count;\
+}\
+\
+/* sets count keys in order, stopping at the first that can't be inserted */\
+bool NAME##_set_batch(NAME *table, const char *const *keys, const TYPE *values, size_t count)\
+{\
+	assert(table != NULL);\
+	assert(keys != NULL);\
+	assert(values != NULL);\
+\
+	size_t hashes[HIRZEL_TABLE_BATCH_SIZE];\
+	size_t lengths[HIRZEL_TABLE_BATCH_SIZE];\
+\
+	for (size_t start = 0; start < count;)\
+	{\
+		size_t batch_count = NAME##_hash_batch(table, hashes, lengths, keys + start, count - start);\
+\
+		for (size_t i = 0; i < batch_count; ++i)\
+		{\
+			NAME##Node *node = NAME##_insert_node(table, keys[start + i], lengths[i], hashes[i]);\
+\
+			if (!node)\
+				return false;\
+\
+			node->value = values[start + i];\
+		}\
+\
+		start += batch_count;\
+	}\
+\
+	return true;\
+}
 
 #endif
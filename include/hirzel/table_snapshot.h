@@ -0,0 +1,281 @@
+#ifndef HIRZEL_TABLE_SNAPSHOT_H
+#define HIRZEL_TABLE_SNAPSHOT_H
+
+#include <stdint.h>
+
+#include <hirzel/table.h>
+#include <hirzel/file.h>
+
+/*
+ * Read-only file snapshots of a HIRZEL_TABLE whose TYPE can be copied byte for
+ * byte. NAME##_snapshot_write lays the keys out in an open addressed slot array
+ * followed by the key bytes, and NAME##Snapshot_open maps that file and answers
+ * lookups straight from it, so opening costs a header check however large the
+ * table is.
+ *
+ * Snapshots are in the byte order and struct layout of the machine that wrote
+ * them, and record the size of TYPE, the slot layout and a hash of a known key
+ * so that a mismatching reader or hash function is refused at open.
+ *
+ *	HIRZEL_TABLE_DECLARE(int, IntTable)
+ *	HIRZEL_TABLE_DEFINE(int, IntTable)
+ *	HIRZEL_TABLE_SNAPSHOT_DECLARE(int, IntTable)
+ *	HIRZEL_TABLE_SNAPSHOT_DEFINE(int, IntTable)
+ */
+
+#define HIRZEL_TABLE_SNAPSHOT_MAGIC "HZTBSNAP"
+#define HIRZEL_TABLE_SNAPSHOT_VERSION 2
+#define HIRZEL_TABLE_SNAPSHOT_MIN_CAPACITY 16
+
+typedef struct HirzelTableSnapshotHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t value_size;
+	uint64_t slot_size;
+	uint64_t capacity;
+	uint64_t count;
+	uint64_t keys_offset;
+	uint64_t keys_size;
+	uint64_t hash_check;
+} HirzelTableSnapshotHeader;
+
+// hashed at write and open, catching a snapshot opened with another hash function
+static inline uint64_t hirzel_table_snapshot_hash_check(size_t(*hash_function)(const char*, size_t))
+{
+	return (uint64_t)hash_function("hirzel-table-snapshot", 21);
+}
+
+#define HIRZEL_TABLE_SNAPSHOT_DECLARE(TYPE, NAME)\
+\
+typedef struct __##NAME##SnapshotSlot\
+{\
+	uint64_t hash;\
+	uint64_t key_offset;\
+	uint64_t key_length;\
+	TYPE value;\
+} NAME##SnapshotSlot;\
+\
+typedef struct __##NAME##Snapshot\
+{\
+	HirzelFileMap file;\
+	const NAME##SnapshotSlot *slots;\
+	size_t(*hash_function)(const char*, size_t);\
+	size_t capacity;\
+	size_t count;\
+} NAME##Snapshot;\
+\
+bool NAME##_snapshot_write(const NAME *table, const char *path);\
+bool NAME##Snapshot_open(NAME##Snapshot *snapshot, const char *path, size_t(*hash_function)(const char*, size_t));\
+void NAME##Snapshot_close(NAME##Snapshot *snapshot);\
+bool NAME##Snapshot_get(const NAME##Snapshot *snapshot, TYPE *out, const char *key);\
+bool NAME##Snapshot_get_n(const NAME##Snapshot *snapshot, TYPE *out, const char *key, size_t length);\
+const TYPE *NAME##Snapshot_get_ptr(const NAME##Snapshot *snapshot, const char *key);\
+const TYPE *NAME##Snapshot_get_ptr_n(const NAME##Snapshot *snapshot, const char *key, size_t length);\
+bool NAME##Snapshot_contains(const NAME##Snapshot *snapshot, const char *key);\
+bool NAME##Snapshot_contains_n(const NAME##Snapshot *snapshot, const char *key, size_t length);
+
+
+#define HIRZEL_TABLE_SNAPSHOT_DEFINE(TYPE, NAME)\
+\
+/* slot hashes are mixed so the low bits can pick the slot, whatever the table sizing */\
+static uint64_t NAME##Snapshot_hash(size_t(*hash_function)(const char*, size_t), const char *key, size_t length)\
+{\
+	return hirzel_hash_mix(hash_function(key, length));\
+}\
+\
+/* key offsets count from the start of the file, so 0 marks an empty slot */\
+bool NAME##_snapshot_write(const NAME *table, const char *path)\
+{\
+	assert(table != NULL);\
+	assert(path != NULL);\
+\
+	size_t capacity = HIRZEL_TABLE_SNAPSHOT_MIN_CAPACITY;\
+\
+	while (capacity < table->count * 2)\
+		capacity *= 2;\
+\
+	NAME##SnapshotSlot *slots = calloc(capacity, sizeof(NAME##SnapshotSlot));\
+\
+	if (!slots)\
+		return false;\
+\
+	uint64_t keys_offset = sizeof(HirzelTableSnapshotHeader) + (uint64_t)capacity * sizeof(NAME##SnapshotSlot);\
+	uint64_t keys_size = 0;\
+	size_t mask = capacity - 1;\
+	NAME##Iter iter = NAME##_iter_begin(table);\
+	const NAME##Node *node;\
+\
+	while ((node = NAME##_iter_next(table, &iter)))\
+	{\
+		uint64_t hash = NAME##Snapshot_hash(table->hash_function, node->key, node->key_length);\
+		size_t i = (size_t)hash & mask;\
+\
+		while (slots[i].key_offset)\
+			i = (i + 1) & mask;\
+\
+		slots[i].hash = hash;\
+		slots[i].key_offset = keys_offset + keys_size;\
+		slots[i].key_length = node->key_length;\
+		slots[i].value = node->value;\
+		keys_size += node->key_length + 1;\
+	}\
+\
+	HirzelTableSnapshotHeader header = {\
+		HIRZEL_TABLE_SNAPSHOT_MAGIC, HIRZEL_TABLE_SNAPSHOT_VERSION, sizeof(TYPE), sizeof(NAME##SnapshotSlot),\
+		capacity, table->count, keys_offset, keys_size, hirzel_table_snapshot_hash_check(table->hash_function)\
+	};\
+\
+	FILE *file = fopen(path, "wb");\
+\
+	if (!file)\
+	{\
+		free(slots);\
+		return false;\
+	}\
+\
+	bool is_written = fwrite(&header, sizeof(header), 1, file) == 1\
+		&& fwrite(slots, sizeof(NAME##SnapshotSlot), capacity, file) == capacity;\
+\
+	free(slots);\
+	iter = NAME##_iter_begin(table);\
+\
+	/* keys follow in the order their offsets were handed out above */\
+	while (is_written && (node = NAME##_iter_next(table, &iter)))\
+		is_written = fwrite(node->key, 1, node->key_length + 1, file) == node->key_length + 1;\
+\
+	is_written = !fclose(file) && is_written;\
+\
+	if (!is_written)\
+		remove(path);\
+\
+	return is_written;\
+}\
+\
+bool NAME##Snapshot_open(NAME##Snapshot *snapshot, const char *path, size_t(*hash_function)(const char*, size_t))\
+{\
+	assert(snapshot != NULL);\
+	assert(path != NULL);\
+\
+	if (!hash_function)\
+		hash_function = NAME##_hash_bytes;\
+\
+	HirzelFileMap file;\
+\
+	if (!hirzel_file_map(&file, path))\
+		return false;\
+\
+	HirzelTableSnapshotHeader header;\
+\
+	if (file.size < sizeof(header))\
+	{\
+		hirzel_file_unmap(&file);\
+		return false;\
+	}\
+\
+	memcpy(&header, file.data, sizeof(header));\
+\
+	uint64_t slots_end = sizeof(header) + header.capacity * sizeof(NAME##SnapshotSlot);\
+	bool is_valid = !memcmp(header.magic, HIRZEL_TABLE_SNAPSHOT_MAGIC, sizeof(header.magic))\
+		&& header.version == HIRZEL_TABLE_SNAPSHOT_VERSION\
+		&& header.value_size == sizeof(TYPE)\
+		&& header.slot_size == sizeof(NAME##SnapshotSlot)\
+		&& header.capacity > 0 && (header.capacity & (header.capacity - 1)) == 0\
+		&& header.count < header.capacity\
+		&& header.capacity <= (file.size - sizeof(header)) / sizeof(NAME##SnapshotSlot)\
+		&& header.keys_offset == slots_end\
+		&& header.keys_size <= file.size - slots_end\
+		&& header.hash_check == hirzel_table_snapshot_hash_check(hash_function);\
+\
+	if (!is_valid)\
+	{\
+		hirzel_file_unmap(&file);\
+		return false;\
+	}\
+\
+	snapshot->file = file;\
+	snapshot->slots = (const NAME##SnapshotSlot *)(file.data + sizeof(header));\
+	snapshot->hash_function = hash_function;\
+	snapshot->capacity = (size_t)header.capacity;\
+	snapshot->count = (size_t)header.count;\
+\
+	return true;\
+}\
+\
+void NAME##Snapshot_close(NAME##Snapshot *snapshot)\
+{\
+	assert(snapshot != NULL);\
+\
+	hirzel_file_unmap(&snapshot->file);\
+	snapshot->slots = NULL;\
+	snapshot->capacity = 0;\
+	snapshot->count = 0;\
+}\
+\
+const TYPE *NAME##Snapshot_get_ptr_n(const NAME##Snapshot *snapshot, const char *key, size_t length)\
+{\
+	assert(snapshot != NULL);\
+	assert(key != NULL);\
+\
+	uint64_t hash = NAME##Snapshot_hash(snapshot->hash_function, key, length);\
+	size_t mask = snapshot->capacity - 1;\
+	size_t i = (size_t)hash & mask;\
+\
+	/* capped at one pass over the slots, as a corrupt file may have no empty slot to stop at */\
+	for (size_t probes = 0; probes < snapshot->capacity && snapshot->slots[i].key_offset; ++probes)\
+	{\
+		const NAME##SnapshotSlot *slot = snapshot->slots + i;\
+\
+		/* offsets are checked against the file, as the slots aren't validated up front */\
+		if (slot->hash == hash && slot->key_length == length\
+			&& slot->key_offset <= snapshot->file.size && length < snapshot->file.size - slot->key_offset\
+			&& !memcmp(snapshot->file.data + slot->key_offset, key, length))\
+			return &slot->value;\
+\
+		i = (i + 1) & mask;\
+	}\
+\
+	return NULL;\
+}\
+\
+const TYPE *NAME##Snapshot_get_ptr(const NAME##Snapshot *snapshot, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##Snapshot_get_ptr_n(snapshot, key, strlen(key));\
+}\
+\
+bool NAME##Snapshot_get_n(const NAME##Snapshot *snapshot, TYPE *out, const char *key, size_t length)\
+{\
+	assert(out != NULL);\
+\
+	const TYPE *value = NAME##Snapshot_get_ptr_n(snapshot, key, length);\
+\
+	if (!value)\
+		return false;\
+\
+	*out = *value;\
+\
+	return true;\
+}\
+\
+bool NAME##Snapshot_get(const NAME##Snapshot *snapshot, TYPE *out, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##Snapshot_get_n(snapshot, out, key, strlen(key));\
+}\
+\
+bool NAME##Snapshot_contains_n(const NAME##Snapshot *snapshot, const char *key, size_t length)\
+{\
+	return NAME##Snapshot_get_ptr_n(snapshot, key, length) != NULL;\
+}\
+\
+bool NAME##Snapshot_contains(const NAME##Snapshot *snapshot, const char *key)\
+{\
+	assert(key != NULL);\
+\
+	return NAME##Snapshot_contains_n(snapshot, key, strlen(key));\
+}
+
+#endif
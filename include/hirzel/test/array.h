@@ -39,6 +39,10 @@ extern size_t hxarray_capacity(const HxArray *array);
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef HIRZEL_ARRAY_GROWTH
+#define HIRZEL_ARRAY_GROWTH(capacity) ((capacity) * 2)
+#endif
+
 struct HxArray {
 	void *data;
 	size_t element_size;
@@ -64,6 +68,26 @@ HxArray *hxarray_create(size_t element_size)
 	return out;
 }
 
+static bool hxarray_grow(HxArray *array, size_t min_capacity)
+{
+	assert(array != NULL);
+
+	size_t new_capacity = HIRZEL_ARRAY_GROWTH(array->capacity);
+
+	if (new_capacity < min_capacity)
+		new_capacity = min_capacity;
+
+	void *new_data = realloc(array->data, new_capacity * array->element_size);
+
+	if (!new_data)
+		return false;
+
+	array->data = new_data;
+	array->capacity = new_capacity;
+
+	return true;
+}
+
 void hxarray_destroy(HxArray *array)
 {
 	assert(array != NULL);
@@ -80,6 +104,7 @@ bool hxarray_reserve(HxArray *array, size_t capacity)
 	{
 		free(array->data);
 		array->data = NULL;
+		array->length = 0;
 	}
 	else
 	{
@@ -89,8 +114,13 @@ bool hxarray_reserve(HxArray *array, size_t capacity)
 			return false;
 
 		array->data = tmp;
+
+		if (capacity < array->length)
+			array->length = capacity;
 	}
 
+	array->capacity = capacity;
+
 	return true;
 }
 
@@ -101,41 +131,20 @@ bool hxarray_resize(HxArray *array, size_t new_length)
 	if (array->length == new_length)
 		return true;
 
-	if (new_length < array->length)
-	{
-		array->length = new_length;
-	}
-	else
-	{
-		size_t new_size = new_length * array->element_size;		
-		void *new_data = realloc(array->data, new_size);
-
-		if (!new_data)
-			return false;
+	if (new_length > array->capacity && !hxarray_grow(array, new_length))
+		return false;
 
-		array->data = new_data;
-		array->length = new_length;
-		array->capacity = new_length;
-	}
+	array->length = new_length;
 
-	return true;	
+	return true;
 }
 
 bool hxarray_increment_size(HxArray *array)
 {
 	assert(array != NULL);
 
-	if (array->length == array->capacity)
-	{
-		size_t new_size = (array->length + 1) * array->element_size;
-		void *new_buffer = realloc(array->data, new_size);
-
-		if (!new_buffer)
-			return false;
-
-		array->data = new_buffer;
-		array->capacity += 1;
-	}
+	if (array->length == array->capacity && !hxarray_grow(array, array->length + 1))
+		return false;
 
 	array->length += 1;
 
@@ -34,6 +34,8 @@ extern bool hxtable_is_empty(const HxTable *table);
 #include <string.h>
 #include <assert.h>
 
+#include <hirzel/hash.h>
+
 struct HxTableNode
 {
 	char *key;
@@ -335,19 +337,7 @@ size_t hxtable_hash_string(const char *string)
 {
 	assert(string != NULL);
 
-	const size_t p = 97;
-	const size_t m = 1000000009;
-	size_t hash = 0;
-	size_t pop = 1;
-
-	while (*string)
-	{
-		hash = (hash + (*string - 'a' + 1) * pop) % m;
-		pop = (pop * p) % m;
-		string += 1;
-	}
-
-	return hash;
+	return hirzel_hash_string(string);
 }
 
 bool hxtable_is_empty(const HxTable *table)
@@ -0,0 +1,91 @@
+#ifndef HIRZEL_THREAD_H
+#define HIRZEL_THREAD_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * Threading primitives shared by the concurrent containers: a reader-writer
+ * lock, yielding, and the few atomic operations they need. pthreads and the
+ * GCC / Clang __atomic builtins are used outside of Windows, as the library
+ * is built as C99 and can't rely on <stdatomic.h>.
+ */
+
+#define HIRZEL_CACHE_LINE 64
+
+#if defined(_WIN32)
+
+#include <windows.h>
+
+typedef SRWLOCK HirzelRwLock;
+
+static inline bool hirzel_rwlock_init(HirzelRwLock *lock) { InitializeSRWLock(lock); return true; }
+static inline void hirzel_rwlock_destroy(HirzelRwLock *lock) { (void)lock; }
+static inline void hirzel_rwlock_read(HirzelRwLock *lock) { AcquireSRWLockShared(lock); }
+static inline void hirzel_rwlock_read_unlock(HirzelRwLock *lock) { ReleaseSRWLockShared(lock); }
+static inline void hirzel_rwlock_write(HirzelRwLock *lock) { AcquireSRWLockExclusive(lock); }
+static inline void hirzel_rwlock_write_unlock(HirzelRwLock *lock) { ReleaseSRWLockExclusive(lock); }
+
+static inline void hirzel_thread_yield(void) { SwitchToThread(); }
+
+#else
+
+#include <pthread.h>
+#include <sched.h>
+
+typedef pthread_rwlock_t HirzelRwLock;
+
+static inline bool hirzel_rwlock_init(HirzelRwLock *lock) { return !pthread_rwlock_init(lock, NULL); }
+static inline void hirzel_rwlock_destroy(HirzelRwLock *lock) { pthread_rwlock_destroy(lock); }
+static inline void hirzel_rwlock_read(HirzelRwLock *lock) { pthread_rwlock_rdlock(lock); }
+static inline void hirzel_rwlock_read_unlock(HirzelRwLock *lock) { pthread_rwlock_unlock(lock); }
+static inline void hirzel_rwlock_write(HirzelRwLock *lock) { pthread_rwlock_wrlock(lock); }
+static inline void hirzel_rwlock_write_unlock(HirzelRwLock *lock) { pthread_rwlock_unlock(lock); }
+
+static inline void hirzel_thread_yield(void) { sched_yield(); }
+
+#endif
+
+#if defined(_MSC_VER)
+
+// aligned volatile accesses are acquire loads and release stores under /volatile:ms
+static inline size_t hirzel_atomic_load(volatile size_t *value) { return *value; }
+static inline void hirzel_atomic_store(volatile size_t *value, size_t desired) { *value = desired; }
+static inline void *hirzel_atomic_load_ptr(void *volatile *value) { return *value; }
+static inline void hirzel_atomic_store_ptr(void *volatile *value, void *desired) { *value = desired; }
+static inline void hirzel_atomic_fence(void) { MemoryBarrier(); }
+static inline void hirzel_atomic_store_seq_cst(volatile size_t *value, size_t desired) { InterlockedExchangePointer((void *volatile *)value, (void *)desired); }
+static inline void *hirzel_atomic_load_ptr_seq_cst(void *volatile *value) { return *value; }
+
+static inline bool hirzel_atomic_claim(volatile size_t *value)
+{
+	return InterlockedCompareExchangePointer((void *volatile *)value, (void *)1, NULL) == NULL;
+}
+
+#else
+
+static inline size_t hirzel_atomic_load(volatile size_t *value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+static inline void hirzel_atomic_store(volatile size_t *value, size_t desired) { __atomic_store_n(value, desired, __ATOMIC_RELEASE); }
+static inline void *hirzel_atomic_load_ptr(void *volatile *value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+static inline void hirzel_atomic_store_ptr(void *volatile *value, void *desired) { __atomic_store_n(value, desired, __ATOMIC_RELEASE); }
+static inline void hirzel_atomic_fence(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+/*
+ * A sequentially consistent store is ordered before a later sequentially
+ * consistent load, which acquire and release alone don't give, without a full
+ * fence: on ARMv8 the pair is stlr and ldar, and on x86 the store is an xchg.
+ */
+static inline void hirzel_atomic_store_seq_cst(volatile size_t *value, size_t desired) { __atomic_store_n(value, desired, __ATOMIC_SEQ_CST); }
+static inline void *hirzel_atomic_load_ptr_seq_cst(void *volatile *value) { return __atomic_load_n(value, __ATOMIC_SEQ_CST); }
+
+// sets a zeroed flag to 1, true if this call was the one to set it
+static inline bool hirzel_atomic_claim(volatile size_t *value)
+{
+	size_t expected = 0;
+
+	return __atomic_compare_exchange_n(value, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,170 @@
+#include <hirzel/allocator.h>
+#include <hirzel/array.h>
+#include <hirzel/table.h>
+
+HIRZEL_ARRAY_DECLARE(int, IntArray)
+HIRZEL_ARRAY_DEFINE(int, IntArray)
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, IntTable)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+#define ARRAYS_PER_REQUEST 16
+#define ITEMS_PER_ARRAY 200
+#define KEYS_PER_REQUEST 64
+#define POOL_LIVE_COUNT 4096
+
+void report(const char *name, size_t count, double seconds)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-28s %10zu ops %10.4f s %10.1f ns/op\n", name, count, seconds, ns);
+}
+
+/* the containers one request builds and drops, returning a checksum so none of it is optimized away */
+long long handle_request(const HirzelAllocator *allocator, size_t request)
+{
+	IntArray arrays[ARRAYS_PER_REQUEST];
+	IntTable table;
+	char key[32];
+	long long sum = 0;
+
+	for (size_t i = 0; i < ARRAYS_PER_REQUEST; ++i)
+	{
+		arrays[i] = IntArray_init_allocator(allocator);
+
+		for (size_t j = 0; j < ITEMS_PER_ARRAY; ++j)
+			IntArray_push(arrays + i, (int)(request + i + j));
+
+		sum += arrays[i].buffer[arrays[i].length - 1];
+	}
+
+	IntTable_init_allocator(&table, allocator);
+
+	for (size_t i = 0; i < KEYS_PER_REQUEST; ++i)
+	{
+		snprintf(key, sizeof(key), "header-%zu", i);
+		IntTable_set(&table, key, (int)i);
+	}
+
+	sum += (long long)table.count;
+
+	// with an arena these frees only roll back the newest allocation
+	IntTable_free(&table);
+
+	for (size_t i = 0; i < ARRAYS_PER_REQUEST; ++i)
+		IntArray_free(arrays + i);
+
+	return sum;
+}
+
+/*
+ * Builds and drops the arrays and table of one request at a time with malloc
+ * and with an arena reset between requests, then churns fixed size blocks
+ * through malloc and a pool, keeping POOL_LIVE_COUNT of them live.
+ */
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 20000;
+
+	printf("Benchmarking allocators on %zu requests...\n", count);
+
+	long long malloc_sum = 0;
+	double start = wall_seconds();
+
+	for (size_t i = 0; i < count; ++i)
+		malloc_sum += handle_request(NULL, i);
+
+	report("requests, malloc", count, wall_seconds() - start);
+
+	HirzelArena arena;
+	hirzel_arena_init(&arena, 0);
+	HirzelAllocator allocator = hirzel_arena_allocator(&arena);
+	long long arena_sum = 0;
+
+	start = wall_seconds();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		arena_sum += handle_request(&allocator, i);
+		hirzel_arena_reset(&arena);
+	}
+
+	report("requests, arena", count, wall_seconds() - start);
+	hirzel_arena_free(&arena);
+
+	if (malloc_sum != arena_sum)
+		printf("\tArena sum %lld doesn't match %lld\n", arena_sum, malloc_sum);
+
+	size_t churn_count = count * 500;
+	void **items = calloc(POOL_LIVE_COUNT, sizeof(void *));
+	unsigned seed = 1;
+
+	start = wall_seconds();
+
+	for (size_t i = 0; i < churn_count; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		size_t slot = (seed >> 8) % POOL_LIVE_COUNT;
+
+		free(items[slot]);
+		items[slot] = malloc(48);
+	}
+
+	report("48 byte churn, malloc", churn_count, wall_seconds() - start);
+
+	for (size_t i = 0; i < POOL_LIVE_COUNT; ++i)
+		free(items[i]);
+
+	HirzelPool pool;
+	hirzel_pool_init(&pool, 48, 0);
+
+	for (size_t i = 0; i < POOL_LIVE_COUNT; ++i)
+		items[i] = NULL;
+
+	seed = 1;
+	start = wall_seconds();
+
+	for (size_t i = 0; i < churn_count; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		size_t slot = (seed >> 8) % POOL_LIVE_COUNT;
+
+		hirzel_pool_dealloc(&pool, items[slot]);
+		items[slot] = hirzel_pool_alloc(&pool);
+	}
+
+	report("48 byte churn, pool", churn_count, wall_seconds() - start);
+
+	hirzel_pool_free(&pool);
+	free(items);
+
+	return 0;
+}
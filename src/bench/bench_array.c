@@ -0,0 +1,84 @@
+#include <hirzel/array.h>
+
+HIRZEL_ARRAY_DECLARE(int, IntArray)
+HIRZEL_ARRAY_DEFINE(int, IntArray)
+
+// growing by a single element reproduces the old append behaviour
+#undef HIRZEL_ARRAY_GROWTH
+#define HIRZEL_ARRAY_GROWTH(capacity) ((capacity) + 1)
+
+HIRZEL_ARRAY_DECLARE(int, ExactIntArray)
+HIRZEL_ARRAY_DEFINE(int, ExactIntArray)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+double seconds_since(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void report(const char *name, size_t count, double seconds)
+{
+	double rate = seconds > 0.0
+		? (double)count / seconds / 1e6
+		: 0.0;
+
+	printf("\t%-24s %10zu items %10.4f s %10.2f M items/s\n", name, count, seconds, rate);
+}
+
+void bench_push(size_t count)
+{
+	IntArray arr = IntArray_init();
+	clock_t start = clock();
+
+	for (size_t i = 0; i < count; ++i)
+		IntArray_push(&arr, (int)i);
+
+	report("push (geometric)", count, seconds_since(start));
+	IntArray_free(&arr);
+}
+
+void bench_push_exact(size_t count)
+{
+	ExactIntArray arr = ExactIntArray_init();
+	clock_t start = clock();
+
+	for (size_t i = 0; i < count; ++i)
+		ExactIntArray_push(&arr, (int)i);
+
+	report("push (exact)", count, seconds_since(start));
+	ExactIntArray_free(&arr);
+}
+
+void bench_insert(size_t count)
+{
+	IntArray arr = IntArray_init();
+	clock_t start = clock();
+
+	for (size_t i = 0; i < count; ++i)
+		IntArray_insert(&arr, arr.length, (int)i);
+
+	report("insert at end (geometric)", count, seconds_since(start));
+	IntArray_free(&arr);
+}
+
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 10000000;
+
+	puts("Benchmarking IntArray append...");
+
+	for (size_t n = count >= 100 ? count / 100 : count; n <= count; n *= 10)
+	{
+		bench_push(n);
+		bench_push_exact(n);
+		bench_insert(n);
+	}
+
+	return 0;
+}
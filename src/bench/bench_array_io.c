@@ -0,0 +1,141 @@
+#include <hirzel/array_io.h>
+
+typedef struct Sample
+{
+	double time;
+	float value;
+	int channel;
+} Sample;
+
+HIRZEL_ARRAY_DECLARE(Sample, SampleArray)
+HIRZEL_ARRAY_DEFINE(Sample, SampleArray)
+HIRZEL_ARRAY_IO_DECLARE(Sample, SampleArray)
+HIRZEL_ARRAY_IO_DEFINE(Sample, SampleArray)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+#define ARRAY_PATH "bench_array_io.bin"
+
+void report(const char *name, size_t count, double seconds)
+{
+	double rate = seconds > 0.0
+		? (double)(count * sizeof(Sample)) / seconds / 1e6
+		: 0.0;
+
+	printf("\t%-28s %10zu items %10.4f s %10.1f MB/s\n", name, count, seconds, rate);
+}
+
+double sum_samples(const Sample *samples, size_t count)
+{
+	double sum = 0.0;
+
+	for (size_t i = 0; i < count; ++i)
+		sum += samples[i].value;
+
+	return sum;
+}
+
+/*
+ * Writes and reads the same array one item per stdio call, as pipelines did
+ * before hirzel/array_io.h, and through write / read / map. Reads come from
+ * the page cache, as the file was just written.
+ */
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 8000000;
+	SampleArray array = SampleArray_init();
+	SampleArray copy = SampleArray_init();
+
+	for (size_t i = 0; i < count; ++i)
+		SampleArray_push(&array, (Sample) { i * 0.001, (float)(i % 1000), (int)(i % 16) });
+
+	printf("Benchmarking array io on %zu items (%zu MB)...\n", count, count * sizeof(Sample) >> 20);
+
+	double start = wall_seconds();
+	FILE *file = fopen(ARRAY_PATH, "wb");
+
+	for (size_t i = 0; i < count; ++i)
+		fwrite(array.buffer + i, sizeof(Sample), 1, file);
+
+	fclose(file);
+	report("fwrite per item", count, wall_seconds() - start);
+
+	start = wall_seconds();
+	file = fopen(ARRAY_PATH, "rb");
+	Sample sample;
+
+	while (fread(&sample, sizeof(Sample), 1, file) == 1)
+		SampleArray_push(&copy, sample);
+
+	fclose(file);
+	report("fread per item", copy.length, wall_seconds() - start);
+
+	start = wall_seconds();
+	file = fopen(ARRAY_PATH, "wb");
+	SampleArray_write(&array, file);
+	fclose(file);
+	report("write", count, wall_seconds() - start);
+
+	start = wall_seconds();
+	file = fopen(ARRAY_PATH, "rb");
+
+	if (!SampleArray_read(&copy, file))
+		puts("\tFailed to read array");
+
+	fclose(file);
+	report("read", copy.length, wall_seconds() - start);
+
+	double expected = sum_samples(array.buffer, array.length);
+	bool is_checksum_verified[] = { false, true };
+
+	for (size_t i = 0; i < 2; ++i)
+	{
+		SampleArrayMapping mapping;
+		start = wall_seconds();
+
+		if (!SampleArray_map(&mapping, ARRAY_PATH, is_checksum_verified[i]))
+		{
+			puts("\tFailed to map array");
+			continue;
+		}
+
+		double sum = sum_samples(mapping.buffer, mapping.length);
+
+		report(is_checksum_verified[i] ? "map verified + scan" : "map + scan", mapping.length, wall_seconds() - start);
+
+		if (sum != expected)
+			printf("\tMapped sum %f doesn't match %f\n", sum, expected);
+
+		SampleArray_unmap(&mapping);
+	}
+
+	remove(ARRAY_PATH);
+	SampleArray_free(&copy);
+	SampleArray_free(&array);
+
+	return 0;
+}
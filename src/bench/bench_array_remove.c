@@ -0,0 +1,127 @@
+#include <hirzel/array.h>
+
+typedef struct Entity
+{
+	float position[3];
+	float velocity[3];
+	int health;
+	int id;
+} Entity;
+
+HIRZEL_ARRAY_DECLARE(Entity, EntityArray)
+HIRZEL_ARRAY_DEFINE(Entity, EntityArray)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+void report(const char *name, size_t removed, size_t length, double seconds)
+{
+	printf("\t%-28s %10zu of %10zu removed %10.4f s\n", name, removed, length, seconds);
+}
+
+bool is_dead(const Entity *entity, void *context)
+{
+	(void)context;
+
+	return entity->health <= 0;
+}
+
+/* one in every kill_interval entities has died */
+EntityArray make_entities(size_t count, size_t kill_interval)
+{
+	EntityArray array = EntityArray_init();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		Entity entity = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, i % kill_interval == 0 ? 0 : 100, (int)i };
+		EntityArray_push(&array, entity);
+	}
+
+	return array;
+}
+
+/*
+ * Culls the dead entities of one tick with erase, swap_remove and remove_if,
+ * for a few death rates.
+ */
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 50000;
+	size_t kill_intervals[] = { 100, 10, 2 };
+
+	printf("Benchmarking culling %zu entities...\n", count);
+
+	for (size_t k = 0; k < sizeof(kill_intervals) / sizeof(kill_intervals[0]); ++k)
+	{
+		size_t removed = 0;
+		EntityArray array = make_entities(count, kill_intervals[k]);
+		double start = wall_seconds();
+
+		for (size_t i = 0; i < array.length;)
+		{
+			if (is_dead(array.buffer + i, NULL))
+			{
+				EntityArray_erase(&array, i);
+				removed += 1;
+			}
+			else
+			{
+				i += 1;
+			}
+		}
+
+		report("erase", removed, count, wall_seconds() - start);
+		EntityArray_free(&array);
+
+		removed = 0;
+		array = make_entities(count, kill_intervals[k]);
+		start = wall_seconds();
+
+		for (size_t i = 0; i < array.length;)
+		{
+			if (is_dead(array.buffer + i, NULL))
+			{
+				EntityArray_swap_remove(&array, i);
+				removed += 1;
+			}
+			else
+			{
+				i += 1;
+			}
+		}
+
+		report("swap_remove", removed, count, wall_seconds() - start);
+		EntityArray_free(&array);
+
+		array = make_entities(count, kill_intervals[k]);
+		start = wall_seconds();
+		removed = EntityArray_remove_if(&array, is_dead, NULL);
+		report("remove_if", removed, count, wall_seconds() - start);
+		EntityArray_free(&array);
+	}
+
+	return 0;
+}
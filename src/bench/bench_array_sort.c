@@ -0,0 +1,187 @@
+#include <hirzel/array_sort.h>
+
+typedef struct Order
+{
+	long long key;
+	double price;
+	int quantity;
+	int flags;
+} Order;
+
+#define ORDER_LESS(a, b) ((a)->key < (b)->key)
+
+HIRZEL_ARRAY_DECLARE(int, IntArray)
+HIRZEL_ARRAY_DEFINE(int, IntArray)
+HIRZEL_ARRAY_SORT_DECLARE(int, IntArray)
+HIRZEL_ARRAY_SORT_DEFINE(int, IntArray, HIRZEL_SORT_LESS)
+
+HIRZEL_ARRAY_DECLARE(Order, OrderArray)
+HIRZEL_ARRAY_DEFINE(Order, OrderArray)
+HIRZEL_ARRAY_SORT_DECLARE(Order, OrderArray)
+HIRZEL_ARRAY_SORT_DEFINE(Order, OrderArray, ORDER_LESS)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+void report(const char *name, size_t count, double seconds)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-28s %12zu items %10.4f s %8.1f ns/item\n", name, count, seconds, ns);
+}
+
+uint64_t random_state = 0x9E3779B97F4A7C15ull;
+
+uint64_t next_random(void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+
+	return random_state;
+}
+
+int compare_ints(const void *a, const void *b)
+{
+	int x = *(const int *)a;
+	int y = *(const int *)b;
+
+	return (x > y) - (x < y);
+}
+
+int compare_orders(const void *a, const void *b)
+{
+	long long x = ((const Order *)a)->key;
+	long long y = ((const Order *)b)->key;
+
+	return (x > y) - (x < y);
+}
+
+void fill_ints(IntArray *array, size_t count)
+{
+	random_state = 0x9E3779B97F4A7C15ull;
+	IntArray_resize(array, count);
+
+	for (size_t i = 0; i < count; ++i)
+		array->buffer[i] = (int)next_random();
+}
+
+void fill_orders(OrderArray *array, size_t count)
+{
+	random_state = 0x9E3779B97F4A7C15ull;
+	OrderArray_resize(array, count);
+
+	for (size_t i = 0; i < count; ++i)
+		array->buffer[i] = (Order) { (long long)(next_random() >> 1), (double)i, (int)i, 0 };
+}
+
+/*
+ * Sorts the same random ints and then 24 byte structs with qsort, sort and
+ * stable_sort, and looks every int up again with bsearch and lower_bound.
+ */
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 1000000;
+
+	printf("Benchmarking sorting %zu items...\n", count);
+
+	IntArray ints = IntArray_init();
+	double start;
+
+	fill_ints(&ints, count);
+	start = wall_seconds();
+	qsort(ints.buffer, ints.length, sizeof(int), compare_ints);
+	report("int qsort", count, wall_seconds() - start);
+
+	fill_ints(&ints, count);
+	start = wall_seconds();
+	IntArray_sort(&ints);
+	report("int sort", count, wall_seconds() - start);
+
+	fill_ints(&ints, count);
+	start = wall_seconds();
+
+	if (!IntArray_stable_sort(&ints))
+		puts("\tFailed to allocate merge buffer");
+
+	report("int stable_sort", count, wall_seconds() - start);
+
+	size_t found = 0;
+
+	start = wall_seconds();
+
+	for (size_t i = 0; i < count; ++i)
+		found += bsearch(ints.buffer + (i * 7919) % count, ints.buffer, ints.length, sizeof(int), compare_ints) != NULL;
+
+	report("int bsearch", count, wall_seconds() - start);
+	start = wall_seconds();
+
+	for (size_t i = 0; i < count; ++i)
+		found += IntArray_lower_bound(&ints, ints.buffer + (i * 7919) % count) < count;
+
+	report("int lower_bound", count, wall_seconds() - start);
+
+	if (found != count * 2)
+		puts("\tUnexpected lookup results");
+
+	IntArray_free(&ints);
+
+	OrderArray orders = OrderArray_init();
+
+	fill_orders(&orders, count);
+	start = wall_seconds();
+	qsort(orders.buffer, orders.length, sizeof(Order), compare_orders);
+	report("struct qsort", count, wall_seconds() - start);
+
+	fill_orders(&orders, count);
+	start = wall_seconds();
+	OrderArray_sort(&orders);
+	report("struct sort", count, wall_seconds() - start);
+
+	fill_orders(&orders, count);
+	start = wall_seconds();
+
+	if (!OrderArray_stable_sort(&orders))
+		puts("\tFailed to allocate merge buffer");
+
+	report("struct stable_sort", count, wall_seconds() - start);
+
+	for (size_t i = 1; i < orders.length; ++i)
+	{
+		if (orders.buffer[i].key < orders.buffer[i - 1].key)
+		{
+			puts("\tUnexpected order");
+			break;
+		}
+	}
+
+	OrderArray_free(&orders);
+
+	return 0;
+}
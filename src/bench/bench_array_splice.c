@@ -0,0 +1,106 @@
+#include <hirzel/array.h>
+
+typedef struct Record
+{
+	long long id;
+	double score;
+	int flags[4];
+} Record;
+
+HIRZEL_ARRAY_DECLARE(Record, RecordArray)
+HIRZEL_ARRAY_DEFINE(Record, RecordArray)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+void report(const char *name, size_t count, double seconds)
+{
+	printf("\t%-28s %10zu records %10.4f s\n", name, count, seconds);
+}
+
+RecordArray make_records(size_t count)
+{
+	RecordArray array = RecordArray_init();
+
+	for (size_t i = 0; i < count; ++i)
+		RecordArray_push(&array, (Record) { (long long)i, i * 0.5, { 0, 1, 2, 3 } });
+
+	return array;
+}
+
+/*
+ * Splices a batch of records into the middle of an array and erases them
+ * again, one record per call and then as a single range.
+ */
+int main(int argc, char **argv)
+{
+	size_t length = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 200000;
+	size_t count = argc > 2
+		? (size_t)strtoull(argv[2], NULL, 10)
+		: 5000;
+	RecordArray batch = make_records(count);
+
+	printf("Benchmarking splicing %zu records into %zu...\n", count, length);
+
+	RecordArray array = make_records(length);
+	double start = wall_seconds();
+
+	for (size_t i = 0; i < count; ++i)
+		RecordArray_insert_ptr(&array, length / 2 + i, batch.buffer + i);
+
+	report("insert per record", count, wall_seconds() - start);
+	start = wall_seconds();
+
+	for (size_t i = 0; i < count; ++i)
+		RecordArray_erase(&array, length / 2);
+
+	report("erase per record", count, wall_seconds() - start);
+	RecordArray_free(&array);
+
+	array = make_records(length);
+	start = wall_seconds();
+	RecordArray_insert_range(&array, length / 2, batch.buffer, count);
+	report("insert_range", count, wall_seconds() - start);
+
+	start = wall_seconds();
+	RecordArray_erase_range(&array, length / 2, count);
+	report("erase_range", count, wall_seconds() - start);
+
+	start = wall_seconds();
+
+	for (size_t i = 0; i < 100; ++i)
+		RecordArray_append_array(&array, &batch);
+
+	report("append_array x100", count * 100, wall_seconds() - start);
+
+	if (array.length != length + count * 100 || array.buffer[length].id != 0)
+		puts("\tUnexpected array contents");
+
+	RecordArray_free(&array);
+	RecordArray_free(&batch);
+
+	return 0;
+}
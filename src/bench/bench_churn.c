@@ -0,0 +1,163 @@
+#include <hirzel/table.h>
+#include <hirzel/robin_table.h>
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE(int, IntTable)
+
+HIRZEL_TABLE_DECLARE(int, PowIntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, PowIntTable)
+
+HIRZEL_ROBIN_TABLE_DECLARE(int, IntRobinTable)
+HIRZEL_ROBIN_TABLE_DEFINE(int, IntRobinTable)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define KEY_STRIDE 32
+
+/*
+ * Probe lengths of every live key, counting the home slot as 1. Tables walk
+ * their probe sequence up to the node, which includes any tombstones on it.
+ */
+#define TABLE_PROBE_LENGTHS(NAME, SIZING)\
+size_t NAME##_probe_lengths(const NAME *table, size_t *out)\
+{\
+	size_t size = NAME##_sizes[table->size_index];\
+	size_t count = 0;\
+\
+	for (size_t n = 0; n < size; ++n)\
+	{\
+		const NAME##Node *node = table->data + n;\
+\
+		if (!node->key)\
+			continue;\
+\
+		size_t i = SIZING##_INDEX(node->hash, size);\
+		size_t step = 0;\
+\
+		while (i != n)\
+		{\
+			step += 1;\
+			i = SIZING##_PROBE(node->hash, i, step, size);\
+		}\
+\
+		out[count++] = step + 1;\
+	}\
+\
+	return count;\
+}
+
+TABLE_PROBE_LENGTHS(IntTable, HIRZEL_TABLE_PRIME)
+TABLE_PROBE_LENGTHS(PowIntTable, HIRZEL_TABLE_POW2)
+
+size_t IntRobinTable_probe_lengths(const IntRobinTable *table, size_t *out)
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < table->capacity; ++i)
+	{
+		if (table->slots[i].distance > 0)
+			out[count++] = table->slots[i].distance;
+	}
+
+	return count;
+}
+
+double seconds_since(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int compare_size(const void *a, const void *b)
+{
+	size_t x = *(const size_t *)a;
+	size_t y = *(const size_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+double ns_per_op(double seconds, size_t count)
+{
+	return count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+}
+
+/*
+ * A cache holding `live` keys: each step inserts a new key and erases the
+ * oldest. After every round the probe length distribution of the live keys and
+ * the cost of looking them all up are reported.
+ */
+#define BENCH_CHURN(NAME, keys, live, rounds)\
+do\
+{\
+	NAME table;\
+	NAME##_init(&table);\
+	size_t *lengths = malloc((live) * sizeof(size_t));\
+	size_t next = 0;\
+\
+	printf("%s\n\t%5s %12s %12s %6s %6s %6s %10s\n", #NAME, "round", "churn ns/op", "hit ns/op", "p50", "p99", "max", "slots");\
+\
+	for (; next < (live); ++next)\
+		NAME##_set(&table, keys + next * KEY_STRIDE, (int)next);\
+\
+	for (size_t round = 0; round <= (rounds); ++round)\
+	{\
+		clock_t start = clock();\
+		size_t steps = round > 0 ? (live) * 2 : 0;\
+\
+		for (size_t i = 0; i < steps; ++i, ++next)\
+		{\
+			NAME##_set(&table, keys + next * KEY_STRIDE, (int)next);\
+			NAME##_erase(&table, keys + (next - (live)) * KEY_STRIDE);\
+		}\
+\
+		double churn_seconds = seconds_since(start);\
+		size_t found = 0;\
+		start = clock();\
+\
+		for (size_t i = next - (live); i < next; ++i)\
+			found += NAME##_contains(&table, keys + i * KEY_STRIDE);\
+\
+		double hit_seconds = seconds_since(start);\
+		size_t count = NAME##_probe_lengths(&table, lengths);\
+\
+		qsort(lengths, count, sizeof(size_t), compare_size);\
+\
+		printf("\t%5zu %12.1f %12.1f %6zu %6zu %6zu %10zu\n", round,\
+			ns_per_op(churn_seconds, steps), ns_per_op(hit_seconds, (live)),\
+			lengths[count / 2], lengths[count * 99 / 100], lengths[count - 1], NAME##_size(&table));\
+\
+		if (found != (live))\
+			printf("\t%s found %zu of %zu keys\n", #NAME, found, (size_t)(live));\
+	}\
+\
+	free(lengths);\
+	NAME##_free(&table);\
+} while (0)
+
+int main(int argc, char **argv)
+{
+	size_t live = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 100000;
+	size_t rounds = 10;
+	size_t key_count = live + rounds * live * 2;
+	char *keys = malloc(key_count * KEY_STRIDE);
+
+	for (size_t i = 0; i < key_count; ++i)
+		snprintf(keys + i * KEY_STRIDE, KEY_STRIDE, "session-%zu", i);
+
+	puts("Benchmarking insert / erase churn...");
+
+	BENCH_CHURN(IntTable, keys, live, rounds);
+	BENCH_CHURN(PowIntTable, keys, live, rounds);
+	BENCH_CHURN(IntRobinTable, keys, live, rounds);
+
+	free(keys);
+
+	return 0;
+}
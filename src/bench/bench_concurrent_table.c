@@ -0,0 +1,209 @@
+#include <hirzel/concurrent_table.h>
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, IntTable)
+
+HIRZEL_CONCURRENT_TABLE_DECLARE(int, SharedIntTable)
+HIRZEL_CONCURRENT_TABLE_DEFINE(int, SharedIntTable)
+
+// standard library
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+typedef HANDLE Thread;
+typedef LPTHREAD_START_ROUTINE ThreadFunction;
+#define THREAD_RETURN DWORD WINAPI
+#define start_thread(thread, function, arg) (*(thread) = CreateThread(NULL, 0, function, arg, 0, NULL))
+#define join_thread(thread) (WaitForSingleObject(thread, INFINITE), CloseHandle(thread))
+
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+typedef pthread_t Thread;
+typedef void *(*ThreadFunction)(void *);
+#define THREAD_RETURN void *
+#define start_thread(thread, function, arg) pthread_create(thread, NULL, function, arg)
+#define join_thread(thread) pthread_join(thread, NULL)
+
+// clock() adds up the cpu time of every thread, so scaling needs wall time
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+#define MAX_THREADS 64
+#define KEY_STRIDE 32
+
+typedef struct Workload
+{
+	const char *keys;
+	size_t key_count;
+	size_t ops_per_thread;
+	unsigned write_percent;
+} Workload;
+
+// the status quo: one table behind one lock
+typedef struct LockedTable
+{
+	HirzelRwLock lock;
+	IntTable table;
+} LockedTable;
+
+typedef struct Worker
+{
+	const Workload *workload;
+	LockedTable *locked;
+	SharedIntTable *shared;
+	uint64_t seed;
+	size_t found;
+} Worker;
+
+static uint64_t next_random(uint64_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+THREAD_RETURN run_locked(void *arg)
+{
+	Worker *worker = arg;
+	const Workload *workload = worker->workload;
+
+	for (size_t i = 0; i < workload->ops_per_thread; ++i)
+	{
+		uint64_t random = next_random(&worker->seed);
+		const char *key = workload->keys + (random >> 8) % workload->key_count * KEY_STRIDE;
+
+		hirzel_rwlock_write(&worker->locked->lock);
+
+		if (random % 100 < workload->write_percent)
+			IntTable_set(&worker->locked->table, key, (int)i);
+		else
+			worker->found += IntTable_contains(&worker->locked->table, key);
+
+		hirzel_rwlock_write_unlock(&worker->locked->lock);
+	}
+
+	return 0;
+}
+
+THREAD_RETURN run_shared(void *arg)
+{
+	Worker *worker = arg;
+	const Workload *workload = worker->workload;
+
+	for (size_t i = 0; i < workload->ops_per_thread; ++i)
+	{
+		uint64_t random = next_random(&worker->seed);
+		const char *key = workload->keys + (random >> 8) % workload->key_count * KEY_STRIDE;
+
+		if (random % 100 < workload->write_percent)
+			SharedIntTable_set(worker->shared, key, (int)i);
+		else
+			worker->found += SharedIntTable_contains(worker->shared, key);
+	}
+
+	return 0;
+}
+
+double run_threads(ThreadFunction function, Worker *workers, size_t thread_count)
+{
+	Thread threads[MAX_THREADS];
+	double start = wall_seconds();
+
+	for (size_t i = 0; i < thread_count; ++i)
+		start_thread(threads + i, function, workers + i);
+
+	for (size_t i = 0; i < thread_count; ++i)
+		join_thread(threads[i]);
+
+	return wall_seconds() - start;
+}
+
+void bench_workload(const Workload *base, size_t total_ops)
+{
+	printf("\t%u%% writes\n\t%8s %14s %14s\n", base->write_percent, "threads", "mutex Mops/s", "sharded Mops/s");
+
+	LockedTable locked;
+	hirzel_rwlock_init(&locked.lock);
+	IntTable_init(&locked.table);
+
+	SharedIntTable shared;
+	SharedIntTable_init(&shared, 0);
+
+	// both start full so reads hit and writes overwrite
+	for (size_t i = 0; i < base->key_count; ++i)
+	{
+		IntTable_set(&locked.table, base->keys + i * KEY_STRIDE, (int)i);
+		SharedIntTable_set(&shared, base->keys + i * KEY_STRIDE, (int)i);
+	}
+
+	for (size_t thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2)
+	{
+		Workload workload = *base;
+		Worker workers[MAX_THREADS];
+
+		workload.ops_per_thread = total_ops / thread_count;
+
+		for (size_t i = 0; i < thread_count; ++i)
+			workers[i] = (Worker) { &workload, &locked, &shared, 0x9e3779b97f4a7c15ull * (i + 1), 0 };
+
+		double locked_seconds = run_threads(run_locked, workers, thread_count);
+
+		for (size_t i = 0; i < thread_count; ++i)
+			workers[i].seed = 0x9e3779b97f4a7c15ull * (i + 1);
+
+		double shared_seconds = run_threads(run_shared, workers, thread_count);
+		double ops = (double)(workload.ops_per_thread * thread_count);
+
+		printf("\t%8zu %14.2f %14.2f\n", thread_count, ops / locked_seconds / 1e6, ops / shared_seconds / 1e6);
+	}
+
+	hirzel_rwlock_destroy(&locked.lock);
+	IntTable_free(&locked.table);
+	SharedIntTable_free(&shared);
+}
+
+int main(int argc, char **argv)
+{
+	size_t total_ops = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 4000000;
+
+	size_t key_count = 100000;
+	char *keys = malloc(key_count * KEY_STRIDE);
+
+	for (size_t i = 0; i < key_count; ++i)
+		snprintf(keys + i * KEY_STRIDE, KEY_STRIDE, "https://example.com/%zu", i);
+
+	puts("Benchmarking concurrent tables...");
+
+	const unsigned write_percents[] = { 0, 10, 50 };
+
+	for (size_t i = 0; i < sizeof(write_percents) / sizeof(*write_percents); ++i)
+	{
+		Workload workload = { keys, key_count, 0, write_percents[i] };
+		bench_workload(&workload, total_ops);
+	}
+
+	free(keys);
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <hirzel/table.h>
+#include <hirzel/dense_table.h>
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, IntTable)
+
+HIRZEL_DENSE_TABLE_DECLARE(int, IntDenseTable)
+HIRZEL_DENSE_TABLE_DEFINE(int, IntDenseTable)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define KEY_STRIDE 32
+#define SCAN_ROUNDS 20
+
+double seconds_since(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void report(const char *name, const char *operation, size_t count, double seconds)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-14s %-8s %10zu ops %10.4f s %8.2f ns/op\n", name, operation, count, seconds, ns);
+}
+
+/*
+ * Loads a table, erases all but every keep-th key and times full scans of what
+ * is left, along with lookups of the surviving keys.
+ */
+#define BENCH_SCAN(NAME, keys, count, keep)\
+do\
+{\
+	NAME table;\
+	NAME##_init(&table);\
+	clock_t start = clock();\
+\
+	for (size_t i = 0; i < (count); ++i)\
+		NAME##_set(&table, keys + i * KEY_STRIDE, (int)i);\
+\
+	report(#NAME, "insert", (count), seconds_since(start));\
+\
+	for (size_t i = 0; i < (count); ++i)\
+	{\
+		if (i % (keep) != 0)\
+			NAME##_erase(&table, keys + i * KEY_STRIDE);\
+	}\
+\
+	long long sum = 0;\
+	start = clock();\
+\
+	for (size_t round = 0; round < SCAN_ROUNDS; ++round)\
+	{\
+		NAME##Iter iter = NAME##_iter_begin(&table);\
+		const NAME##Entry *entry;\
+\
+		while ((entry = NAME##_iter_next(&table, &iter)))\
+			sum += entry->value;\
+	}\
+\
+	report(#NAME, "scan", table.count * SCAN_ROUNDS, seconds_since(start));\
+\
+	size_t found = 0;\
+	start = clock();\
+\
+	for (size_t i = 0; i < (count); i += (keep))\
+		found += NAME##_contains(&table, keys + i * KEY_STRIDE);\
+\
+	report(#NAME, "lookup", found, seconds_since(start));\
+	printf("\t%-14s checksum %lld\n", #NAME, sum);\
+\
+	NAME##_free(&table);\
+} while (0)
+
+// table nodes stand in for entries so both tables share BENCH_SCAN
+typedef IntTableNode IntTableEntry;
+
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 1000000;
+	char *keys = malloc(count * KEY_STRIDE);
+
+	for (size_t i = 0; i < count; ++i)
+		snprintf(keys + i * KEY_STRIDE, KEY_STRIDE, "entry-%zu", i);
+
+	size_t keeps[] = { 1, 4, 16 };
+
+	for (size_t k = 0; k < sizeof(keeps) / sizeof(*keeps); ++k)
+	{
+		printf("Benchmarking scans keeping 1 in %zu keys...\n", keeps[k]);
+		BENCH_SCAN(IntTable, keys, count, keeps[k]);
+		BENCH_SCAN(IntDenseTable, keys, count, keeps[k]);
+	}
+
+	free(keys);
+
+	return 0;
+}
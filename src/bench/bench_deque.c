@@ -0,0 +1,95 @@
+#include <hirzel/array.h>
+#include <hirzel/deque.h>
+
+HIRZEL_ARRAY_DECLARE(int, IntArray)
+HIRZEL_ARRAY_DEFINE(int, IntArray)
+
+HIRZEL_DEQUE_DECLARE(int, IntDeque)
+HIRZEL_DEQUE_DEFINE(int, IntDeque)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+void report(const char *name, size_t depth, size_t count, double seconds)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-12s depth %8zu %10zu ops %10.4f s %10.1f ns/op\n", name, depth, count, seconds, ns);
+}
+
+/* a work queue holding depth items, each op taking one from the front and adding one at the back */
+#define BENCH_QUEUE(NAME, LABEL, DEPTH, COUNT)\
+do\
+{\
+	NAME queue = NAME##_init();\
+	size_t queue_depth = (DEPTH);\
+	size_t op_count = (COUNT);\
+	long long sum = 0;\
+\
+	for (size_t j = 0; j < queue_depth; ++j)\
+		NAME##_push(&queue, (int)j);\
+\
+	double start = wall_seconds();\
+\
+	for (size_t j = 0; j < op_count; ++j)\
+	{\
+		sum += NAME##_front(&queue);\
+		NAME##_popf(&queue);\
+		NAME##_push(&queue, (int)j);\
+	}\
+\
+	report(LABEL, queue_depth, op_count, wall_seconds() - start);\
+\
+	if (sum < 0)\
+		puts("\tUnexpected sum");\
+\
+	NAME##_free(&queue);\
+} while (0)
+
+/*
+ * Runs a FIFO work queue at several depths on an array, whose popf shifts
+ * every item, and on a deque. The array gets fewer ops at larger depths so it
+ * finishes in reasonable time.
+ */
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 10000000;
+	size_t depths[] = { 16, 1024, 65536, 262144 };
+
+	printf("Benchmarking deque as a work queue...\n");
+
+	for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); ++i)
+	{
+		size_t array_count = count / depths[i] * 16;
+
+		BENCH_QUEUE(IntArray, "array", depths[i], array_count);
+		BENCH_QUEUE(IntDeque, "deque", depths[i], count);
+	}
+
+	return 0;
+}
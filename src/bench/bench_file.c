@@ -0,0 +1,173 @@
+#include <hirzel/file.h>
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+#define LOG_PATH "bench_file.log"
+#define LINE_FORMAT "2024-05-%02zu 12:%02zu:%02zu [worker-%zu] request %zu finished in %zu us\n"
+
+void report(const char *name, size_t lines, size_t bytes, double seconds)
+{
+	double rate = seconds > 0.0
+		? (double)bytes / seconds / 1e6
+		: 0.0;
+
+	printf("\t%-28s %10zu lines %10.4f s %10.1f MB/s\n", name, lines, seconds, rate);
+}
+
+/*
+ * Writes a log file with fprintf and the buffered writer, then counts its
+ * lines and bytes with fgets, the reader and a mapping. Reads come from the
+ * page cache, as the file was just written; pass a line count large enough to
+ * make a multi-GB file to compare them on logs of that size.
+ */
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 4000000;
+
+	printf("Benchmarking file io on %zu log lines...\n", count);
+
+	double start = wall_seconds();
+	FILE *file = fopen(LOG_PATH, "wb");
+
+	for (size_t i = 0; i < count; ++i)
+		fprintf(file, LINE_FORMAT, i % 28 + 1, i % 60, i % 59, i % 16, i, i % 9973);
+
+	size_t size = (size_t)ftell(file);
+
+	fclose(file);
+	report("fprintf", count, size, wall_seconds() - start);
+
+	start = wall_seconds();
+	HirzelFileWriter writer;
+
+	if (!hirzel_file_writer_open(&writer, LOG_PATH, 0))
+	{
+		puts("Failed to open writer");
+		return 1;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+		hirzel_file_writer_printf(&writer, LINE_FORMAT, i % 28 + 1, i % 60, i % 59, i % 16, i, i % 9973);
+
+	if (!hirzel_file_writer_close(&writer))
+		puts("\tFailed to write log");
+
+	report("writer printf", count, size, wall_seconds() - start);
+
+	// formatting dominates both of the above, so the same line is also written as is
+	char text[256];
+	size_t text_length = (size_t)snprintf(text, sizeof(text), LINE_FORMAT, (size_t)1, (size_t)2, (size_t)3, (size_t)4, (size_t)5, (size_t)6);
+
+	start = wall_seconds();
+	file = fopen(LOG_PATH, "wb");
+
+	for (size_t i = 0; i < count; ++i)
+		fwrite(text, 1, text_length, file);
+
+	fclose(file);
+	report("fwrite", count, count * text_length, wall_seconds() - start);
+
+	start = wall_seconds();
+	hirzel_file_writer_open(&writer, LOG_PATH, 0);
+
+	for (size_t i = 0; i < count; ++i)
+		hirzel_file_writer_write(&writer, text, text_length);
+
+	if (!hirzel_file_writer_close(&writer))
+		puts("\tFailed to write log");
+
+	report("writer write", count, count * text_length, wall_seconds() - start);
+
+	// reads the fixed lines written last, capped in length so fgets sees each whole
+	char line[256];
+	size_t lines = 0;
+	size_t bytes = 0;
+
+	start = wall_seconds();
+	file = fopen(LOG_PATH, "rb");
+
+	while (fgets(line, sizeof(line), file))
+	{
+		lines += 1;
+		bytes += strlen(line);
+	}
+
+	fclose(file);
+	report("fgets", lines, bytes, wall_seconds() - start);
+
+	HirzelFileReader reader;
+	HirzelFileSlice slice;
+
+	lines = 0;
+	bytes = 0;
+	start = wall_seconds();
+
+	if (!hirzel_file_reader_open(&reader, LOG_PATH, 0))
+	{
+		puts("Failed to open reader");
+		return 1;
+	}
+
+	while (hirzel_file_reader_next(&reader, '\n', &slice))
+	{
+		lines += 1;
+		bytes += slice.length + 1;
+	}
+
+	hirzel_file_reader_close(&reader);
+	report("reader", lines, bytes, wall_seconds() - start);
+
+	HirzelFileMap map;
+
+	lines = 0;
+	start = wall_seconds();
+
+	if (!hirzel_file_map(&map, LOG_PATH))
+	{
+		puts("Failed to map log");
+		return 1;
+	}
+
+	const char *end = map.data + map.size;
+
+	for (const char *data = map.data; data < end; ++lines)
+	{
+		const char *newline = memchr(data, '\n', (size_t)(end - data));
+
+		data = newline
+			? newline + 1
+			: end;
+	}
+
+	report("map + memchr", lines, map.size, wall_seconds() - start);
+	hirzel_file_unmap(&map);
+
+	remove(LOG_PATH);
+
+	return 0;
+}
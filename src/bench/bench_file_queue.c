@@ -0,0 +1,154 @@
+#include <hirzel/array_io.h>
+
+HIRZEL_ARRAY_DECLARE(char, CharArray)
+HIRZEL_ARRAY_DEFINE(char, CharArray)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+#define DATA_PATH "bench_file_queue.bin"
+
+void report(const char *name, size_t bytes, double seconds)
+{
+	double rate = seconds > 0.0
+		? (double)bytes / seconds / 1e6
+		: 0.0;
+
+	printf("\t%-28s %10zu MB %10.4f s %10.1f MB/s\n", name, bytes >> 20, seconds, rate);
+}
+
+// stands in for the work done on each block, so reads have something to overlap
+unsigned long long sum_bytes(const char *data, size_t length)
+{
+	unsigned long long sum = 0;
+
+	for (size_t i = 0; i < length; ++i)
+		sum += (unsigned char)data[i];
+
+	return sum;
+}
+
+/*
+ * Reads a file of the given size in MB a block at a time with fread, then
+ * with HirzelFileBlocks at a few queue depths, then whole into an array
+ * buffer. Configure with HIRZEL_FILE_IO_URING=ON to compare io_uring with
+ * the pread fallback. Reads come from the page cache unless it is dropped
+ * between runs.
+ */
+int main(int argc, char **argv)
+{
+	size_t size = (argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 512) << 20;
+	char *block = malloc(HIRZEL_FILE_BLOCK_SIZE);
+
+#if defined(HIRZEL_FILE_IO_URING)
+	const char *mode = "io_uring";
+#else
+	const char *mode = "pread";
+#endif
+
+	printf("Benchmarking file queue (%s) on %zu MB...\n", mode, size >> 20);
+
+	FILE *file = fopen(DATA_PATH, "wb");
+
+	for (size_t i = 0; i < HIRZEL_FILE_BLOCK_SIZE; ++i)
+		block[i] = (char)(i * 31);
+
+	for (size_t i = 0; i < size; i += HIRZEL_FILE_BLOCK_SIZE)
+		fwrite(block, 1, HIRZEL_FILE_BLOCK_SIZE, file);
+
+	fclose(file);
+
+	double start = wall_seconds();
+	unsigned long long expected = 0;
+	size_t read_size;
+
+	file = fopen(DATA_PATH, "rb");
+
+	while ((read_size = fread(block, 1, HIRZEL_FILE_BLOCK_SIZE, file)) > 0)
+		expected += sum_bytes(block, read_size);
+
+	fclose(file);
+	report("fread", size, wall_seconds() - start);
+
+	size_t depths[] = { 1, 4, 16 };
+
+	for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); ++i)
+	{
+		HirzelFileBlocks blocks;
+		HirzelFileSlice slice;
+		unsigned long long sum = 0;
+		char name[32];
+
+		start = wall_seconds();
+
+		if (!hirzel_file_blocks_open(&blocks, DATA_PATH, 0, depths[i]))
+		{
+			puts("\tFailed to open blocks");
+			continue;
+		}
+
+		while (hirzel_file_blocks_next(&blocks, &slice))
+			sum += sum_bytes(slice.data, slice.length);
+
+		hirzel_file_blocks_close(&blocks);
+		snprintf(name, sizeof(name), "blocks, depth %zu", depths[i]);
+		report(name, size, wall_seconds() - start);
+
+		if (sum != expected)
+			printf("\tSum %llu doesn't match %llu\n", sum, expected);
+	}
+
+	CharArray array = CharArray_init();
+	HirzelFileQueue queue;
+
+	start = wall_seconds();
+
+	if (!hirzel_file_queue_open(&queue, DATA_PATH, 0))
+	{
+		puts("\tFailed to open queue");
+	}
+	else
+	{
+		if (!CharArray_resize(&array, (size_t)queue.size)
+			|| !hirzel_file_queue_read(&queue, array.buffer, array.length, 0, 0))
+		{
+			puts("\tFailed to read into array");
+		}
+
+		hirzel_file_queue_close(&queue);
+		report("queue read into array", array.length, wall_seconds() - start);
+
+		if (sum_bytes(array.buffer, array.length) != expected)
+			puts("\tArray doesn't match the file");
+	}
+
+	CharArray_free(&array);
+	remove(DATA_PATH);
+	free(block);
+
+	return 0;
+}
@@ -0,0 +1,194 @@
+#include <hirzel/hash.h>
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// the polynomial hash the tables used before hirzel/hash.h
+size_t legacy_hash_string(const char *string)
+{
+	const size_t p = 97;
+	const size_t m = 1000000009;
+	size_t hash = 0;
+	size_t pop = 1;
+
+	while (*string)
+	{
+		hash = (hash + (*string - 'a' + 1) * pop) % m;
+		pop = (pop * p) % m;
+		string += 1;
+	}
+
+	return hash;
+}
+
+typedef size_t (*HashFunction)(const char *);
+
+typedef struct HashCase
+{
+	const char *name;
+	HashFunction function;
+} HashCase;
+
+const HashCase hash_cases[] = {
+	{ "legacy", legacy_hash_string },
+	{ "hirzel", hirzel_hash_string }
+};
+
+const size_t hash_case_count = sizeof(hash_cases) / sizeof(*hash_cases);
+
+double seconds_since(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int compare_size(const void *a, const void *b)
+{
+	size_t x = *(const size_t *)a;
+	size_t y = *(const size_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+void bench_throughput(const HashCase *hash_case, size_t length, size_t total_bytes)
+{
+	char *key = malloc(length + 1);
+
+	for (size_t i = 0; i < length; ++i)
+		key[i] = 'a' + (char)(i % 26);
+
+	key[length] = '\0';
+
+	size_t iterations = total_bytes / length;
+	size_t sink = 0;
+	clock_t start = clock();
+
+	for (size_t i = 0; i < iterations; ++i)
+	{
+		key[0] = 'a' + (char)(i % 26);
+		sink += hash_case->function(key);
+	}
+
+	double seconds = seconds_since(start);
+	double gbps = seconds > 0.0
+		? (double)(iterations * length) / seconds / 1e9
+		: 0.0;
+
+	printf("\t%-8s %6zu bytes %8.3f GB/s %12.1f M hashes/s (%zx)\n",
+		hash_case->name, length, gbps, (double)iterations / seconds / 1e6, sink & 0xf);
+
+	free(key);
+}
+
+void bench_quality(const HashCase *hash_case, const char *kind, char **keys, size_t count)
+{
+	size_t *hashes = malloc(count * sizeof(size_t));
+
+	for (size_t i = 0; i < count; ++i)
+		hashes[i] = hash_case->function(keys[i]);
+
+	// distribution over a power of two bucket count, as used by the tables
+	size_t bucket_count = 1;
+
+	while (bucket_count < count)
+		bucket_count *= 2;
+
+	size_t *buckets = calloc(bucket_count, sizeof(size_t));
+
+	for (size_t i = 0; i < count; ++i)
+		buckets[hashes[i] & (bucket_count - 1)] += 1;
+
+	double expected = (double)count / (double)bucket_count;
+	double chi_squared = 0.0;
+	size_t max_load = 0;
+
+	for (size_t i = 0; i < bucket_count; ++i)
+	{
+		double difference = (double)buckets[i] - expected;
+		chi_squared += difference * difference / expected;
+
+		if (buckets[i] > max_load)
+			max_load = buckets[i];
+	}
+
+	qsort(hashes, count, sizeof(size_t), compare_size);
+
+	size_t collisions = 0;
+
+	for (size_t i = 1; i < count; ++i)
+	{
+		if (hashes[i] == hashes[i - 1])
+			collisions += 1;
+	}
+
+	// chi squared divided by its degrees of freedom is ~1.0 for a uniform hash
+	printf("\t%-8s %-8s %9zu keys %9zu full collisions %8.3f chi2/df %4zu max bucket\n",
+		hash_case->name, kind, count, collisions, chi_squared / (double)(bucket_count - 1), max_load);
+
+	free(buckets);
+	free(hashes);
+}
+
+char **make_keys(const char *format, size_t count)
+{
+	char **keys = malloc(count * sizeof(char*));
+	char buffer[128];
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		int length = sprintf(buffer, format, i);
+		keys[i] = malloc(length + 1);
+		memcpy(keys[i], buffer, length + 1);
+	}
+
+	return keys;
+}
+
+void free_keys(char **keys, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		free(keys[i]);
+
+	free(keys);
+}
+
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 1000000;
+
+	const size_t lengths[] = { 8, 16, 32, 64, 256, 4096 };
+	const size_t length_count = sizeof(lengths) / sizeof(*lengths);
+
+	puts("Benchmarking hash throughput...");
+
+	for (size_t i = 0; i < hash_case_count; ++i)
+	{
+		for (size_t j = 0; j < length_count; ++j)
+			bench_throughput(hash_cases + i, lengths[j], (size_t)256 << 20);
+	}
+
+	puts("Benchmarking hash quality...");
+
+	const char *formats[][2] = {
+		{ "url", "https://example.com/api/v1/items/%zu?format=json" },
+		{ "numeric", "%zu" },
+		{ "id", "user-%08zx" }
+	};
+	const size_t format_count = sizeof(formats) / sizeof(*formats);
+
+	for (size_t f = 0; f < format_count; ++f)
+	{
+		char **keys = make_keys(formats[f][1], count);
+
+		for (size_t i = 0; i < hash_case_count; ++i)
+			bench_quality(hash_cases + i, formats[f][0], keys, count);
+
+		free_keys(keys, count);
+	}
+
+	return 0;
+}
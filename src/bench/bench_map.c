@@ -0,0 +1,123 @@
+#include <hirzel/map.h>
+#include <hirzel/table.h>
+
+HIRZEL_MAP_DECLARE(uint64_t, int, IdMap, HIRZEL_MAP_INT_HASH, HIRZEL_MAP_INT_EQ)
+HIRZEL_MAP_DEFINE(uint64_t, int, IdMap, HIRZEL_MAP_INT_HASH, HIRZEL_MAP_INT_EQ)
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, IntTable)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+double seconds_since(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void report(const char *name, const char *operation, size_t count, double seconds)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-16s %-8s %10zu ops %10.4f s %8.1f ns/op\n", name, operation, count, seconds, ns);
+}
+
+uint64_t make_id(size_t i)
+{
+	return (uint64_t)i * 0x9e3779b97f4a7c15ull;
+}
+
+void bench_map(size_t count)
+{
+	IdMap map;
+	IdMap_init(&map);
+
+	clock_t start = clock();
+
+	for (size_t i = 0; i < count; ++i)
+		IdMap_set(&map, make_id(i), (int)i);
+
+	report("IdMap", "insert", count, seconds_since(start));
+
+	size_t found = 0;
+	start = clock();
+
+	for (size_t i = 0; i < count; ++i)
+		found += IdMap_contains(&map, make_id(i));
+
+	report("IdMap", "hit", count, seconds_since(start));
+
+	start = clock();
+
+	for (size_t i = count; i < count * 2; ++i)
+		found += IdMap_contains(&map, make_id(i));
+
+	report("IdMap", "miss", count, seconds_since(start));
+
+	if (found != count)
+		printf("\tIdMap found %zu of %zu keys\n", found, count);
+
+	IdMap_free(&map);
+}
+
+// ids formatted into strings before every call, as with the string table
+void bench_table(size_t count)
+{
+	IntTable table;
+	IntTable_init(&table);
+
+	char key[32];
+	clock_t start = clock();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		sprintf(key, "%llu", (unsigned long long)make_id(i));
+		IntTable_set(&table, key, (int)i);
+	}
+
+	report("IntTable", "insert", count, seconds_since(start));
+
+	size_t found = 0;
+	start = clock();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		sprintf(key, "%llu", (unsigned long long)make_id(i));
+		found += IntTable_contains(&table, key);
+	}
+
+	report("IntTable", "hit", count, seconds_since(start));
+
+	start = clock();
+
+	for (size_t i = count; i < count * 2; ++i)
+	{
+		sprintf(key, "%llu", (unsigned long long)make_id(i));
+		found += IntTable_contains(&table, key);
+	}
+
+	report("IntTable", "miss", count, seconds_since(start));
+
+	if (found != count)
+		printf("\tIntTable found %zu of %zu keys\n", found, count);
+
+	IntTable_free(&table);
+}
+
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 1000000;
+
+	puts("Benchmarking integer keys...");
+
+	bench_map(count);
+	bench_table(count);
+
+	return 0;
+}
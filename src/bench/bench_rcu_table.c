@@ -0,0 +1,235 @@
+#include <hirzel/rcu_table.h>
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, IntTable)
+
+HIRZEL_RCU_TABLE_DECLARE(int, RcuIntTable)
+HIRZEL_RCU_TABLE_DEFINE(int, RcuIntTable)
+
+// standard library
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+typedef HANDLE Thread;
+typedef LPTHREAD_START_ROUTINE ThreadFunction;
+#define THREAD_RETURN DWORD WINAPI
+#define start_thread(thread, function, arg) (*(thread) = CreateThread(NULL, 0, function, arg, 0, NULL))
+#define join_thread(thread) (WaitForSingleObject(thread, INFINITE), CloseHandle(thread))
+
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void sleep_seconds(double seconds)
+{
+	Sleep((DWORD)(seconds * 1000));
+}
+#else
+typedef pthread_t Thread;
+typedef void *(*ThreadFunction)(void *);
+#define THREAD_RETURN void *
+#define start_thread(thread, function, arg) pthread_create(thread, NULL, function, arg)
+#define join_thread(thread) pthread_join(thread, NULL)
+
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+void sleep_seconds(double seconds)
+{
+	struct timespec duration = { (time_t)seconds, (long)((seconds - (double)(time_t)seconds) * 1e9) };
+	nanosleep(&duration, NULL);
+}
+#endif
+
+#define MAX_READERS 8
+#define KEY_STRIDE 48
+#define RUN_SECONDS 0.5
+
+typedef struct Shared
+{
+	const char *keys;
+	size_t key_count;
+	volatile size_t is_done;
+	HirzelRwLock lock;
+	IntTable locked_table;
+	RcuIntTable rcu_table;
+} Shared;
+
+typedef struct Worker
+{
+	Shared *shared;
+	uint64_t seed;
+	size_t ops;
+	size_t found;
+} Worker;
+
+static uint64_t next_random(uint64_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+static const char *random_key(Worker *worker)
+{
+	return worker->shared->keys + next_random(&worker->seed) % worker->shared->key_count * KEY_STRIDE;
+}
+
+THREAD_RETURN read_locked(void *arg)
+{
+	Worker *worker = arg;
+	Shared *shared = worker->shared;
+
+	while (!hirzel_atomic_load(&shared->is_done))
+	{
+		const char *key = random_key(worker);
+
+		hirzel_rwlock_read(&shared->lock);
+		worker->found += IntTable_contains(&shared->locked_table, key);
+		hirzel_rwlock_read_unlock(&shared->lock);
+		worker->ops += 1;
+	}
+
+	return 0;
+}
+
+THREAD_RETURN write_locked(void *arg)
+{
+	Worker *worker = arg;
+	Shared *shared = worker->shared;
+
+	while (!hirzel_atomic_load(&shared->is_done))
+	{
+		const char *key = random_key(worker);
+
+		hirzel_rwlock_write(&shared->lock);
+		IntTable_set(&shared->locked_table, key, (int)worker->ops);
+		hirzel_rwlock_write_unlock(&shared->lock);
+		worker->ops += 1;
+	}
+
+	return 0;
+}
+
+THREAD_RETURN read_rcu(void *arg)
+{
+	Worker *worker = arg;
+	Shared *shared = worker->shared;
+	RcuIntTableReader *reader = RcuIntTable_reader_register(&shared->rcu_table);
+
+	while (!hirzel_atomic_load(&shared->is_done))
+	{
+		worker->found += RcuIntTable_contains(&shared->rcu_table, reader, random_key(worker));
+		worker->ops += 1;
+	}
+
+	RcuIntTable_reader_unregister(&shared->rcu_table, reader);
+
+	return 0;
+}
+
+THREAD_RETURN write_rcu(void *arg)
+{
+	Worker *worker = arg;
+	Shared *shared = worker->shared;
+
+	while (!hirzel_atomic_load(&shared->is_done))
+	{
+		RcuIntTable_set(&shared->rcu_table, random_key(worker), (int)worker->ops);
+		worker->ops += 1;
+	}
+
+	return 0;
+}
+
+void run(const char *name, Shared *shared, size_t reader_count, ThreadFunction reader, ThreadFunction writer)
+{
+	Thread threads[MAX_READERS + 1];
+	Worker workers[MAX_READERS + 1];
+
+	hirzel_atomic_store(&shared->is_done, 0);
+
+	for (size_t i = 0; i <= reader_count; ++i)
+	{
+		workers[i] = (Worker) { shared, 0x9e3779b97f4a7c15ull * (i + 1), 0, 0 };
+		start_thread(threads + i, i < reader_count ? reader : writer, workers + i);
+	}
+
+	double start = wall_seconds();
+
+	sleep_seconds(RUN_SECONDS);
+	hirzel_atomic_store(&shared->is_done, 1);
+
+	for (size_t i = 0; i <= reader_count; ++i)
+		join_thread(threads[i]);
+
+	double seconds = wall_seconds() - start;
+	size_t reads = 0;
+
+	for (size_t i = 0; i < reader_count; ++i)
+		reads += workers[i].ops;
+
+	printf("\t%-8s %7zu %14.2f %14.1f\n", name, reader_count,
+		(double)reads / seconds / 1e6, (double)workers[reader_count].ops / seconds);
+}
+
+int main(int argc, char **argv)
+{
+	Shared shared;
+
+	shared.key_count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 10000;
+
+	char *keys = malloc(shared.key_count * KEY_STRIDE);
+
+	for (size_t i = 0; i < shared.key_count; ++i)
+		snprintf(keys + i * KEY_STRIDE, KEY_STRIDE, "/api/v1/route/%zu", i);
+
+	shared.keys = keys;
+	hirzel_rwlock_init(&shared.lock);
+	IntTable_init(&shared.locked_table);
+	RcuIntTable_init(&shared.rcu_table, 0);
+
+	RcuIntTableVersion *batch = RcuIntTable_write_begin(&shared.rcu_table);
+
+	for (size_t i = 0; i < shared.key_count; ++i)
+	{
+		IntTable_set(&shared.locked_table, keys + i * KEY_STRIDE, (int)i);
+		RcuIntTableVersion_set(batch, keys + i * KEY_STRIDE, (int)i);
+	}
+
+	RcuIntTable_write_commit(&shared.rcu_table, batch);
+
+	puts("Benchmarking readers during continuous writes...");
+	printf("\t%-8s %7s %14s %14s\n", "table", "readers", "reads Mops/s", "writes/s");
+
+	for (size_t reader_count = 1; reader_count <= MAX_READERS; reader_count *= 2)
+	{
+		run("rwlock", &shared, reader_count, read_locked, write_locked);
+		run("rcu", &shared, reader_count, read_rcu, write_rcu);
+	}
+
+	hirzel_rwlock_destroy(&shared.lock);
+	IntTable_free(&shared.locked_table);
+	RcuIntTable_free(&shared.rcu_table);
+	free(keys);
+
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include <hirzel/set.h>
+
+HIRZEL_SET_DECLARE(StringSet)
+HIRZEL_SET_DEFINE(StringSet)
+
+// what sets were written as before hirzel/set.h
+HIRZEL_TABLE_DECLARE(char, CharTable)
+HIRZEL_TABLE_DEFINE(char, CharTable)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+char **make_keys(size_t count)
+{
+	char **keys = malloc(count * sizeof(char*));
+	char buffer[128];
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		int length = sprintf(buffer, "https://example.com/set/%zu/item", i);
+		keys[i] = malloc(length + 1);
+		memcpy(keys[i], buffer, length + 1);
+	}
+
+	return keys;
+}
+
+void free_keys(char **keys, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		free(keys[i]);
+
+	free(keys);
+}
+
+double seconds_since(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void report(const char *name, const char *operation, size_t count, double seconds)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-12s %-14s %10zu ops %10.4f s %8.1f ns/op\n", name, operation, count, seconds, ns);
+}
+
+// intersection the way it is done without bulk operations
+void char_table_intersection(CharTable *out, const CharTable *a, const CharTable *b)
+{
+	size_t size = CharTable_size(a);
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		const char *key = a->data[i].key;
+
+		if (key && CharTable_contains(b, key))
+			CharTable_set(out, key, 0);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 1000000;
+
+	size_t small_count = count / 100 + 1;
+	char **keys = make_keys(count);
+
+	printf("Benchmarking sets (node: %zu bytes, char table node: %zu bytes)...\n",
+		sizeof(StringSetNode), sizeof(CharTableNode));
+
+	StringSet large, small, out;
+	StringSet_init(&large);
+	StringSet_init(&small);
+	StringSet_init(&out);
+
+	clock_t start = clock();
+
+	for (size_t i = 0; i < count; ++i)
+		StringSet_insert(&large, keys[i]);
+
+	report("StringSet", "insert", count, seconds_since(start));
+
+	for (size_t i = 0; i < small_count; ++i)
+		StringSet_insert(&small, keys[i * 97 % count]);
+
+	start = clock();
+	StringSet_intersection(&out, &large, &small);
+	report("StringSet", "intersection", large.count + small.count, seconds_since(start));
+
+	start = clock();
+	StringSet_union(&out, &large, &small);
+	report("StringSet", "union", large.count + small.count, seconds_since(start));
+
+	start = clock();
+	StringSet_difference(&out, &large, &small);
+	report("StringSet", "difference", large.count + small.count, seconds_since(start));
+
+	CharTable table_large, table_small, table_out;
+	CharTable_init(&table_large);
+	CharTable_init(&table_small);
+	CharTable_init(&table_out);
+
+	start = clock();
+
+	for (size_t i = 0; i < count; ++i)
+		CharTable_set(&table_large, keys[i], 0);
+
+	report("CharTable", "insert", count, seconds_since(start));
+
+	for (size_t i = 0; i < small_count; ++i)
+		CharTable_set(&table_small, keys[i * 97 % count], 0);
+
+	start = clock();
+	char_table_intersection(&table_out, &table_large, &table_small);
+	report("CharTable", "intersection", table_large.count + table_small.count, seconds_since(start));
+
+	if (out.count + small.count != large.count || table_out.count != small.count)
+		puts("\tset operations disagree");
+
+	StringSet_free(&large);
+	StringSet_free(&small);
+	StringSet_free(&out);
+	CharTable_free(&table_large);
+	CharTable_free(&table_small);
+	CharTable_free(&table_out);
+	free_keys(keys, count);
+
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include <hirzel/small_array.h>
+
+HIRZEL_ARRAY_DECLARE(int, IntArray)
+HIRZEL_ARRAY_DEFINE(int, IntArray)
+
+HIRZEL_SMALL_ARRAY_DECLARE(int, 8, IntSmallArray)
+HIRZEL_SMALL_ARRAY_DEFINE(int, 8, IntSmallArray)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+size_t alloc_count = 0;
+
+void *count_alloc(void *context, size_t size)
+{
+	(void)context;
+	alloc_count += 1;
+
+	return malloc(size);
+}
+
+void *count_realloc(void *context, void *data, size_t old_size, size_t new_size)
+{
+	(void)context;
+	(void)old_size;
+	alloc_count += 1;
+
+	return realloc(data, new_size);
+}
+
+void count_free(void *context, void *data, size_t size)
+{
+	(void)context;
+	(void)size;
+
+	free(data);
+}
+
+const HirzelAllocator counting_allocator = { NULL, count_alloc, count_realloc, count_free };
+
+void report(const char *name, size_t count, double seconds, size_t allocs)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-28s %10zu arrays %10.4f s %8.1f ns/array %10zu allocs\n", name, count, seconds, ns, allocs);
+}
+
+/* arrays that each live for one iteration and mostly stay under 8 items */
+#define BENCH_ARRAYS(NAME, ALLOCATOR, LABEL)\
+do\
+{\
+	size_t seed = 1;\
+	long long sum = 0;\
+	double start = wall_seconds();\
+\
+	alloc_count = 0;\
+\
+	for (size_t i = 0; i < count; ++i)\
+	{\
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;\
+		size_t length = (seed >> 60) < 14 ? (seed >> 33) % 8 : (seed >> 33) % 32;\
+		NAME array = NAME##_init_allocator(ALLOCATOR);\
+\
+		for (size_t j = 0; j < length; ++j)\
+			NAME##_push(&array, (int)(i + j));\
+\
+		for (size_t j = 0; j < length; ++j)\
+			sum += *NAME##_get_ptr(&array, j);\
+\
+		NAME##_free(&array);\
+	}\
+\
+	report(LABEL, count, wall_seconds() - start, alloc_count);\
+\
+	if (sum == 0)\
+		puts("\tUnexpected sum");\
+} while (0)
+
+/*
+ * Builds and drops short lived arrays, most of them under 8 items long, as an
+ * array and as a small array with 8 inline items. Each is run with malloc for
+ * time and with a counting allocator for the number of allocations.
+ */
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 10000000;
+
+	printf("Benchmarking small arrays on %zu short lived arrays...\n", count);
+
+	BENCH_ARRAYS(IntArray, NULL, "array");
+	BENCH_ARRAYS(IntSmallArray, NULL, "small array");
+	BENCH_ARRAYS(IntArray, &counting_allocator, "array, counted");
+	BENCH_ARRAYS(IntSmallArray, &counting_allocator, "small array, counted");
+
+	return 0;
+}
@@ -0,0 +1,166 @@
+#include <hirzel/table.h>
+#include <hirzel/swiss_table.h>
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE(int, IntTable)
+
+HIRZEL_TABLE_DECLARE(int, PowIntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, PowIntTable)
+
+HIRZEL_SWISS_TABLE_DECLARE(int, IntSwissTable)
+HIRZEL_SWISS_TABLE_DEFINE(int, IntSwissTable)
+
+// standard library
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct KeySet
+{
+	char **keys;
+	size_t count;
+} KeySet;
+
+KeySet make_keys(size_t count, const char *prefix)
+{
+	KeySet set = { malloc(count * sizeof(char*)), count };
+	char buffer[128];
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		// mimics the url keys the tables are usually loaded with
+		int length = sprintf(buffer, "https://example.com/%s/%zu/item", prefix, i * 2654435761u % 1000000007u);
+		set.keys[i] = malloc(length + 1);
+		memcpy(set.keys[i], buffer, length + 1);
+	}
+
+	return set;
+}
+
+void free_keys(KeySet *set)
+{
+	for (size_t i = 0; i < set->count; ++i)
+		free(set->keys[i]);
+
+	free(set->keys);
+}
+
+// cheap hash shared by every table so that only the probing is compared
+size_t bench_hash_n(const char *key, size_t length)
+{
+	uint64_t hash = 14695981039346656037ull;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		hash ^= (unsigned char)key[i];
+		hash *= 1099511628211ull;
+	}
+
+	return (size_t)hash;
+}
+
+double seconds_since(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void report(const char *name, const char *operation, size_t count, double seconds)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-16s %-8s %10zu ops %10.4f s %8.1f ns/op\n", name, operation, count, seconds, ns);
+}
+
+// every table flavour exposes the same interface, so one body benchmarks them all
+#define BENCH_TABLE(NAME, hits, misses)\
+do\
+{\
+	NAME table;\
+	NAME##_init(&table);\
+	table.hash_function = bench_hash_n;\
+	clock_t start = clock();\
+\
+	for (size_t i = 0; i < hits.count; ++i)\
+		NAME##_set(&table, hits.keys[i], (int)i);\
+\
+	report(#NAME, "insert", hits.count, seconds_since(start));\
+\
+	size_t found = 0;\
+	start = clock();\
+\
+	for (size_t i = 0; i < hits.count; ++i)\
+		found += NAME##_contains(&table, hits.keys[i]);\
+\
+	report(#NAME, "hit", hits.count, seconds_since(start));\
+\
+	start = clock();\
+\
+	for (size_t i = 0; i < misses.count; ++i)\
+		found += NAME##_contains(&table, misses.keys[i]);\
+\
+	report(#NAME, "miss", misses.count, seconds_since(start));\
+\
+	if (found != hits.count)\
+		printf("\t%s found %zu of %zu keys\n", #NAME, found, hits.count);\
+\
+	NAME##_free(&table);\
+} while (0)
+
+void bench_key_storage(const char *name, bool use_arena, KeySet hits)
+{
+	IntTable table;
+
+	if (use_arena)
+		IntTable_init_arena(&table);
+	else
+		IntTable_init(&table);
+
+	IntTable_reserve(&table, hits.count);
+	table.hash_function = bench_hash_n;
+
+	for (int round = 0; round < 3; ++round)
+	{
+		clock_t start = clock();
+
+		for (size_t i = 0; i < hits.count; ++i)
+			IntTable_set(&table, hits.keys[i], (int)i);
+
+		report(name, "load", hits.count, seconds_since(start));
+
+		start = clock();
+		IntTable_clear(&table);
+		report(name, "clear", hits.count, seconds_since(start));
+	}
+
+	IntTable_free(&table);
+}
+
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 1000000;
+
+	KeySet hits = make_keys(count, "hit");
+	KeySet misses = make_keys(count, "miss");
+
+	puts("Benchmarking string tables...");
+
+	BENCH_TABLE(IntTable, hits, misses);
+	BENCH_TABLE(PowIntTable, hits, misses);
+	BENCH_TABLE(IntSwissTable, hits, misses);
+
+	puts("Benchmarking key storage...");
+
+	bench_key_storage("malloc keys", false, hits);
+	bench_key_storage("arena keys", true, hits);
+
+	free_keys(&hits);
+	free_keys(&misses);
+
+	return 0;
+}
@@ -0,0 +1,153 @@
+#include <hirzel/table.h>
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE(int, IntTable)
+
+HIRZEL_TABLE_DECLARE(int, PowIntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, PowIntTable)
+
+// standard library
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define KEY_STRIDE 32
+#define BATCH_COUNT 4096
+
+double seconds_since(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void report(const char *name, const char *operation, size_t count, double seconds)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-12s %-10s %10zu ops %10.4f s %8.1f ns/op\n", name, operation, count, seconds, ns);
+}
+
+// xorshift, so the shuffle is the same on every platform
+uint64_t next_random(uint64_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+void shuffle(const char **keys, size_t count)
+{
+	uint64_t state = 88172645463325252ull;
+
+	for (size_t i = count - 1; i > 0; --i)
+	{
+		size_t j = (size_t)(next_random(&state) % (i + 1));
+		const char *tmp = keys[i];
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+}
+
+/*
+ * Sets every key and then looks all of them up in random order, one at a time
+ * and in batches of BATCH_COUNT. Half of the lookups are for absent keys.
+ */
+#define BENCH_BATCH(NAME, keys, missing_keys, count)\
+do\
+{\
+	NAME scalar_table, batch_table;\
+	NAME##_init(&scalar_table);\
+	NAME##_init(&batch_table);\
+	int *values = malloc((count) * sizeof(int));\
+	bool *is_found = malloc(BATCH_COUNT * sizeof(bool));\
+\
+	for (size_t i = 0; i < (count); ++i)\
+		values[i] = (int)i;\
+\
+	clock_t start = clock();\
+\
+	for (size_t i = 0; i < (count); ++i)\
+		NAME##_set(&scalar_table, keys[i], values[i]);\
+\
+	report(#NAME, "set", (count), seconds_since(start));\
+	start = clock();\
+\
+	for (size_t i = 0; i < (count); i += BATCH_COUNT)\
+	{\
+		size_t batch = (count) - i < BATCH_COUNT ? (count) - i : BATCH_COUNT;\
+		NAME##_set_batch(&batch_table, keys + i, values + i, batch);\
+	}\
+\
+	report(#NAME, "set_batch", (count), seconds_since(start));\
+\
+	const char *const *lookups[] = { keys, missing_keys };\
+	const char *operations[][2] = { { "get", "get_batch" }, { "get miss", "batch miss" } };\
+\
+	for (size_t l = 0; l < 2; ++l)\
+	{\
+		size_t found = 0;\
+		int value;\
+		start = clock();\
+\
+		for (size_t i = 0; i < (count); ++i)\
+			found += NAME##_get(&scalar_table, &value, lookups[l][i]);\
+\
+		report(#NAME, operations[l][0], (count), seconds_since(start));\
+\
+		size_t batch_found = 0;\
+		start = clock();\
+\
+		for (size_t i = 0; i < (count); i += BATCH_COUNT)\
+		{\
+			size_t batch = (count) - i < BATCH_COUNT ? (count) - i : BATCH_COUNT;\
+			batch_found += NAME##_get_batch(&scalar_table, values, is_found, lookups[l] + i, batch);\
+		}\
+\
+		report(#NAME, operations[l][1], (count), seconds_since(start));\
+\
+		if (found != batch_found)\
+			printf("\t%s found %zu keys one at a time but %zu in batches\n", #NAME, found, batch_found);\
+	}\
+\
+	free(is_found);\
+	free(values);\
+	NAME##_free(&scalar_table);\
+	NAME##_free(&batch_table);\
+} while (0)
+
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 4000000;
+	char *buffer = malloc(count * 2 * KEY_STRIDE);
+	const char **keys = malloc(count * sizeof(char *));
+	const char **missing_keys = malloc(count * sizeof(char *));
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		keys[i] = buffer + i * KEY_STRIDE;
+		missing_keys[i] = buffer + (count + i) * KEY_STRIDE;
+		snprintf(buffer + i * KEY_STRIDE, KEY_STRIDE, "key-%zu", i);
+		snprintf(buffer + (count + i) * KEY_STRIDE, KEY_STRIDE, "missing-%zu", i);
+	}
+
+	shuffle(keys, count);
+
+	printf("Benchmarking batched lookups over %zu keys (node: %zu bytes)...\n", count, sizeof(IntTableNode));
+
+	BENCH_BATCH(IntTable, keys, missing_keys, count);
+	BENCH_BATCH(PowIntTable, keys, missing_keys, count);
+
+	free(missing_keys);
+	free(keys);
+	free(buffer);
+
+	return 0;
+}
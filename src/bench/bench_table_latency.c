@@ -0,0 +1,148 @@
+#include <hirzel/table.h>
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE(int, IntTable)
+
+HIRZEL_TABLE_DECLARE(int, PowIntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, PowIntTable)
+
+// standard library
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+
+uint64_t wall_ns(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+}
+#else
+uint64_t wall_ns(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+#endif
+
+#define KEY_STRIDE 32
+#define BUCKET_COUNT 32
+
+int compare_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+unsigned log2_bucket(uint64_t ns)
+{
+	unsigned bucket = 0;
+
+	while (ns > 1 && bucket < BUCKET_COUNT - 1)
+	{
+		ns >>= 1;
+		bucket += 1;
+	}
+
+	return bucket;
+}
+
+/*
+ * Prints percentiles of the insert latencies followed by a log2 histogram of
+ * the slow tail, where a blocking resize shows up as a handful of inserts
+ * costing as much as copying the whole table.
+ */
+void report(const char *name, uint64_t *latencies, size_t count, double total_seconds)
+{
+	size_t buckets[BUCKET_COUNT] = { 0 };
+
+	for (size_t i = 0; i < count; ++i)
+		buckets[log2_bucket(latencies[i])] += 1;
+
+	qsort(latencies, count, sizeof(uint64_t), compare_u64);
+
+	printf("%s\n\t%8s %8s %8s %8s %12s %10s\n", name, "p50 ns", "p99 ns", "p999 ns", "p9999 ns", "max ns", "total ms");
+	printf("\t%8llu %8llu %8llu %8llu %12llu %10.1f\n",
+		(unsigned long long)latencies[count / 2],
+		(unsigned long long)latencies[count * 99 / 100],
+		(unsigned long long)latencies[count * 999 / 1000],
+		(unsigned long long)latencies[count * 9999 / 10000],
+		(unsigned long long)latencies[count - 1],
+		total_seconds * 1e3);
+
+	// anything under a microsecond is in the percentiles above
+	for (unsigned b = 10; b < BUCKET_COUNT; ++b)
+	{
+		if (buckets[b] > 0)
+			printf("\t\t>= %10llu ns: %zu\n", 1ull << b, buckets[b]);
+	}
+}
+
+/*
+ * Times every insert into a table grown from empty, with the resize done all
+ * at once or spread over the inserts that follow it.
+ */
+#define BENCH_LATENCY(NAME, is_incremental_resize, keys, count, latencies)\
+do\
+{\
+	/* keys go in an arena, as freeing millions of them one by one leaves malloc\
+	 * tidying up in the middle of the next run */\
+	NAME table;\
+	NAME##_init_arena(&table);\
+	NAME##_set_incremental(&table, (is_incremental_resize));\
+	uint64_t total_start = wall_ns();\
+\
+	for (size_t i = 0; i < (count); ++i)\
+	{\
+		uint64_t start = wall_ns();\
+		NAME##_set(&table, keys + i * KEY_STRIDE, (int)i);\
+		(latencies)[i] = wall_ns() - start;\
+	}\
+\
+	double total_seconds = (double)(wall_ns() - total_start) / 1e9;\
+	size_t found = 0;\
+\
+	for (size_t i = 0; i < (count); ++i)\
+		found += NAME##_contains(&table, keys + i * KEY_STRIDE);\
+\
+	if (found != (count))\
+		printf("%s found %zu of %zu keys\n", #NAME, found, (size_t)(count));\
+\
+	report((is_incremental_resize) ? #NAME " (incremental)" : #NAME, latencies, (count), total_seconds);\
+	NAME##_free(&table);\
+} while (0)
+
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 4000000;
+	char *keys = malloc(count * KEY_STRIDE);
+	uint64_t *latencies = malloc(count * sizeof(uint64_t));
+
+	for (size_t i = 0; i < count; ++i)
+		snprintf(keys + i * KEY_STRIDE, KEY_STRIDE, "user-%zu", i);
+
+	printf("Benchmarking insert latency over %zu inserts...\n", count);
+
+	BENCH_LATENCY(IntTable, false, keys, count, latencies);
+	BENCH_LATENCY(IntTable, true, keys, count, latencies);
+	BENCH_LATENCY(PowIntTable, false, keys, count, latencies);
+	BENCH_LATENCY(PowIntTable, true, keys, count, latencies);
+
+	free(latencies);
+	free(keys);
+
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include <hirzel/table_snapshot.h>
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, IntTable)
+HIRZEL_TABLE_SNAPSHOT_DECLARE(int, IntTable)
+HIRZEL_TABLE_SNAPSHOT_DEFINE(int, IntTable)
+
+// standard library
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+double wall_seconds(void)
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+double wall_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+#endif
+
+#define KEY_STRIDE 48
+#define SNAPSHOT_PATH "bench_table_snapshot.bin"
+
+void report(const char *operation, size_t count, double seconds)
+{
+	double ns = count > 0
+		? seconds * 1e9 / (double)count
+		: 0.0;
+
+	printf("\t%-24s %10zu ops %10.4f s %8.1f ns/op\n", operation, count, seconds, ns);
+}
+
+/*
+ * Compares the cold start of rebuilding a table by inserting every key with
+ * opening a snapshot of it, then looks every key up in both. Lookups on the
+ * snapshot include paging the file in, unless the os still has it cached.
+ */
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1
+		? (size_t)strtoull(argv[1], NULL, 10)
+		: 2000000;
+	char *keys = malloc(count * KEY_STRIDE);
+
+	for (size_t i = 0; i < count; ++i)
+		snprintf(keys + i * KEY_STRIDE, KEY_STRIDE, "/var/data/objects/%zu.bin", i);
+
+	printf("Benchmarking table snapshots of %zu keys...\n", count);
+
+	IntTable table;
+	IntTable_init(&table);
+	double start = wall_seconds();
+
+	for (size_t i = 0; i < count; ++i)
+		IntTable_set(&table, keys + i * KEY_STRIDE, (int)i);
+
+	report("rebuild by inserting", count, wall_seconds() - start);
+	start = wall_seconds();
+
+	if (!IntTable_snapshot_write(&table, SNAPSHOT_PATH))
+	{
+		puts("Failed to write snapshot");
+		return 1;
+	}
+
+	report("snapshot_write", count, wall_seconds() - start);
+
+	IntTableSnapshot snapshot;
+	start = wall_seconds();
+
+	if (!IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, NULL))
+	{
+		puts("Failed to open snapshot");
+		return 1;
+	}
+
+	report("snapshot open", 1, wall_seconds() - start);
+	printf("\t%-24s %10zu bytes (%s)\n", "snapshot size", snapshot.file.size, snapshot.file.is_mapped ? "mapped" : "read");
+
+	long long table_sum = 0;
+	long long snapshot_sum = 0;
+	int value;
+	start = wall_seconds();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (IntTableSnapshot_get(&snapshot, &value, keys + i * KEY_STRIDE))
+			snapshot_sum += value;
+	}
+
+	report("snapshot get", count, wall_seconds() - start);
+	start = wall_seconds();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (IntTable_get(&table, &value, keys + i * KEY_STRIDE))
+			table_sum += value;
+	}
+
+	report("table get", count, wall_seconds() - start);
+
+	if (table_sum != snapshot_sum)
+		printf("\tSnapshot sum %lld doesn't match table sum %lld\n", snapshot_sum, table_sum);
+
+	IntTableSnapshot_close(&snapshot);
+	IntTable_free(&table);
+	remove(SNAPSHOT_PATH);
+	free(keys);
+
+	return 0;
+}
@@ -16,8 +16,23 @@ int main()
 {
 	const char *tests[] =
 	{
+		"./test_allocator",
 		"./test_array",
-		"./test_table"
+		"./test_array_io",
+		"./test_array_sort",
+		"./test_concurrent_table",
+		"./test_deque",
+		"./test_dense_table",
+		"./test_file",
+		"./test_hash",
+		"./test_map",
+		"./test_rcu_table",
+		"./test_set",
+		"./test_small_array",
+		"./test_robin_table",
+		"./test_table",
+		"./test_table_snapshot",
+		"./test_swiss_table"
 	};
 	
 	size_t test_count = sizeof(tests) / sizeof(tests[0]);
@@ -0,0 +1,278 @@
+#include <hirzel/allocator.h>
+#include <hirzel/array.h>
+#include <hirzel/table.h>
+
+HIRZEL_ARRAY_DECLARE(int, IntArray)
+HIRZEL_ARRAY_DEFINE(int, IntArray)
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE(int, IntTable)
+
+// standard library
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// malloc that checks every block is freed with the size it was allocated with
+typedef struct Counter
+{
+	size_t live_count;
+	size_t live_size;
+	size_t call_count;
+} Counter;
+
+void *counter_alloc(void *context, size_t size)
+{
+	Counter *counter = context;
+	size_t *block = malloc(sizeof(size_t) * 2 + size);
+
+	if (!block)
+		return NULL;
+
+	block[0] = size;
+	counter->live_count += 1;
+	counter->live_size += size;
+	counter->call_count += 1;
+
+	return block + 2;
+}
+
+void counter_free(void *context, void *data, size_t size)
+{
+	Counter *counter = context;
+	size_t *block = (size_t *)data - 2;
+
+	assert(block[0] == size);
+	counter->live_count -= 1;
+	counter->live_size -= size;
+	free(block);
+}
+
+void *counter_realloc(void *context, void *data, size_t old_size, size_t new_size)
+{
+	void *new_data = counter_alloc(context, new_size);
+
+	if (new_data && data)
+	{
+		memcpy(new_data, data, old_size < new_size ? old_size : new_size);
+		counter_free(context, data, old_size);
+	}
+
+	return new_data;
+}
+
+HirzelAllocator counter_allocator(Counter *counter)
+{
+	*counter = (Counter) { 0, 0, 0 };
+
+	return (HirzelAllocator) { counter, counter_alloc, counter_realloc, counter_free };
+}
+
+bool is_aligned(const void *data)
+{
+	return (uintptr_t)data % HIRZEL_ALLOCATOR_ALIGNMENT == 0;
+}
+
+void test_arena()
+{
+	puts("\tTesting arena");
+
+	HirzelArena arena;
+	hirzel_arena_init(&arena, 1024);
+
+	char *a = hirzel_arena_alloc(&arena, 3);
+	char *b = hirzel_arena_alloc(&arena, 100);
+
+	assert(a && b);
+	assert(is_aligned(a) && is_aligned(b));
+	assert(b == a + HIRZEL_ALLOCATOR_ALIGNMENT);
+
+	// too large for a block, so given one of its own behind the current block
+	char *large = hirzel_arena_alloc(&arena, 5000);
+
+	assert(large && is_aligned(large));
+	memset(large, 1, 5000);
+	assert(hirzel_arena_alloc(&arena, 16) == b + 112);
+
+	HirzelAllocator allocator = hirzel_arena_allocator(&arena);
+	char *c = hirzel_allocate(&allocator, 32);
+
+	// the newest allocation grows and shrinks in place
+	memset(c, 7, 32);
+	assert(hirzel_reallocate(&allocator, c, 32, 256) == c);
+	assert(hirzel_reallocate(&allocator, c, 256, 64) == c);
+
+	// others are copied
+	char *d = hirzel_reallocate(&allocator, b, 100, 200);
+
+	assert(d != b);
+	assert(d == c + 64);
+
+	hirzel_deallocate(&allocator, d, 200);
+	assert(hirzel_allocate(&allocator, 8) == d);
+
+	// outgrowing the block moves the allocation to a new one
+	char *e = hirzel_reallocate(&allocator, c, 64, 900);
+
+	assert(e != c);
+	assert(!memcmp(e, c, 32));
+
+	hirzel_arena_reset(&arena);
+	assert(arena.blocks->next == NULL);
+	assert(arena.blocks->used == 0);
+	assert(hirzel_arena_alloc(&arena, 1) == hirzel_arena_block_data(arena.blocks));
+
+	hirzel_arena_free(&arena);
+	assert(arena.blocks == NULL);
+}
+
+void test_pool()
+{
+	puts("\tTesting pool");
+
+	HirzelPool pool;
+	hirzel_pool_init(&pool, 24, 4);
+
+	void *items[10];
+
+	for (int i = 0; i < 10; ++i)
+	{
+		items[i] = hirzel_pool_alloc(&pool);
+		assert(items[i] && is_aligned(items[i]));
+		memset(items[i], i, 24);
+	}
+
+	for (int i = 0; i < 10; ++i)
+	{
+		for (size_t j = 0; j < 24; ++j)
+			assert(((unsigned char *)items[i])[j] == i);
+	}
+
+	// freed items are handed out again, newest first
+	hirzel_pool_dealloc(&pool, items[3]);
+	hirzel_pool_dealloc(&pool, items[7]);
+	assert(hirzel_pool_alloc(&pool) == items[7]);
+	assert(hirzel_pool_alloc(&pool) == items[3]);
+
+	HirzelAllocator allocator = hirzel_pool_allocator(&pool);
+
+	assert(hirzel_allocate(&allocator, 100) == NULL);
+	assert(hirzel_reallocate(&allocator, items[0], 24, 16) == items[0]);
+	assert(hirzel_reallocate(&allocator, items[0], 24, 100) == NULL);
+	hirzel_deallocate(&allocator, items[0], 24);
+	assert(hirzel_allocate(&allocator, 8) == items[0]);
+
+	hirzel_pool_free(&pool);
+	assert(pool.chunks == NULL);
+	assert(pool.free_items == NULL);
+}
+
+void test_array()
+{
+	puts("\tTesting array allocator");
+
+	Counter counter;
+	HirzelAllocator allocator = counter_allocator(&counter);
+	IntArray array = IntArray_init_allocator(&allocator);
+
+	for (int i = 0; i < 1000; ++i)
+		assert(IntArray_push(&array, i));
+
+	assert(counter.live_count == 1);
+	assert(counter.live_size == array.capacity * sizeof(int));
+	assert(IntArray_reserve(&array, 10));
+	assert(counter.live_size == 10 * sizeof(int));
+	assert(IntArray_reserve(&array, 0));
+	assert(counter.live_count == 0);
+
+	IntArray_push(&array, 1);
+	IntArray_free(&array);
+	assert(counter.live_count == 0);
+
+	// an arena releases every array at once
+	HirzelArena arena;
+	hirzel_arena_init(&arena, 0);
+	allocator = hirzel_arena_allocator(&arena);
+
+	IntArray arrays[4];
+
+	for (int i = 0; i < 4; ++i)
+	{
+		arrays[i] = IntArray_init_allocator(&allocator);
+
+		for (int j = 0; j < 500; ++j)
+			assert(IntArray_push(arrays + i, i * j));
+	}
+
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 500; ++j)
+			assert(arrays[i].buffer[j] == i * j);
+	}
+
+	hirzel_arena_free(&arena);
+}
+
+void test_table()
+{
+	puts("\tTesting table allocator");
+
+	char key[32];
+	Counter counter;
+	HirzelAllocator allocator = counter_allocator(&counter);
+	IntTable table;
+
+	// keys, node arrays and arena blocks all come from the allocator
+	bool is_arena_used[] = { false, true };
+
+	for (size_t i = 0; i < 2; ++i)
+	{
+		assert(IntTable_init_allocator(&table, &allocator));
+		table.key_arena.is_enabled = is_arena_used[i];
+		IntTable_set_incremental(&table, true);
+
+		for (int j = 0; j < 5000; ++j)
+		{
+			snprintf(key, sizeof(key), "key-%d", j);
+			assert(IntTable_set(&table, key, j));
+		}
+
+		for (int j = 0; j < 5000; j += 2)
+		{
+			snprintf(key, sizeof(key), "key-%d", j);
+			IntTable_erase(&table, key);
+		}
+
+		assert(IntTable_compact(&table));
+		assert(IntTable_shrink(&table));
+
+		for (int j = 1; j < 5000; j += 2)
+		{
+			snprintf(key, sizeof(key), "key-%d", j);
+			assert(*IntTable_get_ptr(&table, key) == j);
+		}
+
+		IntTable_clear(&table);
+		assert(IntTable_set(&table, "again", 1));
+
+		IntTable_free(&table);
+		assert(counter.live_count == 0);
+		assert(counter.live_size == 0);
+	}
+
+	assert(counter.call_count > 0);
+}
+
+int main(void)
+{
+	puts("Testing Allocator...");
+	test_arena();
+	test_pool();
+	test_array();
+	test_table();
+
+	puts("All tests passed");
+
+	return 0;
+}
@@ -7,6 +7,16 @@ HIRZEL_ARRAY_DEFINE(int, IntArray)
 #include <stdio.h>
 #include <assert.h>
 
+size_t expected_capacity(size_t length)
+{
+	size_t capacity = 1;
+
+	while (capacity < length)
+		capacity *= 2;
+
+	return capacity;
+}
+
 void test_create()
 {
 	puts("\tTesting create()");
@@ -90,7 +100,7 @@ void test_push_raw()
 	{
 		assert(IntArray_push_raw(&arr));
 		assert(arr.length == (size_t)(i + 1));
-		assert(arr.capacity == (size_t)(i + 1));
+		assert(arr.capacity == expected_capacity(i + 1));
 		arr.buffer[arr.length - 1] = i * 3;
 		assert(arr.buffer[arr.length - 1] == i * 3);
 	}	
@@ -98,6 +108,42 @@ void test_push_raw()
 	IntArray_free(&arr);
 }
 
+void test_growth()
+{
+	puts("\tTesting growth()");
+
+	IntArray arr = IntArray_init();
+	size_t reallocations = 0;
+
+	for (int i = 0; i < 100000; ++i)
+	{
+		size_t capacity = arr.capacity;
+
+		assert(IntArray_push(&arr, i));
+
+		if (arr.capacity != capacity)
+		{
+			assert(arr.capacity == capacity * 2 || capacity == 0);
+			reallocations += 1;
+		}
+	}
+
+	assert(reallocations == 18);
+
+	for (int i = 0; i < 100000; ++i)
+		assert(arr.buffer[i] == i);
+
+	assert(IntArray_resize(&arr, 200000));
+	assert(arr.length == 200000);
+	assert(arr.capacity == 262144);
+
+	assert(IntArray_resize(&arr, 600000));
+	assert(arr.length == 600000);
+	assert(arr.capacity == 600000);
+
+	IntArray_free(&arr);
+}
+
 void test_push()
 {
 	puts("\tTesting push()");
@@ -156,7 +202,7 @@ void test_pushf()
 
 	assert(IntArray_pushf(&arr, 8));	
 	assert(arr.length == 3);
-	assert(arr.capacity == 3);
+	assert(arr.capacity == 4);
 	assert(arr.buffer[0] == 8);
 	assert(arr.buffer[1] == 2);
 	assert(arr.buffer[2] == 6);
@@ -186,7 +232,7 @@ void test_insert()
 	IntArray_insert(&arr, 0, 2);
 
 	assert(arr.length == 3);
-	assert(arr.capacity == 3);
+	assert(arr.capacity == 4);
 	assert(arr.buffer[0] == 2);
 	assert(arr.buffer[1] == 3);
 	assert(arr.buffer[2] == 5);
@@ -477,12 +523,185 @@ void test_clear()
 	IntArray_free(&arr);
 }
 
+void assert_items(IntArray *arr, const int *expected, size_t length)
+{
+	assert(arr->length == length);
+
+	for (size_t i = 0; i < length; ++i)
+		assert(arr->buffer[i] == expected[i]);
+}
+
+void test_insert_range()
+{
+	puts("\tTesting insert_range()");
+
+	IntArray arr = IntArray_init();
+	const int items[] = { 1, 2, 3, 4 };
+
+	assert(IntArray_insert_range(&arr, 0, NULL, 0));
+	assert(arr.buffer == NULL);
+
+	assert(IntArray_insert_range(&arr, 0, items, 2));
+	assert(arr.capacity == 2);
+	assert(IntArray_insert_range(&arr, 0, items + 2, 2));
+
+	// one growth covers the whole range
+	assert(arr.capacity == 4);
+
+	const int front[] = { 3, 4, 1, 2 };
+	assert_items(&arr, front, 4);
+
+	assert(IntArray_insert_range(&arr, 2, items, 3));
+	assert(arr.capacity == 8);
+
+	const int middle[] = { 3, 4, 1, 2, 3, 1, 2 };
+	assert_items(&arr, middle, 7);
+
+	assert(IntArray_insert_range(&arr, 7, items, 1));
+
+	const int back[] = { 3, 4, 1, 2, 3, 1, 2, 1 };
+	assert_items(&arr, back, 8);
+
+	IntArray_free(&arr);
+}
+
+void test_erase_range()
+{
+	puts("\tTesting erase_range()");
+
+	IntArray arr = IntArray_init();
+
+	// nothing to erase from an array with no buffer yet
+	IntArray_erase_range(&arr, 0, 0);
+	assert(arr.buffer == NULL && arr.length == 0);
+
+	for (int i = 0; i < 8; ++i)
+		IntArray_push(&arr, i);
+
+	IntArray_erase_range(&arr, 2, 3);
+
+	const int middle[] = { 0, 1, 5, 6, 7 };
+	assert_items(&arr, middle, 5);
+
+	IntArray_erase_range(&arr, 3, 2);
+	IntArray_erase_range(&arr, 0, 1);
+	IntArray_erase_range(&arr, 1, 0);
+
+	const int ends[] = { 1, 5 };
+	assert_items(&arr, ends, 2);
+
+	IntArray_erase_range(&arr, 0, 2);
+	assert(arr.length == 0);
+	assert(arr.capacity == 8);
+
+	IntArray_free(&arr);
+}
+
+void test_append_array()
+{
+	puts("\tTesting append_array()");
+
+	IntArray arr = IntArray_init();
+	IntArray other = IntArray_init();
+
+	assert(IntArray_append_array(&arr, &other));
+	assert(arr.length == 0);
+
+	for (int i = 0; i < 3; ++i)
+		IntArray_push(&other, i);
+
+	assert(IntArray_append_array(&arr, &other));
+	assert(IntArray_append_array(&arr, &other));
+
+	const int expected[] = { 0, 1, 2, 0, 1, 2 };
+	assert_items(&arr, expected, 6);
+	assert(other.length == 3);
+
+	IntArray_free(&other);
+	IntArray_free(&arr);
+}
+
+bool is_even(const int *item, void *context)
+{
+	(void)context;
+
+	return *item % 2 == 0;
+}
+
+bool is_below(const int *item, void *context)
+{
+	return *item < *(const int *)context;
+}
+
+void test_swap_remove()
+{
+	puts("\tTesting swap_remove()");
+
+	IntArray arr = IntArray_init();
+
+	for (int i = 0; i < 5; ++i)
+		IntArray_push(&arr, i);
+
+	IntArray_swap_remove(&arr, 1);
+
+	const int middle[] = { 0, 4, 2, 3 };
+	assert_items(&arr, middle, 4);
+
+	// the back item is simply dropped
+	IntArray_swap_remove(&arr, 3);
+
+	const int back[] = { 0, 4, 2 };
+	assert_items(&arr, back, 3);
+
+	IntArray_swap_remove(&arr, 0);
+	IntArray_swap_remove(&arr, 0);
+	IntArray_swap_remove(&arr, 0);
+	assert(arr.length == 0);
+
+	IntArray_free(&arr);
+}
+
+void test_retain()
+{
+	puts("\tTesting retain() and remove_if()");
+
+	IntArray arr = IntArray_init();
+
+	assert(IntArray_retain(&arr, is_even, NULL) == 0);
+
+	for (int i = 0; i < 10; ++i)
+		IntArray_push(&arr, i);
+
+	assert(IntArray_retain(&arr, is_even, NULL) == 5);
+
+	const int evens[] = { 0, 2, 4, 6, 8 };
+	assert_items(&arr, evens, 5);
+
+	int limit = 5;
+
+	assert(IntArray_remove_if(&arr, is_below, &limit) == 3);
+
+	const int above[] = { 6, 8 };
+	assert_items(&arr, above, 2);
+
+	assert(IntArray_remove_if(&arr, is_below, &limit) == 0);
+	assert_items(&arr, above, 2);
+
+	assert(IntArray_remove_if(&arr, is_even, NULL) == 2);
+	assert(arr.length == 0);
+	assert(arr.capacity == 16);
+
+	IntArray_free(&arr);
+}
+
 int main(void)
 {
 	puts("Testing IntArray...");
 
 	test_create();
+	test_reserve();
 	test_push_raw();
+	test_growth();
 	test_resize();
 	test_push();
 	test_pushf();
@@ -497,6 +716,11 @@ int main(void)
 	test_back();
 	test_swap();
 	test_clear();
+	test_insert_range();
+	test_erase_range();
+	test_append_array();
+	test_swap_remove();
+	test_retain();
 
 	puts("All tests passed");
 
@@ -0,0 +1,227 @@
+#include <hirzel/array_io.h>
+
+typedef struct Sample
+{
+	double time;
+	float value;
+	int channel;
+} Sample;
+
+HIRZEL_ARRAY_DECLARE(Sample, SampleArray)
+HIRZEL_ARRAY_DEFINE(Sample, SampleArray)
+HIRZEL_ARRAY_IO_DECLARE(Sample, SampleArray)
+HIRZEL_ARRAY_IO_DEFINE(Sample, SampleArray)
+
+HIRZEL_ARRAY_DECLARE(int, IntArray)
+HIRZEL_ARRAY_DEFINE(int, IntArray)
+HIRZEL_ARRAY_IO_DECLARE(int, IntArray)
+HIRZEL_ARRAY_IO_DEFINE(int, IntArray)
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ARRAY_PATH "test_array_io.bin"
+
+// long enough to span several write and read chunks
+#define SAMPLE_COUNT 200000
+
+SampleArray make_samples(size_t count)
+{
+	SampleArray array = SampleArray_init();
+
+	for (size_t i = 0; i < count; ++i)
+		assert(SampleArray_push(&array, (Sample) { i * 0.25, (float)i / 3, (int)(i % 8) }));
+
+	return array;
+}
+
+void assert_samples(const Sample *samples, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		assert(samples[i].time == i * 0.25);
+		assert(samples[i].value == (float)i / 3);
+		assert(samples[i].channel == (int)(i % 8));
+	}
+}
+
+void write_array(const SampleArray *array, const char *path)
+{
+	FILE *file = fopen(path, "wb");
+	assert(file != NULL);
+	assert(SampleArray_write(array, file));
+	assert(!fclose(file));
+}
+
+void test_write_read()
+{
+	puts("\tTesting write() and read()");
+
+	// chunks are exactly the chunk size, or one item when an item is larger
+	assert(HIRZEL_ARRAY_IO_CHUNK_LENGTH(sizeof(int)) * sizeof(int) == HIRZEL_ARRAY_IO_CHUNK_SIZE);
+	assert(HIRZEL_ARRAY_IO_CHUNK_LENGTH(HIRZEL_ARRAY_IO_CHUNK_SIZE * 2) == 1);
+
+	SampleArray array = make_samples(SAMPLE_COUNT);
+	FILE *file = tmpfile();
+	assert(file != NULL);
+
+	assert(SampleArray_write(&array, file));
+	rewind(file);
+
+	// items already in the array are replaced
+	SampleArray copy = make_samples(10);
+	assert(SampleArray_read(&copy, file));
+	assert(copy.length == SAMPLE_COUNT);
+	assert_samples(copy.buffer, copy.length);
+
+	fclose(file);
+	SampleArray_free(&copy);
+	SampleArray_free(&array);
+}
+
+void test_empty()
+{
+	puts("\tTesting empty arrays");
+
+	SampleArray array = SampleArray_init();
+	FILE *file = tmpfile();
+	assert(file != NULL);
+
+	assert(SampleArray_write(&array, file));
+	rewind(file);
+
+	SampleArray copy = make_samples(10);
+	assert(SampleArray_read(&copy, file));
+	assert(copy.length == 0);
+
+	fclose(file);
+	SampleArray_free(&copy);
+
+	write_array(&array, ARRAY_PATH);
+
+	SampleArrayMapping mapping;
+	assert(SampleArray_map(&mapping, ARRAY_PATH, true));
+	assert(mapping.length == 0);
+	SampleArray_unmap(&mapping);
+
+	remove(ARRAY_PATH);
+}
+
+void test_map()
+{
+	puts("\tTesting map()");
+
+	SampleArray array = make_samples(SAMPLE_COUNT);
+	write_array(&array, ARRAY_PATH);
+	SampleArray_free(&array);
+
+	SampleArrayMapping mapping;
+	assert(SampleArray_map(&mapping, ARRAY_PATH, true));
+	assert(mapping.length == SAMPLE_COUNT);
+	assert_samples(mapping.buffer, mapping.length);
+
+	SampleArray_unmap(&mapping);
+	assert(mapping.buffer == NULL);
+	assert(mapping.length == 0);
+
+	// items of another size are refused
+	IntArrayMapping int_mapping;
+	assert(!IntArray_map(&int_mapping, ARRAY_PATH, false));
+
+	remove(ARRAY_PATH);
+}
+
+void test_load()
+{
+	puts("\tTesting load()");
+
+	SampleArray array = make_samples(SAMPLE_COUNT);
+	write_array(&array, ARRAY_PATH);
+	SampleArray_free(&array);
+
+	SampleArray copy = make_samples(10);
+	assert(SampleArray_load(&copy, ARRAY_PATH));
+	assert(copy.length == SAMPLE_COUNT);
+	assert_samples(copy.buffer, copy.length);
+
+	IntArray ints = IntArray_init();
+	assert(!IntArray_load(&ints, ARRAY_PATH));
+	assert(!SampleArray_load(&copy, "does-not-exist.bin"));
+	assert(copy.length == 0);
+
+	remove(ARRAY_PATH);
+	IntArray_free(&ints);
+	SampleArray_free(&copy);
+}
+
+void test_corruption()
+{
+	puts("\tTesting corrupt files");
+
+	SampleArray array = make_samples(1000);
+	FILE *file = tmpfile();
+	assert(file != NULL);
+
+	assert(SampleArray_write(&array, file));
+
+	// flipping a bit in the last item fails the checksum
+	long size = ftell(file);
+	fseek(file, size - 1, SEEK_SET);
+	fputc(0x55, file);
+	rewind(file);
+
+	SampleArray copy = make_samples(10);
+	assert(!SampleArray_read(&copy, file));
+	assert(copy.length == 0);
+
+	// so does reading another item type
+	rewind(file);
+	IntArray ints = IntArray_init();
+	assert(!IntArray_read(&ints, file));
+
+	// and the file ending early
+	rewind(file);
+	char buffer[sizeof(HirzelArrayHeader) + 100];
+	assert(fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer));
+	fclose(file);
+
+	file = tmpfile();
+	assert(file != NULL);
+	assert(fwrite(buffer, 1, sizeof(buffer), file) == sizeof(buffer));
+	rewind(file);
+	assert(!SampleArray_read(&copy, file));
+	assert(copy.length == 0);
+	fclose(file);
+
+	// a truncated mapping is refused whether or not the checksum is verified
+	file = fopen(ARRAY_PATH, "wb");
+	assert(file != NULL);
+	assert(fwrite(buffer, 1, sizeof(buffer), file) == sizeof(buffer));
+	fclose(file);
+
+	SampleArrayMapping mapping;
+	assert(!SampleArray_map(&mapping, ARRAY_PATH, false));
+	assert(!SampleArray_map(&mapping, "does-not-exist.bin", false));
+	assert(!SampleArray_load(&copy, ARRAY_PATH));
+
+	remove(ARRAY_PATH);
+	IntArray_free(&ints);
+	SampleArray_free(&copy);
+	SampleArray_free(&array);
+}
+
+int main(void)
+{
+	puts("Testing Array IO...");
+	test_write_read();
+	test_empty();
+	test_map();
+	test_load();
+	test_corruption();
+
+	puts("All tests passed");
+
+	return 0;
+}
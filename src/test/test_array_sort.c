@@ -0,0 +1,240 @@
+#include <hirzel/array_sort.h>
+
+typedef struct Pair
+{
+	int key;
+	int order;
+} Pair;
+
+#define PAIR_LESS(a, b) ((a)->key < (b)->key)
+
+HIRZEL_ARRAY_DECLARE(int, IntArray)
+HIRZEL_ARRAY_DEFINE(int, IntArray)
+HIRZEL_ARRAY_SORT_DECLARE(int, IntArray)
+HIRZEL_ARRAY_SORT_DEFINE(int, IntArray, HIRZEL_SORT_LESS)
+
+HIRZEL_ARRAY_DECLARE(Pair, PairArray)
+HIRZEL_ARRAY_DEFINE(Pair, PairArray)
+HIRZEL_ARRAY_SORT_DECLARE(Pair, PairArray)
+HIRZEL_ARRAY_SORT_DEFINE(Pair, PairArray, PAIR_LESS)
+
+// standard library
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+typedef enum Pattern
+{
+	PATTERN_RANDOM,
+	PATTERN_FEW_KEYS,
+	PATTERN_SORTED,
+	PATTERN_REVERSED,
+	PATTERN_EQUAL,
+	PATTERN_ORGAN_PIPE,
+	PATTERN_COUNT
+} Pattern;
+
+int make_key(Pattern pattern, size_t i, size_t length)
+{
+	switch (pattern)
+	{
+		case PATTERN_RANDOM:
+			return rand();
+		case PATTERN_FEW_KEYS:
+			return rand() % 4;
+		case PATTERN_SORTED:
+			return (int)i;
+		case PATTERN_REVERSED:
+			return (int)(length - i);
+		case PATTERN_EQUAL:
+			return 7;
+		default:
+			return (int)(i < length / 2 ? i : length - i);
+	}
+}
+
+int compare_ints(const void *a, const void *b)
+{
+	int x = *(const int *)a;
+	int y = *(const int *)b;
+
+	return (x > y) - (x < y);
+}
+
+size_t lengths[] = { 0, 1, 2, 3, 16, 17, 33, 100, 1000, 10007 };
+
+void test_sort()
+{
+	puts("\tTesting sort()");
+
+	for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+	{
+		for (int pattern = 0; pattern < PATTERN_COUNT; ++pattern)
+		{
+			size_t length = lengths[l];
+			IntArray array = IntArray_init();
+			int *expected = malloc(length * sizeof(int) + 1);
+
+			for (size_t i = 0; i < length; ++i)
+			{
+				int key = make_key(pattern, i, length);
+
+				IntArray_push(&array, key);
+				expected[i] = key;
+			}
+
+			qsort(expected, length, sizeof(int), compare_ints);
+			IntArray_sort(&array);
+
+			for (size_t i = 0; i < length; ++i)
+				assert(array.buffer[i] == expected[i]);
+
+			free(expected);
+			IntArray_free(&array);
+		}
+	}
+}
+
+/*
+ * McIlroy's adversary: items start as undecided "gas" and are given values
+ * only as comparisons force them to, always so as to make the pivot look as
+ * small as possible. This drives any quicksort to its worst case.
+ */
+int *adversary_values;
+int adversary_gas;
+int adversary_solid;
+int adversary_candidate;
+
+bool adversary_less(const int *a, const int *b)
+{
+	int x = *a;
+	int y = *b;
+
+	if (adversary_values[x] == adversary_gas && adversary_values[y] == adversary_gas)
+		adversary_values[x == adversary_candidate ? x : y] = adversary_solid++;
+
+	if (adversary_values[x] == adversary_gas)
+		adversary_candidate = x;
+	else if (adversary_values[y] == adversary_gas)
+		adversary_candidate = y;
+
+	return adversary_values[x] < adversary_values[y];
+}
+
+HIRZEL_ARRAY_DECLARE(int, IndexArray)
+HIRZEL_ARRAY_DEFINE(int, IndexArray)
+HIRZEL_ARRAY_SORT_DECLARE(int, IndexArray)
+HIRZEL_ARRAY_SORT_DEFINE(int, IndexArray, adversary_less)
+
+void test_sort_adversarial()
+{
+	puts("\tTesting sort() against an adversary");
+
+	size_t length = 1 << 14;
+	IndexArray array = IndexArray_init();
+
+	adversary_values = malloc(length * sizeof(int));
+	adversary_gas = (int)length;
+	adversary_solid = 0;
+	adversary_candidate = 0;
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		adversary_values[i] = adversary_gas;
+		IndexArray_push(&array, (int)i);
+	}
+
+	IndexArray_sort(&array);
+
+	for (size_t i = 1; i < length; ++i)
+		assert(adversary_values[array.buffer[i - 1]] <= adversary_values[array.buffer[i]]);
+
+	free(adversary_values);
+	IndexArray_free(&array);
+}
+
+void test_stable_sort()
+{
+	puts("\tTesting stable_sort()");
+
+	for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+	{
+		for (int pattern = 0; pattern < PATTERN_COUNT; ++pattern)
+		{
+			size_t length = lengths[l];
+			PairArray array = PairArray_init();
+
+			for (size_t i = 0; i < length; ++i)
+				PairArray_push(&array, (Pair) { make_key(pattern, i, length), (int)i });
+
+			assert(PairArray_stable_sort(&array));
+			assert(array.length == length);
+
+			// pairs with equal keys keep the order they were pushed in
+			for (size_t i = 1; i < length; ++i)
+			{
+				const Pair *previous = array.buffer + i - 1;
+				const Pair *current = array.buffer + i;
+
+				assert(previous->key <= current->key);
+				assert(previous->key < current->key || previous->order < current->order);
+			}
+
+			PairArray_free(&array);
+		}
+	}
+}
+
+void test_bounds()
+{
+	puts("\tTesting lower_bound() and upper_bound()");
+
+	IntArray array = IntArray_init();
+	int key = 5;
+
+	assert(IntArray_lower_bound(&array, &key) == 0);
+	assert(IntArray_upper_bound(&array, &key) == 0);
+
+	// 0, 2, 2, 2, 4, 6, 8, ...
+	for (int i = 0; i < 20; ++i)
+		IntArray_push(&array, i * 2);
+
+	IntArray_insert(&array, 1, 2);
+	IntArray_insert(&array, 1, 2);
+
+	for (key = -1; key <= 40; ++key)
+	{
+		size_t lower = IntArray_lower_bound(&array, &key);
+		size_t upper = IntArray_upper_bound(&array, &key);
+
+		assert(lower <= upper);
+		assert(lower == array.length || array.buffer[lower] >= key);
+		assert(lower == 0 || array.buffer[lower - 1] < key);
+		assert(upper == array.length || array.buffer[upper] > key);
+		assert(upper == 0 || array.buffer[upper - 1] <= key);
+	}
+
+	key = 2;
+	assert(IntArray_lower_bound(&array, &key) == 1);
+	assert(IntArray_upper_bound(&array, &key) == 4);
+
+	key = 100;
+	assert(IntArray_lower_bound(&array, &key) == array.length);
+
+	IntArray_free(&array);
+}
+
+int main(void)
+{
+	puts("Testing IntArray sort...");
+
+	srand(1);
+	test_sort();
+	test_sort_adversarial();
+	test_stable_sort();
+	test_bounds();
+
+	puts("All tests passed");
+
+	return 0;
+}
@@ -0,0 +1,186 @@
+#include <hirzel/concurrent_table.h>
+
+HIRZEL_CONCURRENT_TABLE_DECLARE(int, SharedIntTable)
+HIRZEL_CONCURRENT_TABLE_DEFINE(int, SharedIntTable)
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+typedef HANDLE Thread;
+#define THREAD_RETURN DWORD WINAPI
+#define start_thread(thread, function, arg) (*(thread) = CreateThread(NULL, 0, function, arg, 0, NULL))
+#define join_thread(thread) (WaitForSingleObject(thread, INFINITE), CloseHandle(thread))
+#else
+typedef pthread_t Thread;
+#define THREAD_RETURN void *
+#define start_thread(thread, function, arg) pthread_create(thread, NULL, function, arg)
+#define join_thread(thread) pthread_join(thread, NULL)
+#endif
+
+#define THREAD_COUNT 8
+#define KEYS_PER_THREAD 5000
+
+typedef struct Worker
+{
+	SharedIntTable *table;
+	int id;
+} Worker;
+
+void test_init()
+{
+	puts("\tTesting init()");
+
+	SharedIntTable table;
+
+	assert(SharedIntTable_init(&table, 0));
+	assert(table.shard_count == HIRZEL_CONCURRENT_TABLE_DEFAULT_SHARDS);
+	SharedIntTable_free(&table);
+
+	// shard counts are rounded up to a power of two
+	assert(SharedIntTable_init(&table, 5));
+	assert(table.shard_count == 8);
+	assert(table.shard_bits == 3);
+	SharedIntTable_free(&table);
+
+	assert(SharedIntTable_init(&table, 1));
+	assert(table.shard_count == 1);
+	assert(SharedIntTable_set(&table, "key", 1));
+	assert(SharedIntTable_contains(&table, "key"));
+	SharedIntTable_free(&table);
+}
+
+void test_operations()
+{
+	puts("\tTesting set(), get(), erase() and clear()");
+
+	SharedIntTable table;
+	assert(SharedIntTable_init(&table, 16));
+	assert(SharedIntTable_reserve(&table, 1000));
+
+	char key[32];
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(SharedIntTable_set(&table, key, i));
+	}
+
+	assert(SharedIntTable_count(&table) == 1000);
+
+	// keys spread over every shard
+	for (size_t i = 0; i < table.shard_count; ++i)
+		assert(table.shards[i].table.count > 0);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		int value = -1;
+		sprintf(key, "key%d", i);
+		assert(SharedIntTable_get(&table, &value, key));
+		assert(value == i);
+	}
+
+	int value = -1;
+	assert(!SharedIntTable_get(&table, &value, "missing"));
+	assert(value == -1);
+
+	assert(SharedIntTable_set_n(&table, "key5xyz", 4, -5));
+	assert(SharedIntTable_get_n(&table, &value, "key5abc", 4));
+	assert(value == -5);
+
+	for (int i = 0; i < 1000; i += 2)
+	{
+		sprintf(key, "key%d", i);
+		SharedIntTable_erase(&table, key);
+	}
+
+	assert(SharedIntTable_count(&table) == 500);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(SharedIntTable_contains(&table, key) == (i % 2 == 1));
+	}
+
+	SharedIntTable_clear(&table);
+	assert(SharedIntTable_count(&table) == 0);
+
+	SharedIntTable_free(&table);
+}
+
+THREAD_RETURN write_keys(void *arg)
+{
+	Worker *worker = arg;
+	char key[32];
+
+	for (int i = 0; i < KEYS_PER_THREAD; ++i)
+	{
+		sprintf(key, "thread%d-%d", worker->id, i);
+		SharedIntTable_set(worker->table, key, i);
+
+		// readers of other threads' keys interleave with the writes
+		sprintf(key, "thread%d-%d", (worker->id + 1) % THREAD_COUNT, i);
+		int value;
+		if (SharedIntTable_get(worker->table, &value, key))
+			assert(value == i);
+	}
+
+	for (int i = 0; i < KEYS_PER_THREAD; i += 2)
+	{
+		sprintf(key, "thread%d-%d", worker->id, i);
+		SharedIntTable_erase(worker->table, key);
+	}
+
+	return 0;
+}
+
+void test_threads()
+{
+	puts("\tTesting concurrent access");
+
+	SharedIntTable table;
+	assert(SharedIntTable_init(&table, 4));
+
+	Thread threads[THREAD_COUNT];
+	Worker workers[THREAD_COUNT];
+
+	for (int i = 0; i < THREAD_COUNT; ++i)
+	{
+		workers[i] = (Worker) { &table, i };
+		start_thread(threads + i, write_keys, workers + i);
+	}
+
+	for (int i = 0; i < THREAD_COUNT; ++i)
+		join_thread(threads[i]);
+
+	assert(SharedIntTable_count(&table) == THREAD_COUNT * KEYS_PER_THREAD / 2);
+
+	char key[32];
+
+	for (int t = 0; t < THREAD_COUNT; ++t)
+	{
+		for (int i = 0; i < KEYS_PER_THREAD; ++i)
+		{
+			int value = -1;
+			sprintf(key, "thread%d-%d", t, i);
+			assert(SharedIntTable_get(&table, &value, key) == (i % 2 == 1));
+			assert(i % 2 == 0 || value == i);
+		}
+	}
+
+	SharedIntTable_free(&table);
+}
+
+int main(void)
+{
+	puts("Testing Concurrent Table...");
+	test_init();
+	test_operations();
+	test_threads();
+
+	puts("All tests passed");
+
+	return 0;
+}
@@ -0,0 +1,344 @@
+#include <hirzel/dense_table.h>
+
+HIRZEL_DENSE_TABLE_DECLARE(int, IntDenseTable)
+HIRZEL_DENSE_TABLE_DEFINE(int, IntDenseTable)
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+const char * const valid_keys[] = {
+	"abc", "def", "hij", "klm", "nop", "qrs", "tuv", "wxy", "z"
+};
+
+const size_t valid_key_count = sizeof(valid_keys) / sizeof(*valid_keys);
+
+const char * const invalid_keys[] = {
+	"hello", "my", "name", "is", "Ike"
+};
+
+const size_t invalid_key_count = sizeof(invalid_keys) / sizeof(*invalid_keys);
+
+// every live entry is reachable through exactly one slot
+void assert_invariants(const IntDenseTable *table)
+{
+	size_t live_count = 0;
+	size_t slot_count = 0;
+
+	for (size_t i = 0; i < table->entry_count; ++i)
+	{
+		if (table->entries[i].key)
+			live_count += 1;
+	}
+
+	for (size_t i = 0; i < table->capacity; ++i)
+	{
+		if (table->slots[i])
+		{
+			assert(table->slots[i] <= table->entry_count);
+			slot_count += 1;
+		}
+	}
+
+	assert(live_count == table->count);
+	assert(slot_count == table->entry_count);
+	assert(table->entry_count <= table->entry_capacity);
+}
+
+void test_init()
+{
+	puts("\tTesting init()");
+
+	IntDenseTable table;
+	assert(IntDenseTable_init(&table));
+
+	assert(table.slots != NULL);
+	assert(table.entries != NULL);
+	assert(table.count == 0);
+	assert(table.entry_count == 0);
+	assert(table.capacity == HIRZEL_DENSE_TABLE_MIN_CAPACITY);
+
+	for (size_t i = 0; i < table.capacity; ++i)
+		assert(table.slots[i] == 0);
+
+	IntDenseTable_free(&table);
+}
+
+void test_reserve()
+{
+	puts("\tTesting reserve() and shrink()");
+
+	IntDenseTable table;
+	assert(IntDenseTable_init(&table));
+
+	assert(IntDenseTable_reserve(&table, 1000));
+	assert(table.capacity == 2048);
+
+	assert(IntDenseTable_reserve(&table, 10));
+	assert(table.capacity == 2048);
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntDenseTable_set(&table, valid_keys[i], (int)i));
+
+	assert(IntDenseTable_shrink(&table));
+	assert(table.capacity == HIRZEL_DENSE_TABLE_MIN_CAPACITY);
+	assert_invariants(&table);
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(*IntDenseTable_get_ptr(&table, valid_keys[i]) == (int)i);
+
+	IntDenseTable_free(&table);
+}
+
+void test_set()
+{
+	puts("\tTesting set()");
+
+	IntDenseTable table;
+	assert(IntDenseTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntDenseTable_set(&table, key, i));
+		assert(table.count == (size_t)i + 1);
+	}
+
+	assert_invariants(&table);
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(*IntDenseTable_get_ptr(&table, key) == i);
+	}
+
+	assert(IntDenseTable_set(&table, "key0", -1));
+	assert(table.count == 10000);
+	assert(*IntDenseTable_get_ptr(&table, "key0") == -1);
+
+	assert(IntDenseTable_set_n(&table, "key1234567", 4, 7));
+	assert(*IntDenseTable_get_ptr(&table, "key1") == 7);
+	assert(table.count == 10000);
+
+	IntDenseTable_free(&table);
+}
+
+void test_get()
+{
+	puts("\tTesting get()");
+
+	IntDenseTable table;
+	assert(IntDenseTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntDenseTable_set(&table, valid_keys[i], (int)i * 3));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		int value;
+		assert(IntDenseTable_get(&table, &value, valid_keys[i]));
+		assert(value == (int)i * 3);
+	}
+
+	for (size_t i = 0; i < invalid_key_count; ++i)
+	{
+		int value = -1;
+		assert(!IntDenseTable_get(&table, &value, invalid_keys[i]));
+		assert(value == -1);
+		assert(IntDenseTable_get_ptr(&table, invalid_keys[i]) == NULL);
+	}
+
+	IntDenseTable_free(&table);
+}
+
+void test_erase()
+{
+	puts("\tTesting erase()");
+
+	IntDenseTable table;
+	assert(IntDenseTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntDenseTable_set(&table, key, i));
+	}
+
+	for (int i = 0; i < 1000; i += 2)
+	{
+		sprintf(key, "key%d", i);
+		IntDenseTable_erase(&table, key);
+	}
+
+	assert(table.count == 500);
+	assert(table.entry_count == 1000);
+	assert_invariants(&table);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntDenseTable_contains(&table, key) == (i % 2 == 1));
+	}
+
+	IntDenseTable_erase(&table, "missing");
+	assert(table.count == 500);
+
+	IntDenseTable_free(&table);
+}
+
+void test_churn()
+{
+	puts("\tTesting churn");
+
+	IntDenseTable table;
+	assert(IntDenseTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 100000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntDenseTable_set(&table, key, i));
+
+		if (i >= 5)
+		{
+			sprintf(key, "key%d", i - 5);
+			IntDenseTable_erase(&table, key);
+		}
+	}
+
+	// holes are closed up in place rather than growing the table
+	assert(table.count == 5);
+	assert(table.capacity == HIRZEL_DENSE_TABLE_MIN_CAPACITY);
+	assert_invariants(&table);
+
+	for (int i = 100000 - 5; i < 100000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntDenseTable_contains(&table, key));
+	}
+
+	IntDenseTable_free(&table);
+}
+
+void test_clear()
+{
+	puts("\tTesting clear()");
+
+	IntDenseTable table;
+	assert(IntDenseTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntDenseTable_set(&table, valid_keys[i], (int)i));
+
+	IntDenseTable_clear(&table);
+	assert(IntDenseTable_is_empty(&table));
+	assert(table.entry_count == 0);
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(!IntDenseTable_contains(&table, valid_keys[i]));
+
+	assert(IntDenseTable_set(&table, "abc", 1));
+	assert(*IntDenseTable_get_ptr(&table, "abc") == 1);
+
+	IntDenseTable_free(&table);
+}
+
+void test_swap()
+{
+	puts("\tTesting swap()");
+
+	IntDenseTable table;
+	assert(IntDenseTable_init(&table));
+
+	assert(IntDenseTable_set(&table, "a", 1));
+	assert(IntDenseTable_set(&table, "b", 2));
+
+	assert(IntDenseTable_swap(&table, "a", "b"));
+	assert(*IntDenseTable_get_ptr(&table, "a") == 2);
+	assert(*IntDenseTable_get_ptr(&table, "b") == 1);
+	assert(!IntDenseTable_swap(&table, "a", "c"));
+
+	IntDenseTable_free(&table);
+}
+
+void test_iter()
+{
+	puts("\tTesting iter_begin() and iter_next()");
+
+	IntDenseTable table;
+	assert(IntDenseTable_init(&table));
+
+	IntDenseTableIter iter = IntDenseTable_iter_begin(&table);
+	assert(IntDenseTable_iter_next(&table, &iter) == NULL);
+
+	char key[32];
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntDenseTable_set(&table, key, i));
+	}
+
+	for (int i = 0; i < 1000; i += 3)
+	{
+		sprintf(key, "key%d", i);
+		IntDenseTable_erase(&table, key);
+	}
+
+	// setting a key again keeps its place, erasing and setting it moves it last
+	assert(IntDenseTable_set(&table, "key1", 1));
+	assert(IntDenseTable_set(&table, "key0", 1000));
+
+	int expected = 1;
+	IntDenseTableEntry *entry;
+	iter = IntDenseTable_iter_begin(&table);
+
+	while ((entry = IntDenseTable_iter_next(&table, &iter)))
+	{
+		sprintf(key, "key%d", expected % 1000);
+		assert(entry->value == expected);
+		assert(!strcmp(entry->key, key));
+
+		expected += expected % 3 == 1 ? 1 : 2;
+	}
+
+	assert(expected == 1001);
+
+	// erasing the entry just visited is allowed
+	iter = IntDenseTable_iter_begin(&table);
+
+	while ((entry = IntDenseTable_iter_next(&table, &iter)))
+	{
+		if (entry->value % 2 == 0)
+			IntDenseTable_erase(&table, entry->key);
+	}
+
+	assert_invariants(&table);
+	assert(table.count == 333);
+
+	IntDenseTable_free(&table);
+}
+
+int main(void)
+{
+	puts("Testing Dense Table...");
+	test_init();
+	test_reserve();
+	test_set();
+	test_get();
+	test_erase();
+	test_churn();
+	test_clear();
+	test_swap();
+	test_iter();
+
+	puts("All tests passed");
+
+	return 0;
+}
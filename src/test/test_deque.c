@@ -0,0 +1,181 @@
+#include <hirzel/deque.h>
+
+HIRZEL_DEQUE_DECLARE(int, IntDeque)
+HIRZEL_DEQUE_DEFINE(int, IntDeque)
+
+// standard library
+#include <stdio.h>
+#include <assert.h>
+
+// checks a deque holds first, first + 1, ... through get and through its slices
+void assert_sequence(IntDeque *deque, int first, size_t length)
+{
+	assert(deque->length == length);
+
+	for (size_t i = 0; i < length; ++i)
+		assert(IntDeque_get(deque, i) == first + (int)i);
+
+	IntDequeSlice slices[2];
+	size_t i = 0;
+
+	IntDeque_slices(deque, slices, slices + 1);
+	assert(slices[0].length + slices[1].length == length);
+
+	for (size_t s = 0; s < 2; ++s)
+	{
+		for (size_t j = 0; j < slices[s].length; ++j, ++i)
+			assert(slices[s].data[j] == first + (int)i);
+	}
+}
+
+void test_init()
+{
+	puts("\tTesting init()");
+
+	IntDeque deque = IntDeque_init();
+
+	assert(deque.buffer == NULL);
+	assert(deque.length == 0);
+	assert(deque.capacity == 0);
+	assert(IntDeque_is_empty(&deque));
+
+	IntDeque_pop(&deque);
+	IntDeque_popf(&deque);
+	assert(IntDeque_popf_n(&deque, NULL, 4) == 0);
+
+	IntDeque_free(&deque);
+}
+
+void test_push_pop()
+{
+	puts("\tTesting push() and pop()");
+
+	IntDeque deque = IntDeque_init();
+
+	for (int i = 0; i < 5; ++i)
+		assert(*IntDeque_push(&deque, i) == i);
+
+	for (int i = -1; i >= -5; --i)
+		assert(*IntDeque_pushf(&deque, i) == i);
+
+	assert(deque.capacity == 16);
+	assert_sequence(&deque, -5, 10);
+	assert(IntDeque_front(&deque) == -5);
+	assert(IntDeque_back(&deque) == 4);
+
+	IntDeque_popf(&deque);
+	IntDeque_pop(&deque);
+	assert_sequence(&deque, -4, 8);
+
+	IntDeque_set(&deque, 0, 100);
+	assert(*IntDeque_front_ptr(&deque) == 100);
+
+	IntDeque_clear(&deque);
+	assert(IntDeque_is_empty(&deque));
+	assert(deque.capacity == 16);
+
+	IntDeque_free(&deque);
+}
+
+void test_wrap()
+{
+	puts("\tTesting wrapping around");
+
+	IntDeque deque = IntDeque_init();
+	int next = 0;
+	int first = 0;
+
+	// a queue that never holds more than 6 items stays in the smallest buffer
+	for (int round = 0; round < 101; ++round)
+	{
+		for (int i = 0; i < 6; ++i)
+			IntDeque_push(&deque, next++);
+
+		assert_sequence(&deque, first, 6);
+
+		for (int i = 0; i < 6; ++i)
+		{
+			assert(IntDeque_front(&deque) == first++);
+			IntDeque_popf(&deque);
+		}
+	}
+
+	assert(deque.capacity == 8);
+
+	// growing while wrapped keeps the order
+	for (int i = 0; i < 6; ++i)
+		IntDeque_push(&deque, next++);
+
+	assert(deque.head + deque.length > deque.capacity);
+
+	for (int i = 0; i < 100; ++i)
+		IntDeque_push(&deque, next++);
+
+	assert_sequence(&deque, first, 106);
+
+	// as does growing from the front
+	IntDeque deque_front = IntDeque_init();
+
+	IntDeque_push(&deque_front, 0);
+
+	for (int i = -1; i > -100; --i)
+		IntDeque_pushf(&deque_front, i);
+
+	assert_sequence(&deque_front, -99, 100);
+
+	IntDeque_free(&deque_front);
+	IntDeque_free(&deque);
+}
+
+void test_bulk()
+{
+	puts("\tTesting push_n() and popf_n()");
+
+	IntDeque deque = IntDeque_init();
+	int items[100];
+	int out[100];
+
+	for (int i = 0; i < 100; ++i)
+		items[i] = i;
+
+	assert(IntDeque_push_n(&deque, items, 5));
+	assert(IntDeque_popf_n(&deque, out, 3) == 3);
+	assert(out[0] == 0 && out[2] == 2);
+
+	// wraps around the end of the 8 slot buffer
+	assert(IntDeque_push_n(&deque, items + 5, 5));
+	assert(deque.capacity == 8);
+	assert_sequence(&deque, 3, 7);
+
+	IntDequeSlice first, second;
+	IntDeque_slices(&deque, &first, &second);
+	assert(first.length == 5 && second.length == 2);
+
+	assert(IntDeque_popf_n(&deque, out, 7) == 7);
+
+	for (int i = 0; i < 7; ++i)
+		assert(out[i] == i + 3);
+
+	assert(IntDeque_push_n(&deque, items, 100));
+	assert_sequence(&deque, 0, 100);
+	assert(IntDeque_popf_n(&deque, NULL, 40) == 40);
+	assert(IntDeque_popf_n(&deque, out, 100) == 60);
+	assert(out[0] == 40 && out[59] == 99);
+	assert(IntDeque_push_n(&deque, items, 0));
+
+	IntDeque_free(&deque);
+}
+
+int main(void)
+{
+	puts("Testing IntDeque...");
+
+	test_init();
+	test_push_pop();
+	test_wrap();
+	test_bulk();
+
+	puts("All tests passed");
+
+	return 0;
+}
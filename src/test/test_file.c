@@ -0,0 +1,215 @@
+#include <hirzel/file.h>
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEXT_PATH "text.txt"
+#define OUTPUT_PATH "test_file.txt"
+
+bool slice_equals(HirzelFileSlice slice, const char *expected)
+{
+	return slice.length == strlen(expected) && !memcmp(slice.data, expected, slice.length);
+}
+
+void test_map()
+{
+	puts("\tTesting map()");
+
+	HirzelFileMap map;
+	assert(hirzel_file_map(&map, TEXT_PATH));
+	assert(map.size == 20);
+	assert(!memcmp(map.data, "this is a\ntest file\n", 20));
+	hirzel_file_unmap(&map);
+	assert(map.data == NULL);
+
+	assert(!hirzel_file_map(&map, "does-not-exist.txt"));
+}
+
+void test_reader()
+{
+	puts("\tTesting reader");
+
+	HirzelFileReader reader;
+	HirzelFileSlice line;
+
+	assert(hirzel_file_reader_open(&reader, TEXT_PATH, 0));
+	assert(hirzel_file_reader_next_line(&reader, &line));
+	assert(slice_equals(line, "this is a"));
+	assert(hirzel_file_reader_next_line(&reader, &line));
+	assert(slice_equals(line, "test file"));
+	assert(!hirzel_file_reader_next_line(&reader, &line));
+	assert(!reader.is_error);
+	hirzel_file_reader_close(&reader);
+
+	assert(!hirzel_file_reader_open(&reader, "does-not-exist.txt", 0));
+
+	// records longer than the buffer, crlf endings and no final delimiter
+	FILE *file = tmpfile();
+	assert(file != NULL);
+
+	for (int i = 0; i < 100; ++i)
+		fprintf(file, "record %d with some padding\r\n", i);
+
+	fputs("last", file);
+	rewind(file);
+
+	assert(hirzel_file_reader_init(&reader, file, 8));
+
+	char expected[64];
+
+	for (int i = 0; i < 100; ++i)
+	{
+		snprintf(expected, sizeof(expected), "record %d with some padding", i);
+		assert(hirzel_file_reader_next_line(&reader, &line));
+		assert(slice_equals(line, expected));
+	}
+
+	assert(hirzel_file_reader_next_line(&reader, &line));
+	assert(slice_equals(line, "last"));
+	assert(!hirzel_file_reader_next_line(&reader, &line));
+	hirzel_file_reader_close(&reader);
+
+	// other delimiters, keeping empty records
+	rewind(file);
+	fputs("a,,bc,", file);
+	fflush(file);
+	rewind(file);
+
+	assert(hirzel_file_reader_init(&reader, file, 0));
+	assert(hirzel_file_reader_next(&reader, ',', &line) && slice_equals(line, "a"));
+	assert(hirzel_file_reader_next(&reader, ',', &line) && slice_equals(line, ""));
+	assert(hirzel_file_reader_next(&reader, ',', &line) && slice_equals(line, "bc"));
+	hirzel_file_reader_close(&reader);
+
+	fclose(file);
+}
+
+void test_writer()
+{
+	puts("\tTesting writer");
+
+	HirzelFileWriter writer;
+
+	// a small buffer so writes pass through it, overflow it and skip it
+	assert(hirzel_file_writer_open(&writer, OUTPUT_PATH, 16));
+	assert(hirzel_file_writer_write_string(&writer, "this is a\n"));
+	assert(hirzel_file_writer_printf(&writer, "%s %s\n", "test", "file"));
+	assert(hirzel_file_writer_printf(&writer, "%040d\n", 7));
+	assert(hirzel_file_writer_write(&writer, "0123456789012345678901234567890123456789\n", 41));
+	assert(hirzel_file_writer_close(&writer));
+
+	HirzelFileReader reader;
+	HirzelFileSlice line;
+
+	assert(hirzel_file_reader_open(&reader, OUTPUT_PATH, 0));
+	assert(hirzel_file_reader_next_line(&reader, &line) && slice_equals(line, "this is a"));
+	assert(hirzel_file_reader_next_line(&reader, &line) && slice_equals(line, "test file"));
+	assert(hirzel_file_reader_next_line(&reader, &line) && slice_equals(line, "0000000000000000000000000000000000000007"));
+	assert(hirzel_file_reader_next_line(&reader, &line) && slice_equals(line, "0123456789012345678901234567890123456789"));
+	assert(!hirzel_file_reader_next_line(&reader, &line));
+	hirzel_file_reader_close(&reader);
+
+	remove(OUTPUT_PATH);
+}
+
+void test_queue()
+{
+	puts("\tTesting queue");
+
+	HirzelFileQueue queue;
+	char buffer[32] = { 0 };
+
+	assert(hirzel_file_queue_open(&queue, TEXT_PATH, 2));
+	assert(queue.size == 20);
+
+	// blocks of 3 bytes take turns in the two slots
+	assert(hirzel_file_queue_read(&queue, buffer, 20, 0, 3));
+	assert(!memcmp(buffer, "this is a\ntest file\n", 20));
+	assert(hirzel_file_queue_read(&queue, buffer, 4, 10, 0));
+	assert(!memcmp(buffer, "test", 4));
+
+	// reads past the end of the file complete short
+	assert(!hirzel_file_queue_read(&queue, buffer, 21, 0, 0));
+	assert(!queue.is_error);
+
+	size_t slot;
+
+	assert(hirzel_file_queue_submit(&queue, 1, buffer, sizeof(buffer), 15));
+	assert(hirzel_file_queue_wait(&queue, &slot));
+	assert(slot == 1);
+	assert(queue.reads[1].length == 5);
+	assert(!memcmp(buffer, "file\n", 5));
+	assert(!hirzel_file_queue_wait(&queue, &slot));
+
+	hirzel_file_queue_close(&queue);
+
+	assert(!hirzel_file_queue_open(&queue, "does-not-exist.txt", 0));
+}
+
+void test_blocks()
+{
+	puts("\tTesting blocks");
+
+	FILE *file = fopen(OUTPUT_PATH, "wb");
+	assert(file != NULL);
+
+	for (int i = 0; i < 10000; ++i)
+		fputc(i % 251, file);
+
+	fclose(file);
+
+	size_t block_sizes[] = { 64, 1000, 10000, 65536 };
+
+	for (size_t i = 0; i < sizeof(block_sizes) / sizeof(block_sizes[0]); ++i)
+	{
+		HirzelFileBlocks blocks;
+		HirzelFileSlice block;
+		size_t offset = 0;
+
+		assert(hirzel_file_blocks_open(&blocks, OUTPUT_PATH, block_sizes[i], 4));
+
+		while (hirzel_file_blocks_next(&blocks, &block))
+		{
+			assert(block.length == block_sizes[i] || offset + block.length == 10000);
+
+			for (size_t j = 0; j < block.length; ++j)
+				assert((unsigned char)block.data[j] == (offset + j) % 251);
+
+			offset += block.length;
+		}
+
+		assert(offset == 10000);
+		assert(!blocks.queue.is_error);
+		hirzel_file_blocks_close(&blocks);
+	}
+
+	// empty files have no blocks
+	file = fopen(OUTPUT_PATH, "wb");
+	assert(file != NULL);
+	fclose(file);
+
+	HirzelFileBlocks blocks;
+	HirzelFileSlice block;
+
+	assert(hirzel_file_blocks_open(&blocks, OUTPUT_PATH, 0, 0));
+	assert(!hirzel_file_blocks_next(&blocks, &block));
+	hirzel_file_blocks_close(&blocks);
+
+	remove(OUTPUT_PATH);
+}
+
+int main(void)
+{
+	puts("Testing File...");
+	test_map();
+	test_reader();
+	test_writer();
+	test_queue();
+	test_blocks();
+
+	puts("All tests passed");
+
+	return 0;
+}
@@ -0,0 +1,150 @@
+#include <hirzel/hash.h>
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+unsigned popcount64(uint64_t value)
+{
+	unsigned count = 0;
+
+	while (value)
+	{
+		value &= value - 1;
+		count += 1;
+	}
+
+	return count;
+}
+
+void test_mum()
+{
+	puts("\tTesting mum()");
+
+	uint64_t a = 0xffffffffffffffffull;
+	uint64_t b = 0xffffffffffffffffull;
+	hirzel_hash_mum(&a, &b);
+	assert(a == 1);
+	assert(b == 0xfffffffffffffffeull);
+
+	a = 0x100000000ull;
+	b = 0x100000000ull;
+	hirzel_hash_mum(&a, &b);
+	assert(a == 0);
+	assert(b == 1);
+
+	a = 12345;
+	b = 678;
+	hirzel_hash_mum(&a, &b);
+	assert(a == 12345 * 678);
+	assert(b == 0);
+}
+
+void test_hash_bytes()
+{
+	puts("\tTesting hash_bytes()");
+
+	char buffer[256];
+
+	for (size_t i = 0; i < sizeof(buffer); ++i)
+		buffer[i] = (char)(i * 7 + 3);
+
+	uint64_t hashes[sizeof(buffer) + 1];
+
+	// every length exercises a different combination of the read paths
+	for (size_t length = 0; length <= sizeof(buffer); ++length)
+	{
+		hashes[length] = hirzel_hash_bytes(buffer, length, HIRZEL_HASH_DEFAULT_SEED);
+		assert(hashes[length] == hirzel_hash_bytes(buffer, length, HIRZEL_HASH_DEFAULT_SEED));
+
+		for (size_t i = 0; i < length; ++i)
+			assert(hashes[i] != hashes[length]);
+	}
+}
+
+void test_hash_string()
+{
+	puts("\tTesting hash_string()");
+
+	const char *key = "https://example.com/some/long/path?with=query";
+
+	assert(hirzel_hash_string(key) == hirzel_hash_bytes(key, strlen(key), HIRZEL_HASH_DEFAULT_SEED));
+	assert(hirzel_hash_string("") == hirzel_hash_bytes("", 0, HIRZEL_HASH_DEFAULT_SEED));
+	assert(hirzel_hash_string("abc") != hirzel_hash_string("abd"));
+	assert(hirzel_hash_string("abc") != hirzel_hash_string("cba"));
+}
+
+void test_seed()
+{
+	puts("\tTesting hash_string_seeded()");
+
+	const char *key = "key";
+
+	assert(hirzel_hash_string_seeded(key, 1) == hirzel_hash_string_seeded(key, 1));
+	assert(hirzel_hash_string_seeded(key, 1) != hirzel_hash_string_seeded(key, 2));
+	assert(hirzel_hash_string_seeded(key, HIRZEL_HASH_DEFAULT_SEED) == hirzel_hash_string(key));
+}
+
+void test_avalanche()
+{
+	puts("\tTesting avalanche");
+
+	unsigned char buffer[40] = { 0 };
+
+	for (size_t length = 1; length <= sizeof(buffer); length += 3)
+	{
+		uint64_t base = hirzel_hash_bytes(buffer, length, 0);
+		unsigned total = 0;
+
+		for (size_t bit = 0; bit < length * 8; ++bit)
+		{
+			buffer[bit / 8] ^= (unsigned char)(1 << (bit % 8));
+			total += popcount64(base ^ hirzel_hash_bytes(buffer, length, 0));
+			buffer[bit / 8] ^= (unsigned char)(1 << (bit % 8));
+		}
+
+		// a single flipped input bit should flip about half of the output
+		double average = (double)total / (double)(length * 8);
+		assert(average > 28.0 && average < 36.0);
+	}
+}
+
+void test_mix()
+{
+	puts("\tTesting mix()");
+
+	assert(hirzel_hash_mix(0) == 0);
+	assert(hirzel_hash_mix(1) != 1);
+	assert(hirzel_hash_mix(1) != hirzel_hash_mix(2));
+	assert(popcount64(hirzel_hash_mix(1) ^ hirzel_hash_mix(2)) > 16);
+
+	// small sequential inputs, the weakest case, still avalanche
+	for (uint64_t input = 1; input < 64; ++input)
+	{
+		uint64_t base = hirzel_hash_mix(input);
+		size_t total = 0;
+
+		for (size_t bit = 0; bit < 64; ++bit)
+			total += popcount64(base ^ hirzel_hash_mix(input ^ ((uint64_t)1 << bit)));
+
+		double average = (double)total / 64.0;
+		assert(average > 28.0 && average < 36.0);
+	}
+}
+
+int main(void)
+{
+	puts("Testing hash...");
+
+	test_mum();
+	test_hash_bytes();
+	test_hash_string();
+	test_seed();
+	test_avalanche();
+	test_mix();
+
+	puts("All tests passed");
+
+	return 0;
+}
@@ -0,0 +1,279 @@
+#include <hirzel/map.h>
+
+HIRZEL_MAP_DECLARE(int, int, IntMap, HIRZEL_MAP_INT_HASH, HIRZEL_MAP_INT_EQ)
+HIRZEL_MAP_DEFINE(int, int, IntMap, HIRZEL_MAP_INT_HASH, HIRZEL_MAP_INT_EQ)
+
+typedef struct Point
+{
+	int x;
+	int y;
+} Point;
+
+#define POINT_HASH(point) ((size_t)(((uint64_t)(unsigned)(point).x << 32) ^ (unsigned)(point).y))
+#define POINT_EQ(a, b) ((a).x == (b).x && (a).y == (b).y)
+
+HIRZEL_MAP_DECLARE(Point, double, PointMap, POINT_HASH, POINT_EQ)
+HIRZEL_MAP_DEFINE(Point, double, PointMap, POINT_HASH, POINT_EQ)
+
+HIRZEL_MAP_DECLARE(const void *, int, PtrMap, HIRZEL_MAP_PTR_HASH, HIRZEL_MAP_PTR_EQ)
+HIRZEL_MAP_DEFINE(const void *, int, PtrMap, HIRZEL_MAP_PTR_HASH, HIRZEL_MAP_PTR_EQ)
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+
+void test_init()
+{
+	puts("\tTesting init()");
+
+	IntMap map;
+	assert(IntMap_init(&map));
+
+	assert(map.slots != NULL);
+	assert(map.count == 0);
+	assert(map.capacity == HIRZEL_MAP_MIN_CAPACITY);
+
+	for (size_t i = 0; i < map.capacity; ++i)
+		assert(map.slots[i].state == HIRZEL_MAP_EMPTY);
+
+	IntMap_free(&map);
+}
+
+void test_reserve()
+{
+	puts("\tTesting reserve()");
+
+	IntMap map;
+	assert(IntMap_init(&map));
+
+	assert(IntMap_reserve(&map, 10));
+	assert(map.capacity == 16);
+
+	assert(IntMap_reserve(&map, 500));
+	assert(map.capacity == 1024);
+
+	assert(IntMap_reserve(&map, 10));
+	assert(map.capacity == 1024);
+
+	IntMap_free(&map);
+}
+
+void test_shrink()
+{
+	puts("\tTesting shrink()");
+
+	IntMap map;
+	assert(IntMap_init(&map));
+
+	assert(IntMap_reserve(&map, 500));
+
+	for (int i = 0; i < 10; ++i)
+		assert(IntMap_set(&map, i, i));
+
+	assert(IntMap_shrink(&map));
+	assert(map.capacity == 16);
+
+	for (int i = 0; i < 10; ++i)
+		assert(*IntMap_get_ptr(&map, i) == i);
+
+	IntMap_free(&map);
+}
+
+void test_set()
+{
+	puts("\tTesting set()");
+
+	IntMap map;
+	assert(IntMap_init(&map));
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		assert(IntMap_set(&map, i * 7, i));
+		assert(map.count == (size_t)i + 1);
+	}
+
+	assert(map.capacity == 16384);
+
+	for (int i = 0; i < 10000; ++i)
+		assert(*IntMap_get_ptr(&map, i * 7) == i);
+
+	assert(IntMap_set(&map, 0, -1));
+	assert(map.count == 10000);
+	assert(*IntMap_get_ptr(&map, 0) == -1);
+
+	int key = -5;
+	int value = 55;
+	assert(IntMap_set_ptr(&map, &key, &value));
+	assert(*IntMap_get_ptr(&map, -5) == 55);
+
+	IntMap_free(&map);
+}
+
+void test_get()
+{
+	puts("\tTesting get()");
+
+	IntMap map;
+	assert(IntMap_init(&map));
+
+	for (int i = 0; i < 100; ++i)
+		assert(IntMap_set(&map, i, i * 2));
+
+	for (int i = 0; i < 100; ++i)
+	{
+		int value;
+		assert(IntMap_get(&map, &value, i));
+		assert(value == i * 2);
+	}
+
+	for (int i = 100; i < 200; ++i)
+	{
+		int value = -1;
+		assert(!IntMap_get(&map, &value, i));
+		assert(value == -1);
+		assert(IntMap_get_ptr(&map, i) == NULL);
+	}
+
+	IntMap_free(&map);
+}
+
+void test_erase()
+{
+	puts("\tTesting erase()");
+
+	IntMap map;
+	assert(IntMap_init(&map));
+
+	for (int i = 0; i < 100; ++i)
+		assert(IntMap_set(&map, i, i));
+
+	for (int i = 0; i < 100; i += 2)
+		IntMap_erase(&map, i);
+
+	assert(map.count == 50);
+	assert(map.deleted_count == 50);
+
+	for (int i = 0; i < 100; ++i)
+		assert(IntMap_contains(&map, i) == (i % 2 == 1));
+
+	IntMap_erase(&map, 1000);
+	assert(map.count == 50);
+
+	IntMap_free(&map);
+}
+
+void test_churn()
+{
+	puts("\tTesting churn");
+
+	IntMap map;
+	assert(IntMap_init(&map));
+
+	for (int i = 0; i < 100000; ++i)
+	{
+		assert(IntMap_set(&map, i, i));
+
+		if (i >= 20)
+			IntMap_erase(&map, i - 20);
+	}
+
+	// tombstones are purged in place rather than growing the map
+	assert(map.count == 20);
+	assert(map.capacity <= 64);
+
+	for (int i = 100000 - 20; i < 100000; ++i)
+		assert(IntMap_contains(&map, i));
+
+	IntMap_free(&map);
+}
+
+void test_clear()
+{
+	puts("\tTesting clear()");
+
+	IntMap map;
+	assert(IntMap_init(&map));
+
+	for (int i = 0; i < 100; ++i)
+		assert(IntMap_set(&map, i, i));
+
+	IntMap_clear(&map);
+	assert(map.count == 0);
+	assert(IntMap_is_empty(&map));
+
+	for (int i = 0; i < 100; ++i)
+		assert(!IntMap_contains(&map, i));
+
+	IntMap_free(&map);
+}
+
+void test_struct_keys()
+{
+	puts("\tTesting struct keys");
+
+	PointMap map;
+	assert(PointMap_init(&map));
+
+	for (int x = -10; x < 10; ++x)
+	{
+		for (int y = -10; y < 10; ++y)
+			assert(PointMap_set(&map, (Point) { x, y }, x * 0.5 + y));
+	}
+
+	assert(map.count == 400);
+
+	for (int x = -10; x < 10; ++x)
+	{
+		for (int y = -10; y < 10; ++y)
+		{
+			double value;
+			assert(PointMap_get(&map, &value, (Point) { x, y }));
+			assert(value == x * 0.5 + y);
+		}
+	}
+
+	assert(!PointMap_contains(&map, (Point) { 10, 0 }));
+	PointMap_erase(&map, (Point) { 0, 0 });
+	assert(!PointMap_contains(&map, (Point) { 0, 0 }));
+	assert(PointMap_contains(&map, (Point) { 0, 1 }));
+
+	PointMap_free(&map);
+}
+
+void test_pointer_keys()
+{
+	puts("\tTesting pointer keys");
+
+	int values[64];
+	PtrMap map;
+	assert(PtrMap_init(&map));
+
+	for (int i = 0; i < 64; ++i)
+		assert(PtrMap_set(&map, values + i, i));
+
+	for (int i = 0; i < 64; ++i)
+		assert(*PtrMap_get_ptr(&map, values + i) == i);
+
+	assert(!PtrMap_contains(&map, NULL));
+
+	PtrMap_free(&map);
+}
+
+int main(void)
+{
+	puts("Testing Map...");
+	test_init();
+	test_reserve();
+	test_shrink();
+	test_set();
+	test_get();
+	test_erase();
+	test_churn();
+	test_clear();
+	test_struct_keys();
+	test_pointer_keys();
+
+	puts("All tests passed");
+
+	return 0;
+}
@@ -0,0 +1,212 @@
+#include <hirzel/rcu_table.h>
+
+HIRZEL_RCU_TABLE_DECLARE(int, RcuIntTable)
+HIRZEL_RCU_TABLE_DEFINE(int, RcuIntTable)
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+typedef HANDLE Thread;
+#define THREAD_RETURN DWORD WINAPI
+#define start_thread(thread, function, arg) (*(thread) = CreateThread(NULL, 0, function, arg, 0, NULL))
+#define join_thread(thread) (WaitForSingleObject(thread, INFINITE), CloseHandle(thread))
+#else
+typedef pthread_t Thread;
+#define THREAD_RETURN void *
+#define start_thread(thread, function, arg) pthread_create(thread, NULL, function, arg)
+#define join_thread(thread) pthread_join(thread, NULL)
+#endif
+
+#define READER_COUNT 4
+#define UPDATE_COUNT 500
+
+void test_init()
+{
+	puts("\tTesting init()");
+
+	RcuIntTable table;
+	assert(RcuIntTable_init(&table, 0));
+
+	assert(table.current != NULL);
+	assert(table.current->count == 0);
+	assert(table.reader_count == HIRZEL_RCU_TABLE_DEFAULT_READERS);
+	assert(table.epoch == 1);
+
+	RcuIntTable_free(&table);
+}
+
+void test_readers()
+{
+	puts("\tTesting reader_register()");
+
+	RcuIntTable table;
+	assert(RcuIntTable_init(&table, 2));
+
+	RcuIntTableReader *a = RcuIntTable_reader_register(&table);
+	RcuIntTableReader *b = RcuIntTable_reader_register(&table);
+
+	assert(a != NULL);
+	assert(b != NULL);
+	assert(a != b);
+	assert(RcuIntTable_reader_register(&table) == NULL);
+
+	RcuIntTable_reader_unregister(&table, a);
+	assert(RcuIntTable_reader_register(&table) == a);
+
+	RcuIntTable_free(&table);
+}
+
+void test_writes()
+{
+	puts("\tTesting set(), set_batch(), erase() and write batches");
+
+	RcuIntTable table;
+	assert(RcuIntTable_init(&table, 0));
+
+	RcuIntTableReader *reader = RcuIntTable_reader_register(&table);
+
+	assert(RcuIntTable_set(&table, "a", 1));
+	assert(RcuIntTable_set(&table, "b", 2));
+
+	int value = 0;
+	assert(RcuIntTable_get(&table, reader, &value, "a"));
+	assert(value == 1);
+	assert(RcuIntTable_contains(&table, reader, "b"));
+	assert(!RcuIntTable_contains(&table, reader, "c"));
+
+	// a version stays readable until the reader leaves, even once replaced
+	const RcuIntTableVersion *version = RcuIntTable_read_lock(&table, reader);
+	RcuIntTableVersion *batch = table.current;
+	RcuIntTable_read_unlock(&table, reader);
+	assert(version == batch);
+
+	batch = RcuIntTable_write_begin(&table);
+	assert(batch != NULL);
+	assert(batch != table.current);
+
+	char key[32];
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(RcuIntTableVersion_set(batch, key, i));
+	}
+
+	// nothing in a batch is visible before it is committed
+	assert(!RcuIntTable_contains(&table, reader, "key0"));
+	RcuIntTable_write_commit(&table, batch);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(RcuIntTable_get(&table, reader, &value, key));
+		assert(value == i);
+	}
+
+	assert(RcuIntTable_erase(&table, "a"));
+	assert(!RcuIntTable_contains(&table, reader, "a"));
+	assert(RcuIntTable_contains(&table, reader, "b"));
+
+	const char *batch_keys[] = { "x", "y", "z" };
+	int batch_values[] = { 24, 25, 26 };
+	assert(RcuIntTable_set_batch(&table, batch_keys, batch_values, 3));
+
+	for (int i = 0; i < 3; ++i)
+	{
+		assert(RcuIntTable_get(&table, reader, &value, batch_keys[i]));
+		assert(value == batch_values[i]);
+	}
+
+	batch = RcuIntTable_write_begin(&table);
+	assert(RcuIntTableVersion_set(batch, "aborted", 1));
+	RcuIntTable_write_abort(&table, batch);
+	assert(!RcuIntTable_contains(&table, reader, "aborted"));
+
+	RcuIntTable_reader_unregister(&table, reader);
+	RcuIntTable_free(&table);
+}
+
+typedef struct Worker
+{
+	RcuIntTable *table;
+	volatile size_t *is_done;
+} Worker;
+
+THREAD_RETURN read_pairs(void *arg)
+{
+	Worker *worker = arg;
+	RcuIntTableReader *reader = RcuIntTable_reader_register(worker->table);
+
+	assert(reader != NULL);
+
+	while (!hirzel_atomic_load(worker->is_done))
+	{
+		const RcuIntTableVersion *version = RcuIntTable_read_lock(worker->table, reader);
+		const int *first = RcuIntTableVersion_get_ptr(version, "first");
+		const int *second = RcuIntTableVersion_get_ptr(version, "second");
+
+		// both keys are written in one batch, so no reader sees them differ
+		assert(first != NULL && second != NULL);
+		assert(*first == *second);
+
+		RcuIntTable_read_unlock(worker->table, reader);
+	}
+
+	RcuIntTable_reader_unregister(worker->table, reader);
+
+	return 0;
+}
+
+void test_threads()
+{
+	puts("\tTesting concurrent readers");
+
+	RcuIntTable table;
+	assert(RcuIntTable_init(&table, 0));
+
+	RcuIntTableVersion *batch = RcuIntTable_write_begin(&table);
+	assert(RcuIntTableVersion_set(batch, "first", 0));
+	assert(RcuIntTableVersion_set(batch, "second", 0));
+	RcuIntTable_write_commit(&table, batch);
+
+	volatile size_t is_done = 0;
+	Thread threads[READER_COUNT];
+	Worker worker = { &table, &is_done };
+
+	for (int i = 0; i < READER_COUNT; ++i)
+		start_thread(threads + i, read_pairs, &worker);
+
+	for (int i = 1; i <= UPDATE_COUNT; ++i)
+	{
+		batch = RcuIntTable_write_begin(&table);
+		assert(batch != NULL);
+		assert(RcuIntTableVersion_set(batch, "first", i));
+		assert(RcuIntTableVersion_set(batch, "second", i));
+		RcuIntTable_write_commit(&table, batch);
+	}
+
+	hirzel_atomic_store(&is_done, 1);
+
+	for (int i = 0; i < READER_COUNT; ++i)
+		join_thread(threads[i]);
+
+	assert(*RcuIntTableVersion_get_ptr(table.current, "first") == UPDATE_COUNT);
+
+	RcuIntTable_free(&table);
+}
+
+int main(void)
+{
+	puts("Testing RCU Table...");
+	test_init();
+	test_readers();
+	test_writes();
+	test_threads();
+
+	puts("All tests passed");
+
+	return 0;
+}
@@ -0,0 +1,278 @@
+#include <hirzel/robin_table.h>
+
+HIRZEL_ROBIN_TABLE_DECLARE(int, IntRobinTable)
+HIRZEL_ROBIN_TABLE_DEFINE(int, IntRobinTable)
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+const char * const valid_keys[] = {
+	"abc", "def", "hij", "klm", "nop", "qrs", "tuv", "wxy", "z"
+};
+
+const size_t valid_key_count = sizeof(valid_keys) / sizeof(*valid_keys);
+
+const char * const invalid_keys[] = {
+	"hello", "my", "name", "is", "Ike"
+};
+
+const size_t invalid_key_count = sizeof(invalid_keys) / sizeof(*invalid_keys);
+
+// every key sits at its recorded distance from home and no run is out of order
+void assert_invariants(const IntRobinTable *table)
+{
+	size_t mask = table->capacity - 1;
+	size_t count = 0;
+
+	for (size_t i = 0; i < table->capacity; ++i)
+	{
+		const IntRobinTableSlot *slot = table->slots + i;
+		const IntRobinTableSlot *next = table->slots + ((i + 1) & mask);
+
+		assert(next->distance <= slot->distance + 1);
+
+		if (slot->distance == 0)
+		{
+			assert(slot->key == NULL);
+			continue;
+		}
+
+		assert(((slot->hash + slot->distance - 1) & mask) == i);
+		count += 1;
+	}
+
+	assert(count == table->count);
+}
+
+void test_init()
+{
+	puts("\tTesting init()");
+
+	IntRobinTable table;
+	assert(IntRobinTable_init(&table));
+
+	assert(table.slots != NULL);
+	assert(table.count == 0);
+	assert(table.capacity == HIRZEL_ROBIN_TABLE_MIN_CAPACITY);
+
+	for (size_t i = 0; i < table.capacity; ++i)
+		assert(table.slots[i].distance == 0);
+
+	IntRobinTable_free(&table);
+}
+
+void test_reserve()
+{
+	puts("\tTesting reserve() and shrink()");
+
+	IntRobinTable table;
+	assert(IntRobinTable_init(&table));
+
+	assert(IntRobinTable_reserve(&table, 1000));
+	assert(table.capacity == 2048);
+
+	assert(IntRobinTable_reserve(&table, 10));
+	assert(table.capacity == 2048);
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntRobinTable_set(&table, valid_keys[i], (int)i));
+
+	assert(IntRobinTable_shrink(&table));
+	assert(table.capacity == HIRZEL_ROBIN_TABLE_MIN_CAPACITY);
+	assert_invariants(&table);
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(*IntRobinTable_get_ptr(&table, valid_keys[i]) == (int)i);
+
+	IntRobinTable_free(&table);
+}
+
+void test_set()
+{
+	puts("\tTesting set()");
+
+	IntRobinTable table;
+	assert(IntRobinTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntRobinTable_set(&table, key, i));
+		assert(table.count == (size_t)i + 1);
+	}
+
+	assert_invariants(&table);
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(*IntRobinTable_get_ptr(&table, key) == i);
+	}
+
+	assert(IntRobinTable_set(&table, "key0", -1));
+	assert(table.count == 10000);
+	assert(*IntRobinTable_get_ptr(&table, "key0") == -1);
+
+	assert(IntRobinTable_set_n(&table, "key1234567", 4, 7));
+	assert(*IntRobinTable_get_ptr(&table, "key1") == 7);
+	assert(table.count == 10000);
+
+	IntRobinTable_free(&table);
+}
+
+void test_get()
+{
+	puts("\tTesting get()");
+
+	IntRobinTable table;
+	assert(IntRobinTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntRobinTable_set(&table, valid_keys[i], (int)i * 3));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		int value;
+		assert(IntRobinTable_get(&table, &value, valid_keys[i]));
+		assert(value == (int)i * 3);
+	}
+
+	for (size_t i = 0; i < invalid_key_count; ++i)
+	{
+		int value = -1;
+		assert(!IntRobinTable_get(&table, &value, invalid_keys[i]));
+		assert(value == -1);
+		assert(IntRobinTable_get_ptr(&table, invalid_keys[i]) == NULL);
+	}
+
+	IntRobinTable_free(&table);
+}
+
+void test_erase()
+{
+	puts("\tTesting erase()");
+
+	IntRobinTable table;
+	assert(IntRobinTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntRobinTable_set(&table, key, i));
+	}
+
+	for (int i = 0; i < 1000; i += 2)
+	{
+		sprintf(key, "key%d", i);
+		IntRobinTable_erase(&table, key);
+	}
+
+	assert(table.count == 500);
+	assert_invariants(&table);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntRobinTable_contains(&table, key) == (i % 2 == 1));
+	}
+
+	IntRobinTable_erase(&table, "missing");
+	assert(table.count == 500);
+
+	IntRobinTable_free(&table);
+}
+
+void test_churn()
+{
+	puts("\tTesting churn");
+
+	IntRobinTable table;
+	assert(IntRobinTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 100000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntRobinTable_set(&table, key, i));
+
+		if (i >= 12)
+		{
+			sprintf(key, "key%d", i - 12);
+			IntRobinTable_erase(&table, key);
+		}
+	}
+
+	// nothing is left behind by erase, so the table never has to grow
+	assert(table.count == 12);
+	assert(table.capacity == HIRZEL_ROBIN_TABLE_MIN_CAPACITY);
+	assert_invariants(&table);
+
+	for (int i = 100000 - 12; i < 100000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntRobinTable_contains(&table, key));
+	}
+
+	IntRobinTable_free(&table);
+}
+
+void test_clear()
+{
+	puts("\tTesting clear()");
+
+	IntRobinTable table;
+	assert(IntRobinTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntRobinTable_set(&table, valid_keys[i], (int)i));
+
+	IntRobinTable_clear(&table);
+	assert(IntRobinTable_is_empty(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(!IntRobinTable_contains(&table, valid_keys[i]));
+
+	IntRobinTable_free(&table);
+}
+
+void test_swap()
+{
+	puts("\tTesting swap()");
+
+	IntRobinTable table;
+	assert(IntRobinTable_init(&table));
+
+	assert(IntRobinTable_set(&table, "a", 1));
+	assert(IntRobinTable_set(&table, "b", 2));
+
+	assert(IntRobinTable_swap(&table, "a", "b"));
+	assert(*IntRobinTable_get_ptr(&table, "a") == 2);
+	assert(*IntRobinTable_get_ptr(&table, "b") == 1);
+	assert(!IntRobinTable_swap(&table, "a", "c"));
+
+	IntRobinTable_free(&table);
+}
+
+int main(void)
+{
+	puts("Testing Robin Table...");
+	test_init();
+	test_reserve();
+	test_set();
+	test_get();
+	test_erase();
+	test_churn();
+	test_clear();
+	test_swap();
+
+	puts("All tests passed");
+
+	return 0;
+}
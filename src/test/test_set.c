@@ -0,0 +1,251 @@
+#include <hirzel/set.h>
+
+HIRZEL_SET_DECLARE(StringSet)
+HIRZEL_SET_DEFINE(StringSet)
+
+HIRZEL_SET_DECLARE(PowStringSet)
+HIRZEL_SET_DEFINE_POW2(PowStringSet)
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+const char * const keys[] = {
+	"abc", "def", "hij", "klm", "nop", "qrs", "tuv", "wxy", "z"
+};
+
+const size_t key_count = sizeof(keys) / sizeof(*keys);
+
+size_t other_hash(const char *key, size_t length)
+{
+	size_t hash = 5381;
+
+	for (size_t i = 0; i < length; ++i)
+		hash = hash * 33 + (unsigned char)key[i];
+
+	return hash;
+}
+
+void fill_range(StringSet *set, int first, int last)
+{
+	char key[32];
+
+	for (int i = first; i < last; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(StringSet_insert(set, key));
+	}
+}
+
+bool contains_number(const StringSet *set, int i)
+{
+	char key[32];
+	sprintf(key, "key%d", i);
+
+	return StringSet_contains(set, key);
+}
+
+void test_insert()
+{
+	puts("\tTesting insert()");
+
+	StringSet set;
+	assert(StringSet_init(&set));
+
+	for (size_t i = 0; i < key_count; ++i)
+	{
+		assert(StringSet_insert(&set, keys[i]));
+		assert(set.count == i + 1);
+	}
+
+	// inserting a present key leaves the set as is
+	assert(StringSet_insert(&set, keys[0]));
+	assert(set.count == key_count);
+
+	for (size_t i = 0; i < key_count; ++i)
+		assert(StringSet_contains(&set, keys[i]));
+
+	assert(!StringSet_contains(&set, "hello"));
+
+	assert(StringSet_insert_n(&set, "hello world", 5));
+	assert(StringSet_contains(&set, "hello"));
+	assert(!StringSet_contains(&set, "hello world"));
+
+	StringSet_free(&set);
+}
+
+void test_erase()
+{
+	puts("\tTesting erase()");
+
+	StringSet set;
+	assert(StringSet_init(&set));
+
+	fill_range(&set, 0, 1000);
+	assert(set.count == 1000);
+
+	for (int i = 0; i < 1000; i += 2)
+	{
+		char key[32];
+		sprintf(key, "key%d", i);
+		StringSet_erase(&set, key);
+	}
+
+	assert(set.count == 500);
+
+	for (int i = 0; i < 1000; ++i)
+		assert(contains_number(&set, i) == (i % 2 == 1));
+
+	StringSet_free(&set);
+}
+
+void test_union()
+{
+	puts("\tTesting union()");
+
+	StringSet a, b, out;
+	assert(StringSet_init(&a));
+	assert(StringSet_init(&b));
+	assert(StringSet_init(&out));
+
+	fill_range(&a, 0, 100);
+	fill_range(&b, 50, 300);
+
+	// stale contents of the output are discarded
+	assert(StringSet_insert(&out, "stale"));
+
+	assert(StringSet_union(&out, &a, &b));
+	assert(out.count == 300);
+	assert(!StringSet_contains(&out, "stale"));
+
+	for (int i = 0; i < 300; ++i)
+		assert(contains_number(&out, i));
+
+	assert(!contains_number(&out, 300));
+
+	StringSet_free(&a);
+	StringSet_free(&b);
+	StringSet_free(&out);
+}
+
+void test_intersection()
+{
+	puts("\tTesting intersection()");
+
+	StringSet a, b, out;
+	assert(StringSet_init(&a));
+	assert(StringSet_init(&b));
+	assert(StringSet_init(&out));
+
+	fill_range(&a, 0, 1000);
+	fill_range(&b, 900, 1100);
+
+	assert(StringSet_intersection(&out, &a, &b));
+	assert(out.count == 100);
+
+	// only the smaller side is sized for
+	assert(out.size_index <= b.size_index);
+
+	for (int i = 0; i < 1100; ++i)
+		assert(contains_number(&out, i) == (i >= 900 && i < 1000));
+
+	assert(StringSet_intersection(&out, &b, &a));
+	assert(out.count == 100);
+
+	StringSet_free(&a);
+	StringSet_free(&b);
+	StringSet_free(&out);
+}
+
+void test_difference()
+{
+	puts("\tTesting difference()");
+
+	StringSet a, b, out;
+	assert(StringSet_init(&a));
+	assert(StringSet_init(&b));
+	assert(StringSet_init(&out));
+
+	fill_range(&a, 0, 200);
+	fill_range(&b, 100, 150);
+
+	assert(StringSet_difference(&out, &a, &b));
+	assert(out.count == 150);
+
+	for (int i = 0; i < 200; ++i)
+		assert(contains_number(&out, i) == (i < 100 || i >= 150));
+
+	assert(StringSet_difference(&out, &b, &a));
+	assert(out.count == 0);
+
+	StringSet_free(&a);
+	StringSet_free(&b);
+	StringSet_free(&out);
+}
+
+void test_mixed_hashes()
+{
+	puts("\tTesting sets with different hash functions");
+
+	StringSet a, b, out;
+	assert(StringSet_init(&a));
+	assert(StringSet_init(&b));
+	assert(StringSet_init(&out));
+
+	b.hash_function = other_hash;
+
+	fill_range(&a, 0, 100);
+	fill_range(&b, 50, 150);
+
+	assert(StringSet_intersection(&out, &a, &b));
+	assert(out.count == 50);
+
+	for (int i = 50; i < 100; ++i)
+		assert(contains_number(&out, i));
+
+	assert(StringSet_union(&out, &a, &b));
+	assert(out.count == 150);
+
+	for (int i = 0; i < 150; ++i)
+		assert(contains_number(&out, i));
+
+	StringSet_free(&a);
+	StringSet_free(&b);
+	StringSet_free(&out);
+}
+
+void test_pow2()
+{
+	puts("\tTesting pow2 sizing");
+
+	PowStringSet set;
+	assert(PowStringSet_init(&set));
+
+	for (size_t i = 0; i < key_count; ++i)
+		assert(PowStringSet_insert(&set, keys[i]));
+
+	assert(set.count == key_count);
+	assert((PowStringSet_size(&set) & (PowStringSet_size(&set) - 1)) == 0);
+
+	for (size_t i = 0; i < key_count; ++i)
+		assert(PowStringSet_contains(&set, keys[i]));
+
+	PowStringSet_free(&set);
+}
+
+int main(void)
+{
+	puts("Testing Set...");
+	test_insert();
+	test_erase();
+	test_union();
+	test_intersection();
+	test_difference();
+	test_mixed_hashes();
+	test_pow2();
+
+	puts("All tests passed");
+
+	return 0;
+}
@@ -0,0 +1,166 @@
+#include <hirzel/small_array.h>
+
+HIRZEL_SMALL_ARRAY_DECLARE(int, 4, IntSmallArray)
+HIRZEL_SMALL_ARRAY_DEFINE(int, 4, IntSmallArray)
+
+// standard library
+#include <stdio.h>
+#include <assert.h>
+
+size_t alloc_count = 0;
+
+void *count_alloc(void *context, size_t size)
+{
+	(void)context;
+	alloc_count += 1;
+
+	return malloc(size);
+}
+
+void *count_realloc(void *context, void *data, size_t old_size, size_t new_size)
+{
+	(void)context;
+	(void)old_size;
+	alloc_count += 1;
+
+	return realloc(data, new_size);
+}
+
+void count_free(void *context, void *data, size_t size)
+{
+	(void)context;
+	(void)size;
+
+	free(data);
+}
+
+const HirzelAllocator counting_allocator = { NULL, count_alloc, count_realloc, count_free };
+
+void assert_items(IntSmallArray *array, const int *expected, size_t length)
+{
+	assert(array->length == length);
+
+	for (size_t i = 0; i < length; ++i)
+		assert(IntSmallArray_get(array, i) == expected[i]);
+}
+
+void test_inline()
+{
+	puts("\tTesting inline items");
+
+	IntSmallArray array = IntSmallArray_init_allocator(&counting_allocator);
+
+	alloc_count = 0;
+	assert(IntSmallArray_is_inline(&array));
+	assert(array.capacity == 4);
+
+	for (int i = 0; i < 4; ++i)
+		assert(*IntSmallArray_push(&array, i) == i);
+
+	assert(IntSmallArray_is_inline(&array));
+	assert(alloc_count == 0);
+	assert(IntSmallArray_data(&array) == array.storage.items);
+
+	// copies carry their items with them
+	IntSmallArray copy = array;
+	const int expected[] = { 0, 1, 2, 3 };
+
+	IntSmallArray_set(&array, 0, 10);
+	assert_items(&copy, expected, 4);
+
+	IntSmallArray_free(&array);
+}
+
+void test_spill()
+{
+	puts("\tTesting spilling to the heap");
+
+	IntSmallArray array = IntSmallArray_init_allocator(&counting_allocator);
+
+	alloc_count = 0;
+
+	for (int i = 0; i < 5; ++i)
+		IntSmallArray_push(&array, i);
+
+	assert(!IntSmallArray_is_inline(&array));
+	assert(array.capacity == 8);
+	assert(alloc_count == 1);
+
+	const int expected[] = { 0, 1, 2, 3, 4 };
+	assert_items(&array, expected, 5);
+
+	for (int i = 5; i < 100; ++i)
+		IntSmallArray_push(&array, i);
+
+	for (int i = 0; i < 100; ++i)
+		assert(IntSmallArray_get(&array, (size_t)i) == i);
+
+	// shrinking to N or less moves the items back inline
+	assert(IntSmallArray_reserve(&array, 3));
+	assert(IntSmallArray_is_inline(&array));
+	assert(array.capacity == 4);
+	assert_items(&array, expected, 3);
+
+	assert(IntSmallArray_reserve(&array, 20));
+	assert(array.capacity == 20);
+	assert_items(&array, expected, 3);
+
+	assert(IntSmallArray_resize(&array, 30));
+	assert(array.length == 30);
+
+	IntSmallArray_free(&array);
+	assert(IntSmallArray_is_inline(&array));
+	assert(array.length == 0);
+}
+
+void test_insert_erase()
+{
+	puts("\tTesting insert() and erase()");
+
+	IntSmallArray array = IntSmallArray_init();
+
+	IntSmallArray_push(&array, 1);
+	IntSmallArray_push(&array, 3);
+	IntSmallArray_insert(&array, 1, 2);
+	IntSmallArray_insert(&array, 0, 0);
+	IntSmallArray_insert(&array, 4, 4);
+
+	const int inserted[] = { 0, 1, 2, 3, 4 };
+	assert_items(&array, inserted, 5);
+
+	IntSmallArray_pushf(&array, -1);
+	assert(IntSmallArray_front(&array) == -1);
+	assert(IntSmallArray_back(&array) == 4);
+
+	IntSmallArray_popf(&array);
+	IntSmallArray_erase(&array, 2);
+	IntSmallArray_pop(&array);
+
+	const int erased[] = { 0, 1, 3 };
+	assert_items(&array, erased, 3);
+
+	IntSmallArray_swap(&array, 0, 2);
+	assert(IntSmallArray_front(&array) == 3);
+	assert(IntSmallArray_back(&array) == 0);
+
+	IntSmallArray_clear(&array);
+	assert(IntSmallArray_is_empty(&array));
+	IntSmallArray_popf(&array);
+	IntSmallArray_pop(&array);
+	assert(array.length == 0);
+
+	IntSmallArray_free(&array);
+}
+
+int main(void)
+{
+	puts("Testing IntSmallArray...");
+
+	test_inline();
+	test_spill();
+	test_insert_erase();
+
+	puts("All tests passed");
+
+	return 0;
+}
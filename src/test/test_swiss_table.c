@@ -0,0 +1,473 @@
+#include <hirzel/swiss_table.h>
+
+HIRZEL_SWISS_TABLE_DECLARE(int, IntSwissTable)
+HIRZEL_SWISS_TABLE_DEFINE(int, IntSwissTable)
+
+// standard library
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+const char * const valid_keys[] = {
+	"abc", "def", "hij", "klm", "nop", "qrs", "tuv", "wxy", "z"
+};
+
+const size_t valid_key_count = sizeof(valid_keys) / sizeof(*valid_keys);
+
+const char * const invalid_keys[] = {
+	"hello",
+	"my",
+	"name",
+	"is",
+	"Ike"
+};
+
+const size_t invalid_key_count = sizeof(invalid_keys) / sizeof(*invalid_keys);
+
+size_t count_control(const IntSwissTable *table, int8_t control)
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < table->capacity; ++i)
+	{
+		if (table->control[i] == control)
+			count += 1;
+	}
+
+	return count;
+}
+
+void test_init()
+{
+	puts("\tTesting init()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	assert(table.control != NULL);
+	assert(table.slots != NULL);
+	assert(table.count == 0);
+	assert(table.capacity == HIRZEL_SWISS_GROUP_WIDTH);
+	assert(count_control(&table, HIRZEL_SWISS_EMPTY) == table.capacity);
+
+	IntSwissTable_free(&table);
+}
+
+void test_group_match()
+{
+	puts("\tTesting group match");
+
+	int8_t group[HIRZEL_SWISS_GROUP_WIDTH];
+
+	memset(group, HIRZEL_SWISS_EMPTY, sizeof(group));
+	group[0] = 5;
+	group[3] = HIRZEL_SWISS_DELETED;
+	group[9] = 5;
+	group[15] = 127;
+
+	HirzelSwissMask match = hirzel_swiss_match(group, 5);
+	assert(hirzel_swiss_lowest(match) == 0);
+	match &= match - 1;
+	assert(hirzel_swiss_lowest(match) == 9);
+	match &= match - 1;
+	assert(match == 0);
+
+	match = hirzel_swiss_match(group, 127);
+	assert(hirzel_swiss_lowest(match) == 15);
+
+	assert(!hirzel_swiss_match(group, 6));
+
+	match = hirzel_swiss_match_empty(group);
+	assert(hirzel_swiss_lowest(match) == 1);
+
+	match = hirzel_swiss_match_empty_or_deleted(group);
+	size_t free_count = 0;
+
+	while (match)
+	{
+		size_t index = hirzel_swiss_lowest(match);
+		assert(group[index] < 0);
+		free_count += 1;
+		match &= match - 1;
+	}
+
+	assert(free_count == HIRZEL_SWISS_GROUP_WIDTH - 3);
+}
+
+void test_reserve()
+{
+	puts("\tTesting reserve()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	assert(IntSwissTable_reserve(&table, 10));
+	assert(table.capacity == 16);
+
+	assert(IntSwissTable_reserve(&table, 500));
+	assert(table.capacity == 1024);
+	assert(table.growth_left >= 500);
+	assert(count_control(&table, HIRZEL_SWISS_EMPTY) == table.capacity);
+
+	IntSwissTable_free(&table);
+}
+
+void test_shrink()
+{
+	puts("\tTesting shrink()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	assert(IntSwissTable_reserve(&table, 500));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntSwissTable_set(&table, valid_keys[i], i));
+
+	assert(IntSwissTable_shrink(&table));
+	assert(table.capacity == 16);
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntSwissTable_contains(&table, valid_keys[i]));
+
+	IntSwissTable_free(&table);
+}
+
+void test_set()
+{
+	puts("\tTesting set()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		const char *key = valid_keys[i];
+		assert(IntSwissTable_set(&table, key, i * 3));
+		assert(table.count == i + 1);
+	}
+
+	for (size_t key_index = 0; key_index < valid_key_count; ++key_index)
+	{
+		bool found = false;
+		const char *search_key = valid_keys[key_index];
+
+		for (size_t i = 0; i < table.capacity; ++i)
+		{
+			IntSwissTableSlot *slot = table.slots + i;
+
+			if (table.control[i] >= 0 && !strcmp(slot->key, search_key))
+			{
+				found = true;
+				int expected = key_index * 3;
+				assert(slot->value == expected);
+			}
+		}
+
+		assert(found == true);
+	}
+
+	assert(IntSwissTable_set(&table, valid_keys[0], 100));
+	assert(table.count == valid_key_count);
+	assert(*IntSwissTable_get_ptr(&table, valid_keys[0]) == 100);
+
+	IntSwissTable_free(&table);
+}
+
+void test_grow()
+{
+	puts("\tTesting growth");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntSwissTable_set(&table, key, i));
+	}
+
+	assert(table.count == 10000);
+	assert(table.capacity == 16384);
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		int value;
+		sprintf(key, "key%d", i);
+		assert(IntSwissTable_get(&table, &value, key));
+		assert(value == i);
+	}
+
+	for (int i = 10000; i < 11000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(!IntSwissTable_contains(&table, key));
+	}
+
+	IntSwissTable_free(&table);
+}
+
+void test_erase()
+{
+	puts("\tTesting erase()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntSwissTable_set(&table, valid_keys[i], i * 8));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		IntSwissTable_erase(&table, valid_keys[i]);
+		assert(!IntSwissTable_contains(&table, valid_keys[i]));
+	}
+
+	assert(table.count == 0);
+
+	// the only group still has empty slots, so nothing is left as a tombstone
+	assert(count_control(&table, HIRZEL_SWISS_DELETED) == 0);
+	assert(table.growth_left == table.capacity - table.capacity / 8);
+
+	IntSwissTable_free(&table);
+}
+
+void test_churn()
+{
+	puts("\tTesting churn");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 100000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntSwissTable_set(&table, key, i));
+
+		if (i >= 50)
+		{
+			sprintf(key, "key%d", i - 50);
+			IntSwissTable_erase(&table, key);
+		}
+	}
+
+	assert(table.count == 50);
+	assert(table.capacity <= 128);
+
+	for (int i = 100000 - 50; i < 100000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntSwissTable_contains(&table, key));
+	}
+
+	IntSwissTable_free(&table);
+}
+
+void test_clear()
+{
+	puts("\tTesting clear()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntSwissTable_set(&table, valid_keys[i], i));
+
+	IntSwissTable_clear(&table);
+
+	assert(table.count == 0);
+	assert(count_control(&table, HIRZEL_SWISS_EMPTY) == table.capacity);
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(!IntSwissTable_contains(&table, valid_keys[i]));
+
+	IntSwissTable_free(&table);
+}
+
+void test_swap()
+{
+	puts("\tTesting swap()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntSwissTable_set(&table, valid_keys[i], i));
+
+	assert(IntSwissTable_swap(&table, valid_keys[0], valid_keys[1]));
+	assert(IntSwissTable_swap(&table, valid_keys[1], valid_keys[2]));
+	assert(!IntSwissTable_swap(&table, valid_keys[0], invalid_keys[0]));
+
+	int expected[] = { 1, 2, 0 };
+	size_t expected_count = sizeof(expected) / sizeof(*expected);
+
+	for (size_t e = 0; e < expected_count; ++e)
+		assert(*IntSwissTable_get_ptr(&table, valid_keys[e]) == expected[e]);
+
+	IntSwissTable_free(&table);
+}
+
+void test_get()
+{
+	puts("\tTesting get()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		const char *key = valid_keys[i];
+		int value = 8 * i;
+
+		assert(IntSwissTable_set(&table, key, value));
+		int retrieved;
+		assert(IntSwissTable_get(&table, &retrieved, key));
+		assert(value == retrieved);
+	}
+
+	for (size_t i = 0; i < invalid_key_count; ++i)
+	{
+		int retrieved;
+		assert(!IntSwissTable_get(&table, &retrieved, invalid_keys[i]));
+	}
+
+	IntSwissTable_free(&table);
+}
+
+void test_get_ptr()
+{
+	puts("\tTesting get_ptr()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntSwissTable_set(&table, valid_keys[i], i));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		int *ptr = IntSwissTable_get_ptr(&table, valid_keys[i]);
+		assert(ptr);
+		assert(*ptr == (int)i);
+	}
+
+	for (size_t i = 0; i < invalid_key_count; ++i)
+		assert(IntSwissTable_get_ptr(&table, invalid_keys[i]) == NULL);
+
+	IntSwissTable_free(&table);
+}
+
+void test_contains()
+{
+	puts("\tTesting contains()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(!IntSwissTable_contains(&table, valid_keys[i]));
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		assert(IntSwissTable_set(&table, valid_keys[i], i));
+		assert(IntSwissTable_contains(&table, valid_keys[i]));
+	}
+
+	for (size_t i = 0; i < invalid_key_count; ++i)
+		assert(!IntSwissTable_contains(&table, invalid_keys[i]));
+
+	IntSwissTable_free(&table);
+}
+
+void test_is_empty()
+{
+	puts("\tTesting is_empty()");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+
+	assert(IntSwissTable_is_empty(&table));
+	assert(IntSwissTable_set(&table, valid_keys[0], 0));
+	assert(!IntSwissTable_is_empty(&table));
+	IntSwissTable_erase(&table, valid_keys[0]);
+	assert(IntSwissTable_is_empty(&table));
+
+	IntSwissTable_free(&table);
+}
+
+size_t hashed_length = 0;
+size_t hash_call_count = 0;
+
+// a custom hash takes the key's length like every other table's
+size_t length_hash(const char *key, size_t length)
+{
+	hashed_length += length;
+	hash_call_count += 1;
+
+	return IntSwissTable_hash_bytes(key, length);
+}
+
+void test_hash_function()
+{
+	puts("\tTesting hash_function");
+
+	IntSwissTable table;
+	assert(IntSwissTable_init(&table));
+	assert(table.hash_function == IntSwissTable_hash_bytes);
+	assert(IntSwissTable_hash_bytes("abc", 3) == IntSwissTable_hash_string("abc"));
+
+	table.hash_function = length_hash;
+	assert(IntSwissTable_set(&table, "abc", 1));
+	assert(hashed_length == 3);
+	assert(IntSwissTable_contains(&table, "abc"));
+	assert(!IntSwissTable_contains(&table, "abcd"));
+
+	// a new key is hashed once, and growing reuses the stored hashes
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		hash_call_count = 0;
+		assert(IntSwissTable_set(&table, valid_keys[i], (int)i));
+		assert(hash_call_count == 1);
+	}
+
+	hash_call_count = 0;
+	assert(IntSwissTable_reserve(&table, 1000));
+	assert(hash_call_count == 0);
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		int value;
+		assert(IntSwissTable_get(&table, &value, valid_keys[i]));
+		assert(value == (int)i);
+	}
+
+	IntSwissTable_free(&table);
+}
+
+int main(void)
+{
+	puts("Testing SwissTable...");
+	test_init();
+	test_group_match();
+	test_reserve();
+	test_shrink();
+	test_set();
+	test_grow();
+	test_erase();
+	test_churn();
+	test_clear();
+	test_swap();
+	test_get();
+	test_get_ptr();
+	test_contains();
+	test_is_empty();
+	test_hash_function();
+
+	puts("All tests passed");
+
+	return 0;
+}
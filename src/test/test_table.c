@@ -3,6 +3,9 @@
 HIRZEL_TABLE_DECLARE(int, IntTable)
 HIRZEL_TABLE_DEFINE(int, IntTable)
 
+HIRZEL_TABLE_DECLARE(int, PowIntTable)
+HIRZEL_TABLE_DEFINE_POW2(int, PowIntTable)
+
 // standard library
 #include <assert.h>
 #include <string.h>
@@ -168,7 +171,13 @@ void test_erase()
 		assert(IntTable_set(&table, valid_keys[i], i * 8));
 
 	for (size_t i = 0; i < valid_key_count; ++i)
+	{
 		IntTable_erase(&table, valid_keys[i]);
+		assert(!IntTable_contains(&table, valid_keys[i]));
+	}
+
+	for (size_t i = 0; i < invalid_key_count; ++i)
+		assert(!IntTable_contains(&table, invalid_keys[i]));
 
 	size_t size = IntTable_sizes[table.size_index];
 	unsigned deleted_count = 0;
@@ -182,6 +191,43 @@ void test_erase()
 	}
 
 	assert(deleted_count == valid_key_count);
+	assert(table.deleted_count == valid_key_count);
+
+	IntTable_free(&table);
+}
+
+void test_churn()
+{
+	puts("\tTesting churn");
+
+	IntTable table;
+	assert(IntTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 100000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntTable_set(&table, key, i));
+
+		if (i >= 20)
+		{
+			sprintf(key, "key%d", i - 20);
+			IntTable_erase(&table, key);
+		}
+
+		assert(table.count + table.deleted_count < IntTable_size(&table));
+	}
+
+	// tombstones are cleaned up in place rather than growing the table
+	assert(table.count == 20);
+	assert(IntTable_size(&table) <= 97);
+
+	for (int i = 100000 - 20; i < 100000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntTable_contains(&table, key));
+	}
 
 	IntTable_free(&table);
 }
@@ -294,6 +340,9 @@ void test_get_ptr()
 		assert(*ptr == (int)i);
 	}
 
+	for (size_t i = 0; i < invalid_key_count; ++i)
+		assert(IntTable_get_ptr(&table, invalid_keys[i]) == NULL);
+
 	IntTable_free(&table);
 }
 
@@ -359,6 +408,451 @@ void test_is_empty()
 	IntTable_free(&table);
 }
 
+size_t hash_call_count = 0;
+
+size_t counting_hash(const char *key, size_t length)
+{
+	hash_call_count += 1;
+
+	return IntTable_hash_bytes(key, length);
+}
+
+void test_cached_hash()
+{
+	puts("\tTesting cached hash");
+
+	IntTable table;
+	assert(IntTable_init(&table));
+	table.hash_function = counting_hash;
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+		assert(IntTable_set(&table, valid_keys[i], i));
+
+	for (size_t i = 0; i < IntTable_size(&table); ++i)
+	{
+		IntTableNode *node = table.data + i;
+
+		if (node->key)
+			assert(node->hash == IntTable_hash_string(node->key));
+	}
+
+	// moving nodes to a new array reuses their stored hash
+	hash_call_count = 0;
+	assert(IntTable_reserve(&table, 1000));
+	assert(hash_call_count == 0);
+
+	for (size_t i = 0; i < valid_key_count; ++i)
+	{
+		int value;
+		assert(IntTable_get(&table, &value, valid_keys[i]));
+		assert(value == (int)i);
+	}
+
+	assert(hash_call_count == valid_key_count);
+
+	IntTable_free(&table);
+}
+
+size_t count_blocks(const HirzelKeyArena *arena)
+{
+	size_t count = 0;
+
+	for (const HirzelKeyBlock *block = arena->blocks; block; block = block->next)
+		count += 1;
+
+	return count;
+}
+
+bool is_in_arena(const HirzelKeyArena *arena, const char *key)
+{
+	for (const HirzelKeyBlock *block = arena->blocks; block; block = block->next)
+	{
+		if (key >= block->data && key < block->data + block->used)
+			return true;
+	}
+
+	return false;
+}
+
+void test_arena()
+{
+	puts("\tTesting arena");
+
+	IntTable table;
+	assert(IntTable_init_arena(&table));
+	assert(table.key_arena.is_enabled);
+
+	char key[32];
+	size_t key_size = 0;
+
+	for (int i = 0; i < 5000; ++i)
+	{
+		key_size += sprintf(key, "key%d", i) + 1;
+		assert(IntTable_set(&table, key, i));
+	}
+
+	assert(table.key_arena.live_size == key_size);
+	assert(count_blocks(&table.key_arena) < 8);
+
+	for (size_t i = 0; i < IntTable_size(&table); ++i)
+	{
+		if (table.data[i].key)
+			assert(is_in_arena(&table.key_arena, table.data[i].key));
+	}
+
+	for (int i = 0; i < 5000; i += 2)
+	{
+		key_size -= sprintf(key, "key%d", i) + 1;
+		IntTable_erase(&table, key);
+	}
+
+	assert(table.key_arena.live_size == key_size);
+
+	assert(IntTable_compact(&table));
+	assert(count_blocks(&table.key_arena) == 1);
+	assert(table.key_arena.blocks->used == key_size);
+	assert(table.key_arena.live_size == key_size);
+
+	for (int i = 0; i < 5000; ++i)
+	{
+		int value;
+		sprintf(key, "key%d", i);
+
+		if (i % 2)
+		{
+			assert(IntTable_get(&table, &value, key));
+			assert(value == i);
+		}
+		else
+		{
+			assert(!IntTable_contains(&table, key));
+		}
+	}
+
+	assert(IntTable_shrink(&table));
+	assert(count_blocks(&table.key_arena) == 1);
+
+	IntTable_clear(&table);
+	assert(table.count == 0);
+	assert(table.key_arena.live_size == 0);
+	assert(count_blocks(&table.key_arena) == 1);
+	assert(table.key_arena.blocks->used == 0);
+
+	assert(IntTable_set(&table, "abc", 1));
+	assert(table.key_arena.blocks->used == 4);
+	assert(*IntTable_get_ptr(&table, "abc") == 1);
+
+	IntTable_free(&table);
+}
+
+void test_length_keys()
+{
+	puts("\tTesting _n functions");
+
+	IntTable table;
+	assert(IntTable_init(&table));
+
+	// keys are slices of a larger buffer, as when parsed out of a packet
+	const char buffer[] = "GET /index.html /about.html";
+
+	assert(IntTable_set_n(&table, buffer, 3, 1));
+	assert(IntTable_set_n(&table, buffer + 4, 11, 2));
+	assert(IntTable_set_n(&table, buffer + 16, 11, 3));
+	assert(table.count == 3);
+
+	int value;
+	assert(IntTable_get(&table, &value, "GET"));
+	assert(value == 1);
+	assert(IntTable_get_n(&table, &value, "/index.html?q", 11));
+	assert(value == 2);
+	assert(*IntTable_get_ptr_n(&table, buffer + 16, 11) == 3);
+	assert(*IntTable_get_ptr(&table, "/about.html") == 3);
+
+	assert(IntTable_contains_n(&table, buffer, 3));
+	assert(!IntTable_contains_n(&table, buffer, 2));
+	assert(!IntTable_contains_n(&table, buffer, 4));
+	assert(IntTable_get_ptr_n(&table, buffer, 5) == NULL);
+
+	// the stored copy is terminated even though the slice was not
+	for (size_t i = 0; i < IntTable_size(&table); ++i)
+	{
+		IntTableNode *node = table.data + i;
+
+		if (node->key)
+			assert(strlen(node->key) == node->key_length);
+	}
+
+	// lengths allow keys with embedded terminators
+	assert(IntTable_set_n(&table, "ab\0c", 4, 4));
+	assert(IntTable_set_n(&table, "ab\0d", 4, 5));
+	assert(!IntTable_contains(&table, "ab"));
+	assert(*IntTable_get_ptr_n(&table, "ab\0c", 4) == 4);
+	assert(*IntTable_get_ptr_n(&table, "ab\0d", 4) == 5);
+
+	IntTable_erase_n(&table, "ab\0c", 4);
+	assert(!IntTable_contains_n(&table, "ab\0c", 4));
+	assert(IntTable_contains_n(&table, "ab\0d", 4));
+
+	IntTable_erase_n(&table, buffer + 4, 11);
+	assert(!IntTable_contains(&table, "/index.html"));
+	assert(table.count == 3);
+
+	IntTable_free(&table);
+}
+
+void test_pow2()
+{
+	puts("\tTesting pow2 sizing");
+
+	for (size_t i = 0; i < PowIntTable_size_count; ++i)
+	{
+		size_t size = PowIntTable_sizes[i];
+		assert((size & (size - 1)) == 0);
+	}
+
+	PowIntTable table;
+	assert(PowIntTable_init(&table));
+	assert(PowIntTable_size(&table) == 16);
+
+	char key[32];
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(PowIntTable_set(&table, key, i));
+	}
+
+	assert(table.count == 10000);
+	assert(PowIntTable_size(&table) == 32768);
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		int value;
+		sprintf(key, "key%d", i);
+		assert(PowIntTable_get(&table, &value, key));
+		assert(value == i);
+	}
+
+	for (int i = 0; i < 10000; i += 2)
+	{
+		sprintf(key, "key%d", i);
+		PowIntTable_erase(&table, key);
+	}
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(PowIntTable_contains(&table, key) == (i % 2 == 1));
+	}
+
+	assert(PowIntTable_shrink(&table));
+	assert(PowIntTable_size(&table) == 16384);
+
+	for (int i = 1; i < 10000; i += 2)
+	{
+		sprintf(key, "key%d", i);
+		assert(PowIntTable_contains(&table, key));
+	}
+
+	PowIntTable_free(&table);
+}
+
+size_t count_nodes(const IntTable *table)
+{
+	size_t count = 0;
+	size_t i = 0;
+
+	while (IntTable_next_node(table, &i))
+		count += 1;
+
+	return count;
+}
+
+void test_incremental()
+{
+	puts("\tTesting incremental resize");
+
+	IntTable table;
+	assert(IntTable_init(&table));
+	IntTable_set_incremental(&table, true);
+
+	char key[32];
+	size_t migration_count = 0;
+
+	for (int i = 0; i < 20000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntTable_set(&table, key, i));
+
+		if (i % 3 == 2)
+		{
+			sprintf(key, "key%d", i - 1);
+			IntTable_erase(&table, key);
+		}
+
+		if (table.old_data)
+		{
+			migration_count += 1;
+
+			// keys not migrated yet are still found in the old array
+			assert(count_nodes(&table) == table.count);
+		}
+	}
+
+	assert(migration_count > 0);
+
+	for (int i = 0; i < 20000; ++i)
+	{
+		bool is_erased = i % 3 == 1 && i + 1 < 20000;
+		sprintf(key, "key%d", i);
+		assert(IntTable_contains(&table, key) == !is_erased);
+	}
+
+	// a resize underway is finished by explicit resizes, clear and free
+	while (!table.old_data)
+	{
+		sprintf(key, "more%zu", table.count);
+		assert(IntTable_set(&table, key, 0));
+	}
+
+	size_t count = table.count;
+	assert(IntTable_reserve(&table, count * 4));
+	assert(table.old_data == NULL);
+	assert(count_nodes(&table) == count);
+
+	while (!table.old_data)
+	{
+		sprintf(key, "more%zu", table.count);
+		assert(IntTable_set(&table, key, 0));
+	}
+
+	// erasing a key still in the old array, past the slots the erase itself
+	// migrates, leaves no tombstone in the new one
+	size_t deleted_count = table.deleted_count;
+	size_t old_size = IntTable_sizes[table.old_size_index];
+	size_t i = table.migrate_index + HIRZEL_TABLE_MIGRATE_STEP;
+
+	while (i < old_size && !table.old_data[i].key)
+		i += 1;
+
+	assert(i < old_size);
+	count = table.count;
+	IntTable_erase(&table, table.old_data[i].key);
+	assert(table.count == count - 1);
+	assert(table.deleted_count == deleted_count);
+
+	IntTable_clear(&table);
+	assert(table.old_data == NULL);
+	assert(count_nodes(&table) == 0);
+
+	while (!table.old_data)
+	{
+		sprintf(key, "more%zu", table.count);
+		assert(IntTable_set(&table, key, 0));
+	}
+
+	// turning incremental resizing off finishes the resize underway
+	IntTable_set_incremental(&table, false);
+	assert(table.old_data == NULL);
+	assert(count_nodes(&table) == table.count);
+
+	IntTable_free(&table);
+}
+
+void test_iter()
+{
+	puts("\tTesting iter_begin() and iter_next()");
+
+	IntTable table;
+	assert(IntTable_init(&table));
+
+	IntTableIter iter = IntTable_iter_begin(&table);
+	assert(IntTable_iter_next(&table, &iter) == NULL);
+
+	char key[32];
+	bool is_seen[1000] = { false };
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntTable_set(&table, key, i));
+	}
+
+	for (int i = 0; i < 1000; i += 3)
+	{
+		sprintf(key, "key%d", i);
+		IntTable_erase(&table, key);
+	}
+
+	size_t count = 0;
+	IntTableNode *node;
+	iter = IntTable_iter_begin(&table);
+
+	while ((node = IntTable_iter_next(&table, &iter)))
+	{
+		assert(node->value % 3 != 0);
+		assert(!is_seen[node->value]);
+		is_seen[node->value] = true;
+		node->value = -node->value;
+		count += 1;
+	}
+
+	assert(count == table.count);
+	assert(*IntTable_get_ptr(&table, "key1") == -1);
+
+	IntTable_free(&table);
+}
+
+void test_batch()
+{
+	puts("\tTesting get_batch() and set_batch()");
+
+	IntTable table;
+	assert(IntTable_init(&table));
+
+	char buffers[1000][32];
+	const char *keys[1000];
+	int values[1000];
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		sprintf(buffers[i], "key%d", i);
+		keys[i] = buffers[i];
+		values[i] = i * 2;
+	}
+
+	// the first half is set on its own and then overwritten by the batch
+	for (int i = 0; i < 500; ++i)
+		assert(IntTable_set(&table, keys[i], -1));
+
+	assert(IntTable_set_batch(&table, keys, values, 1000));
+	assert(table.count == 1000);
+
+	for (int i = 0; i < 1000; ++i)
+		assert(*IntTable_get_ptr(&table, keys[i]) == i * 2);
+
+	for (int i = 0; i < 1000; i += 2)
+		IntTable_erase(&table, keys[i]);
+
+	int out[1000];
+	bool is_found[1000];
+
+	assert(IntTable_get_batch(&table, out, is_found, keys, 1000) == 500);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		assert(is_found[i] == (i % 2 == 1));
+
+		if (is_found[i])
+			assert(out[i] == i * 2);
+	}
+
+	assert(IntTable_get_batch(&table, out, is_found, keys, 0) == 0);
+	assert(IntTable_set_batch(&table, keys, values, 0));
+
+	IntTable_free(&table);
+}
+
 int main(void)
 {
 	puts("Testing Table...");
@@ -368,6 +862,7 @@ int main(void)
 	test_shrink();
 	test_set();
 	test_erase();
+	test_churn();
 	test_clear();
 	test_swap();
 	test_get();
@@ -375,6 +870,13 @@ int main(void)
 	test_contains();
 	test_size();
 	test_is_empty();
+	test_cached_hash();
+	test_arena();
+	test_length_keys();
+	test_pow2();
+	test_incremental();
+	test_iter();
+	test_batch();
 
 	puts("All tests passed");
 
@@ -0,0 +1,222 @@
+#include <hirzel/table_snapshot.h>
+
+HIRZEL_TABLE_DECLARE(int, IntTable)
+HIRZEL_TABLE_DEFINE(int, IntTable)
+HIRZEL_TABLE_SNAPSHOT_DECLARE(int, IntTable)
+HIRZEL_TABLE_SNAPSHOT_DEFINE(int, IntTable)
+
+typedef struct Point
+{
+	double x;
+	double y;
+	char label[12];
+} Point;
+
+HIRZEL_TABLE_DECLARE(Point, PointTable)
+HIRZEL_TABLE_DEFINE_POW2(Point, PointTable)
+HIRZEL_TABLE_SNAPSHOT_DECLARE(Point, PointTable)
+HIRZEL_TABLE_SNAPSHOT_DEFINE(Point, PointTable)
+
+// standard library
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SNAPSHOT_PATH "test_table_snapshot.bin"
+
+size_t other_hash(const char *key, size_t length)
+{
+	return IntTable_hash_bytes(key, length) ^ 1;
+}
+
+void write_file(const char *path, const void *data, size_t size)
+{
+	FILE *file = fopen(path, "wb");
+	assert(file != NULL);
+	assert(fwrite(data, 1, size, file) == size);
+	fclose(file);
+}
+
+void test_write_open()
+{
+	puts("\tTesting snapshot_write() and open()");
+
+	IntTable table;
+	assert(IntTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(key, "key%d", i);
+		assert(IntTable_set(&table, key, i));
+	}
+
+	for (int i = 0; i < 10000; i += 4)
+	{
+		sprintf(key, "key%d", i);
+		IntTable_erase(&table, key);
+	}
+
+	assert(IntTable_snapshot_write(&table, SNAPSHOT_PATH));
+	IntTable_free(&table);
+
+	IntTableSnapshot snapshot;
+	assert(IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, NULL));
+	assert(snapshot.count == 7500);
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(key, "key%d", i);
+
+		int value = -1;
+		bool is_found = IntTableSnapshot_get(&snapshot, &value, key);
+
+		assert(is_found == (i % 4 != 0));
+		assert(value == (is_found ? i : -1));
+		assert(IntTableSnapshot_contains(&snapshot, key) == is_found);
+	}
+
+	assert(*IntTableSnapshot_get_ptr_n(&snapshot, "key1234567", 4) == 1);
+	assert(!IntTableSnapshot_contains(&snapshot, "missing"));
+	assert(!IntTableSnapshot_contains(&snapshot, ""));
+
+	IntTableSnapshot_close(&snapshot);
+	assert(snapshot.slots == NULL);
+
+	remove(SNAPSHOT_PATH);
+}
+
+void test_empty()
+{
+	puts("\tTesting empty snapshots");
+
+	IntTable table;
+	assert(IntTable_init(&table));
+	assert(IntTable_snapshot_write(&table, SNAPSHOT_PATH));
+	IntTable_free(&table);
+
+	IntTableSnapshot snapshot;
+	assert(IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, NULL));
+	assert(snapshot.count == 0);
+	assert(!IntTableSnapshot_contains(&snapshot, "key0"));
+	IntTableSnapshot_close(&snapshot);
+
+	remove(SNAPSHOT_PATH);
+}
+
+void test_struct_values()
+{
+	puts("\tTesting struct values");
+
+	PointTable table;
+	assert(PointTable_init(&table));
+
+	char key[32];
+
+	for (int i = 0; i < 500; ++i)
+	{
+		Point point = { i * 0.5, -i, "" };
+		snprintf(point.label, sizeof(point.label), "p%d", i);
+		snprintf(key, sizeof(key), "point%d", i);
+		assert(PointTable_set(&table, key, point));
+	}
+
+	assert(PointTable_snapshot_write(&table, SNAPSHOT_PATH));
+	PointTable_free(&table);
+
+	PointTableSnapshot snapshot;
+	assert(PointTableSnapshot_open(&snapshot, SNAPSHOT_PATH, NULL));
+
+	for (int i = 0; i < 500; ++i)
+	{
+		snprintf(key, sizeof(key), "point%d", i);
+
+		const Point *point = PointTableSnapshot_get_ptr(&snapshot, key);
+		assert(point != NULL);
+		assert(point->x == i * 0.5 && point->y == -i);
+
+		sprintf(key, "p%d", i);
+		assert(!strcmp(point->label, key));
+	}
+
+	PointTableSnapshot_close(&snapshot);
+
+	// the value size is recorded, so another TYPE can't open the file
+	IntTableSnapshot int_snapshot;
+	assert(!IntTableSnapshot_open(&int_snapshot, SNAPSHOT_PATH, NULL));
+
+	remove(SNAPSHOT_PATH);
+}
+
+void test_invalid()
+{
+	puts("\tTesting invalid snapshots");
+
+	IntTableSnapshot snapshot;
+	assert(!IntTableSnapshot_open(&snapshot, "does-not-exist.bin", NULL));
+
+	write_file(SNAPSHOT_PATH, "HZTB", 4);
+	assert(!IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, NULL));
+
+	IntTable table;
+	assert(IntTable_init(&table));
+	assert(IntTable_set(&table, "abc", 1));
+	assert(IntTable_snapshot_write(&table, SNAPSHOT_PATH));
+
+	// opened with a hash function other than the one it was written with
+	assert(!IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, other_hash));
+
+	// written with a custom hash function and opened with the same one
+	table.hash_function = other_hash;
+	assert(IntTable_snapshot_write(&table, SNAPSHOT_PATH));
+	assert(!IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, NULL));
+	assert(IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, other_hash));
+	assert(*IntTableSnapshot_get_ptr(&snapshot, "abc") == 1);
+
+	// truncating the file drops part of the slots
+	char buffer[1024];
+	assert(snapshot.file.size <= sizeof(buffer));
+	size_t size = snapshot.file.size;
+	memcpy(buffer, snapshot.file.data, size);
+	IntTableSnapshot_close(&snapshot);
+
+	write_file(SNAPSHOT_PATH, buffer, sizeof(HirzelTableSnapshotHeader) + 8);
+	assert(!IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, other_hash));
+
+	// a corrupt snapshot with every slot occupied still ends a missed lookup
+	IntTableSnapshotSlot *slots = (IntTableSnapshotSlot *)(buffer + sizeof(HirzelTableSnapshotHeader));
+	size_t capacity = ((HirzelTableSnapshotHeader *)buffer)->capacity;
+
+	for (size_t i = 0; i < capacity; ++i)
+	{
+		if (!slots[i].key_offset)
+			slots[i] = (IntTableSnapshotSlot) { 0, sizeof(HirzelTableSnapshotHeader), 1, 0 };
+	}
+
+	write_file(SNAPSHOT_PATH, buffer, size);
+	assert(IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, other_hash));
+	assert(*IntTableSnapshot_get_ptr(&snapshot, "abc") == 1);
+	assert(IntTableSnapshot_get_ptr(&snapshot, "missing") == NULL);
+	IntTableSnapshot_close(&snapshot);
+
+	buffer[0] = 'X';
+	write_file(SNAPSHOT_PATH, buffer, size);
+	assert(!IntTableSnapshot_open(&snapshot, SNAPSHOT_PATH, other_hash));
+
+	IntTable_free(&table);
+	remove(SNAPSHOT_PATH);
+}
+
+int main(void)
+{
+	puts("Testing Table Snapshot...");
+	test_write_open();
+	test_empty();
+	test_struct_values();
+	test_invalid();
+
+	puts("All tests passed");
+
+	return 0;
+}